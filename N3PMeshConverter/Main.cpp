@@ -1,20 +1,84 @@
 /*
 N3PMeshConvert -export obj 1_6011_00_0.n3pmesh item_co_bow.bmp
 N3PMeshConvert -import 1_6011_00_0.obj
+N3PMeshConvert -import 1_6011_00_0.obj n3cskins [1,0.5,0.25,0.1]
+N3PMeshConvert -import 1_6011_00_0.obj n3pmesh [1.5:1,8:0.45,20:0.15,45:0] [optimize[=24]] [cache]
+N3PMeshConvert -exportlods obj 1_6011_00_0.n3pmesh item_co_bow.bmp [split]
+N3PMeshConvert -batch obj Items [threads]
+N3PMeshConvert -batch obj manifest.txt [threads]
+N3PMeshConvert -info Items
+N3PMeshConvert -pack Items [quantize]
+N3PMeshConvert -unpack 1_6011_00_0.n3pz 1_6011_00_0.n3pmesh
+N3PMeshConvert -benchpack Items [iterations]
 */
 
+#include <assert.h>
+#include <float.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define N3VERSION 0.1
 
+// NOTE: joints a skinned vertex can follow, and the rate the client samples
+// joint keys at
+#define N3_MAX_AFFECT     4
+#define N3_FRAMES_PER_SEC 30.0f
+
+// NOTE: Element is 16 bits, so no part may hold more vertices than this
+#define N3_MAX_VERTICES   0xFFFF
+
+// NOTE: the client's character LOD slots and the share of the mesh's
+// vertices each keeps unless told otherwise
+#define MAX_CHR_LOD 4
+static const float N3SkinLODRatios[MAX_CHR_LOD] = {1.0f, 0.5f, 0.25f, 0.1f};
+
+// NOTE: the distances the LODs of an n3pmesh switch at and the share of
+// the vertices each keeps, -import can be given its own
+#define MAX_MESH_LOD 4
+static const float N3LODDistances[MAX_MESH_LOD] = {1.5f, 8.0f, 20.0f, 45.0f};
+static const float N3LODRatios[MAX_MESH_LOD]    = {1.0f, 0.45f, 0.15f, 0.0f};
+
+// NOTE: where -import keeps the scenes it has already imported, bump the
+// version whenever ParseScene changes what it asks Assimp for
+#define N3_CACHE_DIR     "N3Cache"
+#define N3_CACHE_VERSION 1
+
+#include "assimp/config.h"
 #include "assimp/scene.h"
 #include "assimp/Exporter.hpp"
 #include "assimp/Importer.hpp"
+#include "assimp/IOSystem.hpp"
 #include "assimp/postprocess.h"
 
+#include "zlib.h"
+#include "Hash.h"
+
 //-----------------------------------------------------------------------------
 typedef struct {
 	float x, y, z, w;
@@ -62,6 +126,17 @@ public:
 	}
 };
 
+// NOTE: CN3Skin::Load reads this record straight into its own struct, so it
+// is written the way the 32-bit client lays it out; the two pointers are
+// just placeholders the client fills in after loading
+struct __VertexSkinnedFile {
+	Vec3     vOrigin;
+	int      nAffect;
+	uint32_t pnJoints;
+	uint32_t pfWeights;
+};
+static_assert(sizeof(__VertexSkinnedFile) == 24, "__VertexSkinned is 24 bytes on disk");
+
 typedef unsigned short Element;
 
 struct _N3EdgeCollapse {
@@ -79,23 +154,291 @@ struct _N3LODCtrlValue {
 };
 
 //-----------------------------------------------------------------------------
-aiScene  m_Scene;
-Element* m_pIndices;
-Vertex*  m_pVertices;
-size_t   m_iMaxNumIndices;
-size_t   m_iMaxNumVertices;
+// NOTE: a read-only view of a whole file, memory mapped so the arrays in it
+// can be used in place
+struct N3FileMap {
+	const unsigned char* m_pData;
+	size_t m_iSize;
+#ifdef _WIN32
+	HANDLE m_hFile;
+	HANDLE m_hMapping;
+#else
+	int m_iFD;
+#endif
+};
+
+bool N3MapFile(N3FileMap* pMap, const char* szFN);
+void N3UnmapFile(N3FileMap* pMap);
+
+// NOTE: a bounds-checked array living inside a N3FileMap. The records are
+// packed in the file so the bytes may not be aligned for T, elements are
+// only ever copied out of them
+template<typename T>
+struct N3View {
+	const unsigned char* m_pBytes;
+	size_t               m_iCount;
+
+	bool Read(size_t i, T* pOut) const {
+		if(i >= m_iCount) return false;
+
+		memcpy(pOut, m_pBytes+i*sizeof(T), sizeof(T));
+		return true;
+	}
+
+	bool Copy(size_t iFirst, size_t iCount, T* pOut) const {
+		if(iFirst>m_iCount || iCount>m_iCount-iFirst) return false;
+
+		if(iCount > 0) memcpy(pOut, m_pBytes+iFirst*sizeof(T), iCount*sizeof(T));
+		return true;
+	}
+
+	size_t Size(void) const {
+		return m_iCount*sizeof(T);
+	}
+};
+
+template<typename T>
+static N3View<T> N3MakeView(const T* pData, size_t iCount) {
+	N3View<T> view = {(const unsigned char*) pData, pData ? iCount : 0};
+	return view;
+}
+
+template<typename T>
+static N3View<T> N3MakeView(const std::vector<T>& data) {
+	return N3MakeView(data.empty() ? NULL : &data[0], data.size());
+}
+
+struct N3PMeshView {
+	N3View<char> m_Name;
+
+	int m_iNumCollapses;
+	int m_iTotalIndexChanges;
+	int m_iMaxNumVertices;
+	int m_iMaxNumIndices;
+	int m_iMinNumVertices;
+	int m_iMinNumIndices;
+	int m_iLODCtrlValueCount;
+
+	N3View<Vertex>          m_Vertices;
+	N3View<Element>         m_Indices;
+	N3View<_N3EdgeCollapse> m_Collapses;
+	N3View<int>             m_IndexChanges;
+	N3View<_N3LODCtrlValue> m_LODCtrlValues;
+};
+
+//-----------------------------------------------------------------------------
+// NOTE: one level of detail pulled out of a progressive mesh, holding only
+// the vertices its triangles use
+struct N3LODLevel {
+	float fDist;
+	std::vector<Vertex>  vertices;
+	std::vector<Element> indices;
+};
+
+// NOTE: a file's worth of bytes built up in memory so it can be written out
+// with a single fwrite
+struct N3WriteBuffer {
+	std::vector<unsigned char> m_Data;
+
+	void Write(const void* pData, size_t iSize) {
+		const unsigned char* pBytes = (const unsigned char*) pData;
+		m_Data.insert(m_Data.end(), pBytes, pBytes+iSize);
+	}
+
+	template<typename T>
+	void WriteArray(const T* pData, size_t iCount) {
+		Write((const void*) pData, iCount*sizeof(T));
+	}
+
+	void WriteInt(int iValue) {
+		Write(&iValue, sizeof(int));
+	}
+};
+
+//-----------------------------------------------------------------------------
+// NOTE: one CN3Joint, kept in the order the client builds its joint list
+// (parent first, then each child's subtree) so a bone's index in here is the
+// index the skin refers to
+struct N3Joint {
+	std::string  szName;
+	int          iParent;
+	int          iNumChildren;
+	Vec3         vPos;
+	__Quaternion qRot;
+	Vec3         vScale;
+	aiMatrix4x4  mOffset; // bind pose, mesh space -> joint space
+
+	std::vector<Vec3>         KeyPos;
+	std::vector<__Quaternion> KeyRot;
+	std::vector<Vec3>         KeyScale;
+};
+
+// NOTE: a span of the shared joint key timeline
+struct N3AnimClip {
+	std::string szName;
+	float fFrmStart;
+	float fFrmEnd;
+};
+
+// NOTE: one N3PMesh/N3CSkins worth of an imported scene. Every submesh
+// sharing a material goes into the same part for as long as the part stays
+// within N3_MAX_VERTICES, the skin is packed like N3MeshContext's
+struct N3MeshPart {
+	unsigned int iMaterial;
+
+	std::vector<Vertex>  vertices;
+	std::vector<Element> indices;
+
+	std::vector<int>   skinFirst;
+	std::vector<int>   skinJoints;
+	std::vector<float> skinWeights;
+};
+
+//-----------------------------------------------------------------------------
+// NOTE: everything one conversion needs, so that several conversions can run
+// side by side in -batch mode
+struct N3MeshContext {
+	aiScene  m_Scene;
+	Element* m_pIndices;
+	Vertex*  m_pVertices;
+	size_t   m_iMaxNumIndices;
+	size_t   m_iMaxNumVertices;
+	bool     m_bQuiet;
+
+	std::vector<_N3EdgeCollapse> m_Collapses;
+	std::vector<int>             m_IndexChanges;
+	std::vector<_N3LODCtrlValue> m_LODCtrlValues;
+	std::vector<N3LODLevel>      m_LODLevels;
+
+	// NOTE: skin weights packed per vertex, vertex i uses the entries from
+	// m_SkinFirst[i] up to m_SkinFirst[i+1]
+	std::vector<int>        m_SkinFirst;
+	std::vector<int>        m_SkinJoints;
+	std::vector<float>      m_SkinWeights;
+	std::vector<N3Joint>    m_Joints;
+	std::vector<N3AnimClip> m_AnimClips;
+	float                   m_SkinLODRatios[MAX_CHR_LOD];
+
+	// NOTE: the LODCtrls N3GenerateLOD writes, m_iNumLODs of them
+	int                     m_iNumLODs;
+	float                   m_LODDistances[MAX_MESH_LOD];
+	float                   m_LODRatios[MAX_MESH_LOD];
+
+	std::vector<N3MeshPart> m_Parts;
+
+	// NOTE: post-transform cache size the import optimizes for, 0 leaves
+	// the triangles in source order. m_fACMR is the full detail mesh's
+	// average cache miss ratio once N3GenerateLOD has laid it out
+	int                     m_iCacheSize;
+	float                   m_fACMR;
+
+	// NOTE: -import reuses the scene cached in N3_CACHE_DIR for an
+	// unchanged source when asked to. Only the source itself is part of the
+	// key, so edited side files (.mtl, .md5anim, ...) are not noticed
+	bool                    m_bUseCache;
+
+	// NOTE: a mesh read by N3LoadMesh stays mapped, its vertices, collapses
+	// and LODCtrls are used from m_View in place. Only the indices are
+	// copied into m_pIndices, the collapse replay rewrites them
+	N3FileMap               m_Map;
+	N3PMeshView             m_View;
+
+	N3MeshContext(void) {
+		m_pIndices = NULL;
+		m_pVertices = NULL;
+		m_iMaxNumIndices = 0;
+		m_iMaxNumVertices = 0;
+		m_bQuiet = false;
+		memcpy(m_SkinLODRatios, N3SkinLODRatios, sizeof(m_SkinLODRatios));
+		m_iNumLODs = MAX_MESH_LOD;
+		memcpy(m_LODDistances, N3LODDistances, sizeof(m_LODDistances));
+		memcpy(m_LODRatios, N3LODRatios, sizeof(m_LODRatios));
+		m_iCacheSize = 0;
+		m_fACMR = 0.0f;
+		m_bUseCache = false;
+		memset(&m_Map, 0, sizeof(m_Map));
+		memset(&m_View, 0, sizeof(m_View));
+	}
+
+	~N3MeshContext(void) {
+		delete[] m_pIndices;
+		delete[] m_pVertices;
+		N3UnmapFile(&m_Map);
+	}
+
+private:
+	N3MeshContext(const N3MeshContext&);
+	N3MeshContext& operator = (const N3MeshContext&);
+};
+
+struct N3BatchJob {
+	std::string szMesh;
+	std::string szTexture;
+	std::string szOutput;
+};
+
+//-----------------------------------------------------------------------------
+// NOTE: the working mesh's arrays wherever they live, in the mapping of a
+// loaded mesh or in the context's own arrays for an imported one
+static N3View<Vertex> N3Vertices(const N3MeshContext* pCtx) {
+	if(pCtx->m_Map.m_pData) return pCtx->m_View.m_Vertices;
+	return N3MakeView(pCtx->m_pVertices, pCtx->m_iMaxNumVertices);
+}
+
+static N3View<_N3EdgeCollapse> N3Collapses(const N3MeshContext* pCtx) {
+	if(pCtx->m_Map.m_pData) return pCtx->m_View.m_Collapses;
+	return N3MakeView(pCtx->m_Collapses);
+}
+
+static N3View<int> N3IndexChanges(const N3MeshContext* pCtx) {
+	if(pCtx->m_Map.m_pData) return pCtx->m_View.m_IndexChanges;
+	return N3MakeView(pCtx->m_IndexChanges);
+}
+
+static N3View<_N3LODCtrlValue> N3LODCtrlValues(const N3MeshContext* pCtx) {
+	if(pCtx->m_Map.m_pData) return pCtx->m_View.m_LODCtrlValues;
+	return N3MakeView(pCtx->m_LODCtrlValues);
+}
 
 //-----------------------------------------------------------------------------
-void ParseScene(const char* szFN);
-void N3LoadMesh(const char* szFN);
-void N3BuildMesh(const char* szFN);
-void N3BuildSkin(const char* szFN);
-void GenerateScene(const char* szFN);
+bool ParseScene(N3MeshContext* pCtx, const char* szFN);
+bool N3ParseMesh(const N3FileMap* pMap, N3PMeshView* pView);
+bool N3LoadMesh(N3MeshContext* pCtx, const char* szFN);
+bool N3GenerateLOD(N3MeshContext* pCtx);
+bool N3BuildMesh(N3MeshContext* pCtx, const char* szFN);
+bool N3ParseSkeleton(N3MeshContext* pCtx, const aiScene* pScene);
+bool N3SelectPart(N3MeshContext* pCtx, size_t iPart);
+bool N3ParseRatios(const char* szList, float* pRatios, int iCount);
+int  N3ParseLODs(const char* szList, float* pDistances, float* pRatios, int iMaxCount);
+bool N3ParseOptimize(const char* szArg, int* pCacheSize);
+bool N3BuildSkin(N3MeshContext* pCtx, const char* szFN);
+bool N3BuildSkeleton(N3MeshContext* pCtx, const char* szFN);
+bool N3ExtractLODs(N3MeshContext* pCtx);
+bool GenerateScene(N3MeshContext* pCtx, const char* szFN);
+bool GenerateLODScene(N3MeshContext* pCtx, aiScene* pScene, const char* szFN, int iLevel);
+const aiExportFormatDesc* FindExportFormat(Assimp::Exporter* pExporter, const char* pFormatID);
+bool N3CollectBatchJobs(const char* szPath, const char* szExt, std::vector<N3BatchJob>& jobs);
+int  N3RunBatch(const char* pFormatID, const char* szPath, unsigned int iNumThreads);
+int  N3PrintInfo(const char* szPath);
+int  N3PackMeshes(const char* szPath, bool bQuantize);
+bool N3UnpackMesh(const char* szFN, const char* szOut);
+int  N3BenchPack(const char* szPath, int iIterations);
+
+static std::string N3StripExtension(const std::string& szFN);
 
 //-----------------------------------------------------------------------------
 int main(int argc, char* argv[]) {
 
+	if(argc < 2) {
+		printf("Incorrect command-line arguments.\n");
+		return -1;
+	}
+
 	Assimp::Exporter* pExporter = new Assimp::Exporter();
+	N3MeshContext* pCtx = new N3MeshContext();
+
+	bool bPause = true;
+	int iRet = 0;
 
 	if(!strcmp(argv[1], "-version") && argc==2) {
 		printf("\nDB: Version %.2f\n", N3VERSION);
@@ -123,45 +466,129 @@ int main(int argc, char* argv[]) {
 		while(c!='.' && c!='\0') c = pFileName[offset++];
 		memcpy(pFileBase, pFileName, (offset-1)*sizeof(char));
 
-		size_t iNumFormats = pExporter->GetExportFormatCount();
-
-		int found = 0;
-		for(unsigned int i=0; i<iNumFormats; ++i) {
-			const aiExportFormatDesc* pFormatDesc;
-			pFormatDesc = pExporter->GetExportFormatDescription(i);
-
-			if(!strcmp(pFormatID, pFormatDesc->id)) {
-				found = 1;
-				sprintf(pOutputFile, "./%s.%s",
-					pFileBase,
-					pFormatDesc->fileExtension
-				);
-			}
-		}
+		const aiExportFormatDesc* pFormatDesc = FindExportFormat(pExporter, pFormatID);
 
-		if(!found) {
+		if(pFormatDesc == NULL) {
 			printf("\nER: That format is not supported! Check the following list\n");
 			system("N3PMeshConvert -formats\n");
 			system("pause");
 			exit(-1);
 		}
 
+		sprintf(pOutputFile, "./%s.%s",
+			pFileBase,
+			pFormatDesc->fileExtension
+		);
+
 		printf("\nDB: Loading \"%s\"...\n", pFileName);
-		N3LoadMesh(pFileName);
+		if(!N3LoadMesh(pCtx, pFileName)) {
+			system("pause");
+			exit(-1);
+		}
 		printf("\nDB: Generating scene... ");
-		GenerateScene(pTextName);
+		if(!GenerateScene(pCtx, pTextName)) {
+			system("pause");
+			exit(-1);
+		}
 		printf("\nDB: Exporting to %s... ", pFormatID);
 
-		aiReturn ret = pExporter->Export(&m_Scene, pFormatID, pOutputFile);
+		aiReturn ret = pExporter->Export(&pCtx->m_Scene, pFormatID, pOutputFile);
 		if(ret == aiReturn_SUCCESS) {
 			printf("Done!\n");
 		} else {
 			printf("Failed!\n");
 		}
-	} else if(!strcmp(argv[1], "-import") && argc==4) {
+	} else if(!strcmp(argv[1], "-exportlods") && (argc==5 || argc==6)) {
+		const char* pFormatID = argv[2];
+		const char* pFileName = argv[3];
+		const char* pTextName = argv[4];
+		bool bSplit = (argc==6 && !strcmp(argv[5], "split"));
+
+		char pFileBase[MAXLEN] = {};
+		char pOutputFile[MAXLEN] = {};
+
+		char c = ' '; int offset = 0;
+		while(c!='.' && c!='\0') c = pFileName[offset++];
+		memcpy(pFileBase, pFileName, (offset-1)*sizeof(char));
+
+		const aiExportFormatDesc* pFormatDesc = FindExportFormat(pExporter, pFormatID);
+
+		if(pFormatDesc == NULL) {
+			printf("\nER: That format is not supported! Check the following list\n");
+			system("N3PMeshConvert -formats\n");
+			system("pause");
+			exit(-1);
+		}
+
+		printf("\nDB: Loading \"%s\"...\n", pFileName);
+		if(!N3LoadMesh(pCtx, pFileName) || !N3ExtractLODs(pCtx)) {
+			system("pause");
+			exit(-1);
+		}
+
+		for(size_t i=0; i<pCtx->m_LODLevels.size(); ++i) {
+			const N3LODLevel& level = pCtx->m_LODLevels[i];
+			printf("DB: LOD%u -> %u vertices, %u triangles (%.2f)\n",
+				(unsigned int) i,
+				(unsigned int) level.vertices.size(),
+				(unsigned int) level.indices.size()/3,
+				level.fDist
+			);
+		}
+
+		// NOTE: either every level in one scene or one file per level
+		int iNumFiles = bSplit ? (int) pCtx->m_LODLevels.size() : 1;
+
+		for(int i=0; i<iNumFiles; ++i) {
+			if(bSplit) {
+				sprintf(pOutputFile, "./%s_lod%d.%s", pFileBase, i, pFormatDesc->fileExtension);
+			} else {
+				sprintf(pOutputFile, "./%s.%s", pFileBase, pFormatDesc->fileExtension);
+			}
+
+			aiScene scene;
+			printf("\nDB: Generating scene... ");
+			if(!GenerateLODScene(pCtx, &scene, pTextName, bSplit ? i : -1)) {
+				system("pause");
+				exit(-1);
+			}
+			printf("\nDB: Exporting to %s... ", pOutputFile);
+
+			aiReturn ret = pExporter->Export(&scene, pFormatID, pOutputFile);
+			if(ret == aiReturn_SUCCESS) {
+				printf("Done!\n");
+			} else {
+				printf("Failed!\n");
+			}
+		}
+	} else if(!strcmp(argv[1], "-import") && argc>=4 && argc<=7) {
 		const char* pFileName = argv[2];
 		const char* pMeshType = argv[3];
-		
+
+		// NOTE: the ratios (n3cskins) or LODs (n3pmesh), optimize and cache
+		// can come in any order
+		bool bRatios = false;
+		for(int i=4; i<argc; ++i) {
+			if(!strcmp(argv[i], "cache") && !pCtx->m_bUseCache) {
+				pCtx->m_bUseCache = true;
+			} else if(!strncmp(argv[i], "optimize", 8)) {
+				if(pCtx->m_iCacheSize>0 || !N3ParseOptimize(argv[i], &pCtx->m_iCacheSize)) {
+					printf("\nER: Expected optimize or optimize=<cache size>!\n");
+					system("pause");
+					exit(-1);
+				}
+			} else if(!bRatios && !strcmp(pMeshType, "n3cskins") && N3ParseRatios(argv[i], pCtx->m_SkinLODRatios, MAX_CHR_LOD)) {
+				bRatios = true;
+			} else if(!bRatios && !strcmp(pMeshType, "n3pmesh") && (pCtx->m_iNumLODs = N3ParseLODs(argv[i], pCtx->m_LODDistances, pCtx->m_LODRatios, MAX_MESH_LOD)) > 0) {
+				bRatios = true;
+			} else {
+				if(!strcmp(pMeshType, "n3pmesh")) printf("\nER: Expected LODs like 1.5:1,8:0.45,20:0.15,45:0 after n3pmesh!\n");
+				else printf("\nER: Expected LOD ratios like 1,0.5,0.25,0.1 after n3cskins!\n");
+				system("pause");
+				exit(-1);
+			}
+		}
+
 		char pFileBase[MAXLEN] = {};
 		char pOutputFile[MAXLEN] = {};
 
@@ -170,543 +597,3244 @@ int main(int argc, char* argv[]) {
 		memcpy(pFileBase, pFileName, (offset-1)*sizeof(char));
 
 		printf("\nDB: Loading \"%s\"... ", pFileName);
-		ParseScene(pFileName);
+		if(!ParseScene(pCtx, pFileName)) {
+			system("pause");
+			exit(-1);
+		}
 
-		if(!strcmp(pMeshType, "n3pmesh")) {
-			sprintf(pOutputFile, "./%s_mod.%s", pFileBase, "n3pmesh");
-			printf("\nDB: Generating N3PMesh...\n");
-			N3BuildMesh(pOutputFile);
-		} else if(!strcmp(pMeshType, "n3cskins")) {
+		// NOTE: a scene with several parts writes one file per part,
+		// numbered in the order the parts were found
+		bool bBuilt = true;
+		size_t iNumParts = pCtx->m_Parts.size();
+
+		for(size_t p=0; p<iNumParts && bBuilt; ++p) {
+			char pPartBase[MAXLEN] = {};
+			if(iNumParts > 1) sprintf(pPartBase, "%s_mod_%u", pFileBase, (unsigned int) p);
+			else sprintf(pPartBase, "%s_mod", pFileBase);
+
+			if(!N3SelectPart(pCtx, p)) {
+				printf("\nER: Part %u is empty!\n", (unsigned int) p);
+				bBuilt = false;
+			} else if(!strcmp(pMeshType, "n3pmesh")) {
+				sprintf(pOutputFile, "./%s.%s", pPartBase, "n3pmesh");
+				printf("\nDB: Generating LODs... ");
+				if(N3GenerateLOD(pCtx)) {
+					printf("Success!\n");
+					if(pCtx->m_iCacheSize > 0) {
+						printf("DB: ACMR %.3f (cache %d)\n", pCtx->m_fACMR, pCtx->m_iCacheSize);
+					}
+				} else {
+					// NOTE: the mesh is left as imported, a static mesh still
+					// beats no mesh at all
+					printf("Failed!\nDB: Writing the mesh without LODs\n");
+					pCtx->m_Collapses.clear();
+					pCtx->m_IndexChanges.clear();
+					pCtx->m_LODCtrlValues.clear();
+				}
+				printf("\nDB: Generating N3PMesh...\n");
+				bBuilt = N3BuildMesh(pCtx, pOutputFile);
+			} else if(!strcmp(pMeshType, "n3cskins")) {
+				sprintf(pOutputFile, "./%s.%s", pPartBase, "n3cskins");
+				printf("\nDB: Generating N3CSkins...\n");
+				bBuilt = N3BuildSkin(pCtx, pOutputFile);
+			}
+		}
+
+		// NOTE: the parts of a character share one skeleton
+		if(bBuilt && !strcmp(pMeshType, "n3cskins")) {
 			sprintf(pOutputFile, "./%s_mod.%s", pFileBase, "n3cskins");
-			printf("\nDB: Generating N3CSkins...\n");
-			N3BuildSkin(pOutputFile);
+			bBuilt = N3BuildSkeleton(pCtx, pOutputFile);
+		}
+
+		if(!bBuilt) {
+			system("pause");
+			exit(-1);
 		}
+	} else if(!strcmp(argv[1], "-batch") && (argc==4 || argc==5)) {
+		const char* pFormatID = argv[2];
+		const char* pPath = argv[3];
+
+		unsigned int iNumThreads = 0;
+		if(argc == 5) iNumThreads = (unsigned int) atoi(argv[4]);
+
+		// NOTE: batch runs are meant to be scripted so never wait on a key
+		bPause = false;
+		iRet = N3RunBatch(pFormatID, pPath, iNumThreads);
+	} else if(!strcmp(argv[1], "-info") && argc==3) {
+		bPause = false;
+		iRet = N3PrintInfo(argv[2]);
+	} else if(!strcmp(argv[1], "-pack") && (argc==3 || (argc==4 && !strcmp(argv[3], "quantize")))) {
+		bPause = false;
+		iRet = N3PackMeshes(argv[2], argc==4);
+	} else if(!strcmp(argv[1], "-unpack") && argc==4) {
+		bPause = false;
+		iRet = N3UnpackMesh(argv[2], argv[3]) ? 0 : -1;
+	} else if(!strcmp(argv[1], "-benchpack") && (argc==3 || argc==4)) {
+		int iIterations = 100;
+		if(argc == 4) iIterations = atoi(argv[3]);
+
+		bPause = false;
+		iRet = N3BenchPack(argv[2], iIterations>0 ? iIterations : 1);
 	} else {
 		printf("Incorrect command-line arguments.\n");
 	}
 
+	delete pCtx;
+	pCtx = NULL;
+
 	delete pExporter;
 	pExporter = NULL;
 
-	system("pause");
+	if(bPause) system("pause");
 
-	return 0;
+	return iRet;
 }
 
 //-----------------------------------------------------------------------------
-void ParseScene(const char* szFN) {
-	Assimp::Importer Importer;
-
-	const aiScene* pScene = Importer.ReadFile(
-		szFN,
-		aiProcess_Triangulate      |
-		aiProcess_GenSmoothNormals |
-		aiProcess_FlipUVs
-	);
-
-	if(pScene == NULL) {
-		printf("\nER: %s\n", Importer.GetErrorString());
-		system("pause");
-		exit(-1);
-	}
+// NOTE: skinned meshes stay in their bind space (the bones are defined
+// against it), anything else is moved by its node so the submeshes line up
+static void N3AppendMesh(N3MeshContext* pCtx, const aiMesh* pMesh, const aiMatrix4x4& mGlobal) {
+	if(pMesh->mNumVertices==0 || pMesh->mNumFaces==0) return;
 
-	aiMesh* pMesh = pScene->mMeshes[0];
+	std::vector<N3MeshPart>& parts = pCtx->m_Parts;
 
-	m_iMaxNumVertices = pMesh->mNumVertices;
-	m_iMaxNumIndices  = 3*pMesh->mNumFaces;
+	N3MeshPart* pPart = NULL;
+	for(size_t p=parts.size(); p>0; --p) {
+		if(parts[p-1].iMaterial != pMesh->mMaterialIndex) continue;
 
-	if(m_iMaxNumVertices==0 || m_iMaxNumIndices==0) {
-		printf("Failed!\n");
-		printf("\nER: Mesh data missing!\n");
-		system("pause");
-		exit(-1);
+		if(parts[p-1].vertices.size()+pMesh->mNumVertices <= N3_MAX_VERTICES) pPart = &parts[p-1];
+		break;
 	}
 
-	if(m_pVertices) {
-		delete m_pVertices;
-		m_pVertices = NULL;
+	if(pPart == NULL) {
+		parts.push_back(N3MeshPart());
+		pPart = &parts.back();
+		pPart->iMaterial = pMesh->mMaterialIndex;
+		pPart->skinFirst.assign(1, 0);
 	}
 
-	m_pVertices = new Vertex[m_iMaxNumVertices];
-	memset(m_pVertices, 0, sizeof(Vertex)*m_iMaxNumVertices);
-
-	if(m_pIndices) {
-		delete m_pIndices;
-		m_pIndices = NULL;
-	}
+	bool bMoved = !pMesh->HasBones() && !mGlobal.IsIdentity();
+	aiMatrix3x3 mNormal = aiMatrix3x3(mGlobal).Inverse().Transpose();
 
-	m_pIndices = new Element[m_iMaxNumIndices];
-	memset(m_pIndices, 0, sizeof(Element)*m_iMaxNumIndices);
+	size_t iBase = pPart->vertices.size();
 
 	for(unsigned int i=0; i<pMesh->mNumVertices; ++i) {
-		m_pVertices[i].x = pMesh->mVertices[i].x;
-		m_pVertices[i].y = pMesh->mVertices[i].y;
-		m_pVertices[i].z = pMesh->mVertices[i].z;
+		aiVector3D vPos = pMesh->mVertices[i];
+		aiVector3D vNormal = pMesh->HasNormals() ? pMesh->mNormals[i] : aiVector3D();
 
-		m_pVertices[i].nx = pMesh->mNormals[i].x;
-		m_pVertices[i].ny = pMesh->mNormals[i].y;
-		m_pVertices[i].nz = pMesh->mNormals[i].z;
+		if(bMoved) {
+			vPos = mGlobal*vPos;
+			vNormal = mNormal*vNormal;
+			if(vNormal.SquareLength() > 0.0f) vNormal.Normalize();
+		}
 
-		m_pVertices[i].u = pMesh->mTextureCoords[0][i].x;
-		m_pVertices[i].v = pMesh->mTextureCoords[0][i].y;
-	}
+		Vertex v = {};
+		v.x = vPos.x;
+		v.y = vPos.y;
+		v.z = vPos.z;
 
-	for(unsigned int i=0; i<pMesh->mNumFaces; ++i) {
-		aiFace& face = pMesh->mFaces[i];
+		v.nx = vNormal.x;
+		v.ny = vNormal.y;
+		v.nz = vNormal.z;
+
+		if(pMesh->HasTextureCoords(0)) {
+			v.u = pMesh->mTextureCoords[0][i].x;
+			v.v = pMesh->mTextureCoords[0][i].y;
+		}
 
-		m_pIndices[3*i+0] = (Element) face.mIndices[0];
-		m_pIndices[3*i+1] = (Element) face.mIndices[1];
-		m_pIndices[3*i+2] = (Element) face.mIndices[2];
+		pPart->vertices.push_back(v);
 	}
 
-	printf("Success!\n");
+	// NOTE: Triangulate leaves points and lines alone, N3 has no use for them
+	for(unsigned int i=0; i<pMesh->mNumFaces; ++i) {
+		const aiFace& face = pMesh->mFaces[i];
+		if(face.mNumIndices != 3) continue;
 
-	fflush(stdout);
-}
+		pPart->indices.push_back((Element) (iBase+face.mIndices[0]));
+		pPart->indices.push_back((Element) (iBase+face.mIndices[1]));
+		pPart->indices.push_back((Element) (iBase+face.mIndices[2]));
+	}
 
-//-----------------------------------------------------------------------------
-void N3LoadMesh(const char* szFN) {
-	FILE* fpMesh = fopen(szFN, "rb");
-	if(fpMesh == NULL) {
-		fprintf(stderr, "\nERROR: Missing mesh %s\n", szFN);
-		system("pause");
-		exit(-1);
+	// NOTE: weights are renormalized since LimitBoneWeights may have
+	// dropped some
+	std::map<std::string, int> joints;
+	for(size_t j=0; j<pCtx->m_Joints.size(); ++j) {
+		joints[pCtx->m_Joints[j].szName] = (int) j;
 	}
-	/*
-	*/
 
-	// NOTE: length of the name for the mesh
-	int nL0 = 0;
-	fread(&nL0, sizeof(int), 1, fpMesh);
+	std::vector< std::vector< std::pair<int, float> > > weights(pMesh->mNumVertices);
+	for(unsigned int b=0; b<pMesh->mNumBones; ++b) {
+		const aiBone* pBone = pMesh->mBones[b];
 
-	// NOTE: if the shape has a mesh name read it in
-	char m_szName0[0xFF] = {};
+		std::map<std::string, int>::const_iterator it = joints.find(pBone->mName.C_Str());
+		if(it == joints.end()) continue;
 
-	if(nL0 > 0) {
-		memset(&m_szName0, 0, (nL0+1));
-		fread(&m_szName0, sizeof(char), nL0, fpMesh);
+		for(unsigned int w=0; w<pBone->mNumWeights; ++w) {
+			const aiVertexWeight& weight = pBone->mWeights[w];
+			if(weight.mVertexId<pMesh->mNumVertices && weight.mWeight>0.0f) {
+				weights[weight.mVertexId].push_back(std::make_pair(it->second, weight.mWeight));
+			}
+		}
 	}
 
-	// NOTE: read in the number of "collapses"
-	int m_iNumCollapses0;
-	fread(&m_iNumCollapses0, sizeof(int), 1, fpMesh);
+	for(unsigned int i=0; i<pMesh->mNumVertices; ++i) {
+		float fSum = 0.0f;
+		for(size_t w=0; w<weights[i].size(); ++w) fSum += weights[i][w].second;
 
-	// NOTE: read in the total index changes
-	int m_iTotalIndexChanges0;
-	fread(&m_iTotalIndexChanges0, sizeof(int), 1, fpMesh);
+		for(size_t w=0; w<weights[i].size(); ++w) {
+			pPart->skinJoints.push_back(weights[i][w].first);
+			pPart->skinWeights.push_back(weights[i][w].second/fSum);
+		}
+		pPart->skinFirst.push_back((int) pPart->skinJoints.size());
+	}
+}
 
-	// NOTE: read in the max num of vertices
-	fread(&m_iMaxNumVertices, sizeof(int), 1, fpMesh);
+static void N3CollectParts(N3MeshContext* pCtx, const aiScene* pScene, const aiNode* pNode, const aiMatrix4x4& mParent, std::vector<bool>& added) {
+	aiMatrix4x4 mGlobal = mParent * pNode->mTransformation;
 
-	// NOTE: read in the max num of indices
-	fread(&m_iMaxNumIndices, sizeof(int), 1, fpMesh);
+	for(unsigned int i=0; i<pNode->mNumMeshes; ++i) {
+		unsigned int m = pNode->mMeshes[i];
+		if(m >= pScene->mNumMeshes) continue;
 
-	// NOTE: read in the min num of vertices
-	int m_iMinNumVertices0;
-	fread(&m_iMinNumVertices0, sizeof(int), 1, fpMesh);
+		// NOTE: an instanced mesh is copied for every node using it, unless
+		// it is skinned and so does not depend on the node at all
+		const aiMesh* pMesh = pScene->mMeshes[m];
+		if(pMesh->HasBones() && added[m]) continue;
+		added[m] = true;
 
-	// NOTE: read in the min num of indices
-	int m_iMinNumIndices0;
-	fread(&m_iMinNumIndices0, sizeof(int), 1, fpMesh);
+		N3AppendMesh(pCtx, pMesh, mGlobal);
+	}
 
-	// NOTE: free the previous vertex data
-	if(m_pVertices) {
-		delete m_pVertices;
-		m_pVertices = NULL;
+	for(unsigned int i=0; i<pNode->mNumChildren; ++i) {
+		N3CollectParts(pCtx, pScene, pNode->mChildren[i], mGlobal, added);
 	}
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: a cache entry is named after a hash of the source bytes and one of
+// everything else that changes what the import makes of them, so an edited
+// source or different settings simply miss
+static bool N3CachePath(const char* szFN, unsigned int iFlags, int iCacheSize, char* szPath) {
+	N3FileMap map;
+	if(!N3MapFile(&map, szFN)) return false;
+
+	uint32_t iSize = (uint32_t) map.m_iSize;
+	uint32_t iHash = SuperFastHash((const char*) map.m_pData, iSize);
+	N3UnmapFile(&map);
+
+	uint32_t settings[6] = {
+		N3_CACHE_VERSION, iFlags, (uint32_t) iCacheSize,
+		N3_MAX_AFFECT, N3_MAX_VERTICES, iSize
+	};
+	uint32_t iKey = SuperFastHash((const char*) settings, sizeof(settings), iHash);
+
+	// NOTE: the extension picks the loader that reads the bytes
+	const char* szExt = strrchr(szFN, '.');
+	if(szExt != NULL && szExt[1] != '\0') iKey = SuperFastHash(szExt, 0, iKey);
+
+	sprintf(szPath, "%s/%08x%08x.assbin", N3_CACHE_DIR, iHash, iKey);
+
+	return true;
+}
 
-	// NOTE: if there is a max vertex amount allocate space for it
-	if(m_iMaxNumVertices > 0) {
-		m_pVertices = new Vertex[m_iMaxNumVertices];
-		memset(m_pVertices, 0, sizeof(Vertex)*m_iMaxNumVertices);
+//-----------------------------------------------------------------------------
+// NOTE: assbin does not store aiNode::mParent (older Assimp builds, like the
+// one this links against, leave it NULL), the skeleton walk needs it
+static void N3LinkParents(aiNode* pNode, aiNode* pParent) {
+	pNode->mParent = pParent;
 
-		// NOTE: read in the vertex data
-		fread(m_pVertices, sizeof(Vertex), m_iMaxNumVertices, fpMesh);
+	for(unsigned int i=0; i<pNode->mNumChildren; ++i) {
+		N3LinkParents(pNode->mChildren[i], pNode);
 	}
+}
 
-	// NOTE: free the previous index data
-	if(m_pIndices) {
-		delete m_pIndices;
-		m_pIndices = NULL;
+//-----------------------------------------------------------------------------
+// NOTE: a failed write only costs the next run its cache hit, so it is not
+// an error
+static void N3WriteCache(const aiScene* pScene, const char* szPath) {
+#ifdef _WIN32
+	CreateDirectoryA(N3_CACHE_DIR, NULL);
+#else
+	mkdir(N3_CACHE_DIR, 0755);
+#endif
+
+	// NOTE: written aside and renamed into place so an interrupted run never
+	// leaves half an entry behind for the next one to load
+	std::string szTemp = std::string(szPath) + ".tmp";
+
+	Assimp::Exporter exporter;
+	if(exporter.Export(pScene, "assbin", szTemp.c_str()) != aiReturn_SUCCESS ||
+		rename(szTemp.c_str(), szPath) != 0
+	) {
+		remove(szTemp.c_str());
+		printf("\nDB: Unable to cache the scene in \"%s\"\n", szPath);
 	}
+}
+
+//-----------------------------------------------------------------------------
+bool ParseScene(N3MeshContext* pCtx, const char* szFN) {
+	Assimp::Importer Importer;
 
-	// NOTE: if there is a max index amount allocate space for it
-	if(m_iMaxNumIndices > 0) {
-		m_pIndices = new unsigned short[m_iMaxNumIndices];
-		memset(m_pIndices, 0, sizeof(unsigned short)*m_iMaxNumIndices);
+	Importer.SetPropertyInteger(AI_CONFIG_PP_LBW_MAX_WEIGHTS, N3_MAX_AFFECT);
+	Importer.SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT, N3_MAX_VERTICES);
+	Importer.SetPropertyInteger(AI_CONFIG_PP_SLM_TRIANGLE_LIMIT, N3_MAX_VERTICES);
+
+	unsigned int iFlags =
+		aiProcess_Triangulate       |
+		aiProcess_GenSmoothNormals  |
+		aiProcess_LimitBoneWeights  |
+		aiProcess_FlipUVs;
+
+	// NOTE: opt-in since it changes the vertex count and triangle order of
+	// what gets written, the N3 side builds on whatever order comes out here
+	if(pCtx->m_iCacheSize > 0) {
+		Importer.SetPropertyInteger(AI_CONFIG_PP_ICL_PTCACHE_SIZE, pCtx->m_iCacheSize);
+		iFlags |= aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality;
+	}
 
-		// NOTE: read in the vertex data
-		fread(m_pIndices, sizeof(unsigned short), m_iMaxNumIndices, fpMesh);
+	// NOTE: the cached scene is the one below after all post-processing, so
+	// a hit skips straight to reading it
+	char szCacheFile[MAXLEN] = {};
+	bool bCache = pCtx->m_bUseCache && N3CachePath(szFN, iFlags, pCtx->m_iCacheSize, szCacheFile);
+
+	const aiScene* pScene = NULL;
+	if(bCache && Importer.GetIOHandler()->Exists(szCacheFile)) {
+		pScene = Importer.ReadFile(szCacheFile, 0);
+		if(pScene != NULL) {
+			if(pScene->mRootNode) N3LinkParents(pScene->mRootNode, NULL);
+			printf("(cached) ");
+		}
 	}
 
-	// NOTE: read in the "collapses" (I think this is used to set the vertices
-	// based on how close the player is to the object)
-	_N3EdgeCollapse* m_pCollapses = new _N3EdgeCollapse[(m_iNumCollapses0+1)];
-	memset(&m_pCollapses[m_iNumCollapses0], 0, sizeof(_N3EdgeCollapse));
+	if(pScene == NULL) {
+		pScene = Importer.ReadFile(szFN, iFlags);
+
+		if(pScene == NULL) {
+			printf("\nER: %s\n", Importer.GetErrorString());
+			return false;
+		}
 
-	if(m_iNumCollapses0 > 0) {
-		fread(m_pCollapses, sizeof(_N3EdgeCollapse), m_iNumCollapses0, fpMesh);
-		memset(&m_pCollapses[m_iNumCollapses0], 0, sizeof(_N3EdgeCollapse));
-	}
+		// NOTE: indices are narrowed to Element, so cut up anything too big
+		// for that first instead of letting them wrap around
+		bool bOverflow = false;
+		for(unsigned int m=0; m<pScene->mNumMeshes; ++m) {
+			if(pScene->mMeshes[m]->mNumVertices > N3_MAX_VERTICES) bOverflow = true;
+			if(pScene->mMeshes[m]->mNumFaces > N3_MAX_VERTICES) bOverflow = true;
+		}
 
-	// NOTE: read in the index changes
-	int* m_pAllIndexChanges = new int[m_iTotalIndexChanges0];
+		if(bOverflow) {
+			pScene = Importer.ApplyPostProcessing(aiProcess_SplitLargeMeshes);
+			if(pScene == NULL) {
+				printf("\nER: %s\n", Importer.GetErrorString());
+				return false;
+			}
+		}
+
+		if(bCache) N3WriteCache(pScene, szCacheFile);
+	}
 
-	if(m_iTotalIndexChanges0 > 0) {
-		fread(m_pAllIndexChanges, sizeof(int), m_iTotalIndexChanges0, fpMesh);
+	if(!N3ParseSkeleton(pCtx, pScene)) {
+		printf("Failed!\n");
+		printf("\nER: Unable to read the skeleton!\n");
+		return false;
 	}
 
-	// NOTE: read in m_iLODCtrlValueCount
-	int m_iLODCtrlValueCount0;
-	fread(&m_iLODCtrlValueCount0, sizeof(int), 1, fpMesh);
+	pCtx->m_Parts.clear();
 
-	// NOTE: read in the LODCtrls (current size seems to be 0)
-	_N3LODCtrlValue* m_pLODCtrlValues = new _N3LODCtrlValue[m_iLODCtrlValueCount0];
+	std::vector<bool> added(pScene->mNumMeshes, false);
+	N3CollectParts(pCtx, pScene, pScene->mRootNode, aiMatrix4x4(), added);
 
-	if(m_iLODCtrlValueCount0) {
-		fread(m_pLODCtrlValues, sizeof(_N3LODCtrlValue), m_iLODCtrlValueCount0, fpMesh);
+	if(pCtx->m_Parts.empty() || !N3SelectPart(pCtx, 0)) {
+		printf("Failed!\n");
+		printf("\nER: Mesh data missing!\n");
+		return false;
 	}
 
-	// NOTE: the actual number of indices and vertices for the specific
-	// collapse
-	if(m_pAllIndexChanges) {
-		int m_iNumIndices = 0;
-		int m_iNumVertices = 0;
+	printf("Success!\n");
 
-		int c = 0;
-		int LOD = 0;
+	if(pCtx->m_Parts.size() > 1) {
+		printf("DB: %u parts from %u meshes\n",
+			(unsigned int) pCtx->m_Parts.size(),
+			pScene->mNumMeshes
+		);
+	}
 
-		int iDiff = m_pLODCtrlValues[LOD].iNumVertices - m_iNumVertices;
+	fflush(stdout);
 
-		while(m_pLODCtrlValues[LOD].iNumVertices > m_iNumVertices) {
-			if(c >= m_iNumCollapses0) break;
-			if(m_pCollapses[c].NumVerticesToLose+m_iNumVertices > m_pLODCtrlValues[LOD].iNumVertices)
-				break;
+	return true;
+}
 
-			m_iNumIndices += m_pCollapses[c].NumIndicesToLose;
-			m_iNumVertices += m_pCollapses[c].NumVerticesToLose;
-		
-			int tmp0 = m_pCollapses[c].iIndexChanges;
-			int tmp1 = tmp0+m_pCollapses[c].NumIndicesToChange;
+//-----------------------------------------------------------------------------
+// NOTE: load a part into the context's working mesh, the LOD and file
+// builders only ever look at that
+bool N3SelectPart(N3MeshContext* pCtx, size_t iPart) {
+	if(iPart >= pCtx->m_Parts.size()) return false;
 
-			for(int i=tmp0; i<tmp1; i++) {
-				m_pIndices[m_pAllIndexChanges[i]] = m_iNumVertices-1;
-			}
+	const N3MeshPart& part = pCtx->m_Parts[iPart];
+	if(part.vertices.empty() || part.indices.empty()) return false;
 
-			c++;
-		}
+	delete[] pCtx->m_pVertices;
+	delete[] pCtx->m_pIndices;
+	N3UnmapFile(&pCtx->m_Map);
 
-		// NOTE: if we break on a collapse that isn't intended to be one we
-		// should collapse up to then keep collapsing until we find one
-		while(m_pCollapses[c].bShouldCollapse) {
-			/*
-			- not sure if this is really needed
-			*/
-			if(c >= m_iNumCollapses0) break;
+	pCtx->m_iMaxNumVertices = part.vertices.size();
+	pCtx->m_iMaxNumIndices  = part.indices.size();
 
-			m_iNumIndices += m_pCollapses[c].NumIndicesToLose;
-			m_iNumVertices += m_pCollapses[c].NumVerticesToLose;
-		
-			int tmp0 = m_pCollapses[c].iIndexChanges;
-			int tmp1 = tmp0+m_pCollapses[c].NumIndicesToChange;
+	pCtx->m_pVertices = new Vertex[pCtx->m_iMaxNumVertices];
+	memcpy(pCtx->m_pVertices, &part.vertices[0], sizeof(Vertex)*pCtx->m_iMaxNumVertices);
 
-			for(int i=tmp0; i<tmp1; i++) {
-				m_pIndices[m_pAllIndexChanges[i]] = m_iNumVertices-1;
-			}
+	pCtx->m_pIndices = new Element[pCtx->m_iMaxNumIndices];
+	memcpy(pCtx->m_pIndices, &part.indices[0], sizeof(Element)*pCtx->m_iMaxNumIndices);
 
-			c++;
-		}
+	// NOTE: a part nothing is weighted to is written as before, unskinned
+	if(part.skinJoints.empty()) {
+		pCtx->m_SkinFirst.clear();
+		pCtx->m_SkinJoints.clear();
+		pCtx->m_SkinWeights.clear();
+	} else {
+		pCtx->m_SkinFirst = part.skinFirst;
+		pCtx->m_SkinJoints = part.skinJoints;
+		pCtx->m_SkinWeights = part.skinWeights;
 	}
 
-	free(m_pLODCtrlValues);
-	free(m_pAllIndexChanges);
-	free(m_pCollapses);
-	
-	// NOTE: display debug info
-	printf("\nMeshName: %s\n", m_szName0);
-	printf("m_iNumCollapses      -> %d\n", m_iNumCollapses0);
-	printf("m_iTotalIndexChanges -> %d\n", m_iTotalIndexChanges0);
-	printf("m_iMaxNumVertices    -> %d\n", m_iMaxNumVertices);
-	printf("m_iMaxNumIndices     -> %d\n", m_iMaxNumIndices);
-	printf("m_iMinNumVertices    -> %d\n", m_iMinNumVertices0);
-	printf("m_iMinNumIndices     -> %d\n", m_iMinNumIndices0);
-	printf("m_iLODCtrlValueCount -> %d\n", m_iLODCtrlValueCount0);
-
-	/*
-	*/
-	fflush(stdout);
-	fclose(fpMesh);
+	return true;
 }
 
 //-----------------------------------------------------------------------------
-void N3BuildMesh(const char* szFN) {
-	FILE* fpMesh = fopen(szFN, "wb");
-	if(fpMesh == NULL) {
-		printf("\nER: Unable to create mesh file!\n");
-		system("pause");
-		exit(-1);
+// NOTE: a comma separated list of ratios in (0, 1], a short list repeats its
+// last value for the remaining slots
+bool N3ParseRatios(const char* szList, float* pRatios, int iCount) {
+	int i = 0;
+	const char* pCur = szList;
+
+	while(i<iCount && *pCur!='\0') {
+		char* pEnd = NULL;
+		float fRatio = (float) strtod(pCur, &pEnd);
+		if(pEnd==pCur || fRatio<=0.0f || fRatio>1.0f) return false;
+
+		pRatios[i++] = fRatio;
+
+		pCur = pEnd;
+		if(*pCur == ',') pCur++;
+		else if(*pCur != '\0') return false;
 	}
 
-	int nL = 0;
-	fwrite(&nL, sizeof(uint32_t), 1, fpMesh);
-
-	int m_iNumCollapses = 0;
-	int m_iTotalIndexChanges = 0;
-	int m_iMinNumIndices = m_iMaxNumIndices;
-	int m_iMinNumVertices = m_iMaxNumVertices;
-
-	fwrite(&m_iNumCollapses,      sizeof(uint32_t), 1, fpMesh);
-	fwrite(&m_iTotalIndexChanges, sizeof(uint32_t), 1, fpMesh);
-	fwrite(&m_iMaxNumVertices,    sizeof(uint32_t), 1, fpMesh);
-	fwrite(&m_iMaxNumIndices,     sizeof(uint32_t), 1, fpMesh);
-	fwrite(&m_iMinNumVertices,    sizeof(uint32_t), 1, fpMesh);
-	fwrite(&m_iMinNumIndices,     sizeof(uint32_t), 1, fpMesh);
+	if(i == 0) return false;
+	for(; i<iCount; ++i) pRatios[i] = pRatios[i-1];
 
-	if(m_iMaxNumVertices > 0) {
-		fwrite(m_pVertices, sizeof(Vertex), m_iMaxNumVertices, fpMesh);
-	}
+	return true;
+}
 
-	if(m_iMaxNumIndices > 0) {
-		fwrite(m_pIndices, sizeof(Element), m_iMaxNumIndices, fpMesh);
+//-----------------------------------------------------------------------------
+// NOTE: a comma separated list of distance:ratio pairs, up to iMaxCount of
+// them. Distances grow and ratios in [0, 1] shrink from one LOD to the next.
+// Returns how many there were, 0 if the list is malformed
+int N3ParseLODs(const char* szList, float* pDistances, float* pRatios, int iMaxCount) {
+	int i = 0;
+	const char* pCur = szList;
+
+	while(*pCur != '\0') {
+		if(i == iMaxCount) return 0;
+
+		char* pEnd = NULL;
+		float fDist = (float) strtod(pCur, &pEnd);
+		if(pEnd==pCur || *pEnd!=':' || fDist<0.0f) return 0;
+
+		pCur = pEnd+1;
+		float fRatio = (float) strtod(pCur, &pEnd);
+		if(pEnd==pCur || fRatio<0.0f || fRatio>1.0f) return 0;
+		if(i>0 && (fDist<=pDistances[i-1] || fRatio>pRatios[i-1])) return 0;
+
+		pDistances[i] = fDist;
+		pRatios[i++] = fRatio;
+
+		pCur = pEnd;
+		if(*pCur == ',') pCur++;
+		else if(*pCur != '\0') return 0;
 	}
 
-	int m_iLODCtrlValueCount = 0;
-	fwrite(&m_iLODCtrlValueCount, sizeof(uint32_t), 1, fpMesh);
-	
-	printf("\nDB: MeshName: \"\"\n");
-	printf("DB: m_iNumCollapses      -> %d\n", m_iNumCollapses);
-	printf("DB: m_iTotalIndexChanges -> %d\n", m_iTotalIndexChanges);
-	printf("DB: m_iMaxNumVertices    -> %d\n", m_iMaxNumVertices);
-	printf("DB: m_iMaxNumIndices     -> %d\n", m_iMaxNumIndices);
-	printf("DB: m_iMinNumVertices    -> %d\n", m_iMinNumVertices);
-	printf("DB: m_iMinNumIndices     -> %d\n", m_iMinNumIndices);
-
-	fflush(stdout);
-	fclose(fpMesh);
+	return i;
 }
 
 //-----------------------------------------------------------------------------
-void N3BuildSkin(const char* szFN) {
-	FILE* fpSkin = fopen(szFN, "wb");
-	if(fpSkin == NULL) {
-		printf("\nER: Unable to create mesh file!\n");
-		system("pause");
-		exit(-1);
+// NOTE: "optimize" uses Assimp's default cache size, "optimize=N" sets it
+bool N3ParseOptimize(const char* szArg, int* pCacheSize) {
+	if(!strcmp(szArg, "optimize")) {
+		*pCacheSize = PP_ICL_PTCACHE_SIZE;
+		return true;
 	}
 
-	int iNL = strlen(szFN);
-	fwrite(&iNL, sizeof(int), 1, fpSkin);
-	fwrite(szFN, sizeof(char), iNL, fpSkin);
+	if(strncmp(szArg, "optimize=", 9)) return false;
 
-	#define MAX_CHR_LOD 4
-	for(int i=0; i<MAX_CHR_LOD; ++i) {
-		// CN3IMesh::Load()
-		int iNL = 0;
-		fwrite(&iNL, sizeof(int), 1, fpSkin);
+	char* pEnd = NULL;
+	long iSize = strtol(szArg+9, &pEnd, 10);
+	if(pEnd==szArg+9 || *pEnd!='\0' || iSize<3 || iSize>256) return false;
 
-		/*
-		Element* m_pIndices;
-		Vertex*  m_pVertices;
-		size_t   m_iMaxNumIndices;
-		size_t   m_iMaxNumVertices;
-		*/
+	*pCacheSize = (int) iSize;
 
-		int nFC = 0, nVC = 0, nUVC = 0;
-		nFC  = m_iMaxNumIndices/3;
-		fwrite(&nFC, sizeof(int), 1, fpSkin);
-		nVC  = m_iMaxNumVertices;
-		fwrite(&nVC, sizeof(int), 1, fpSkin);
-		nUVC = m_iMaxNumVertices;
-		fwrite(&nUVC, sizeof(int), 1, fpSkin);
+	return true;
+}
 
-		VertUVs* m_pfUVs = new VertUVs[nVC];
-		memset(m_pfUVs, 0x00, nVC*sizeof(VertUVs));
-		__VertexXyzNormal* m_pVerticesWithNorms = new __VertexXyzNormal[nVC];
-		memset(m_pVerticesWithNorms, 0x00, nVC*sizeof(__VertexXyzNormal));
-		for(int k=0; k<nVC; ++k) {
-			m_pfUVs[k] = m_pVertices[k];
+//-----------------------------------------------------------------------------
+static Vec3 N3ToVec3(const aiVector3D& v) {
+	Vec3 r = {v.x, v.y, v.z};
+	return r;
+}
 
-			//m_pVertices[k].x /= 50.0f;//m_pVertices[k].x = (m_pVertices[k].x/10.0f +312.931f);
-			//m_pVertices[k].y /= 50.0f;
-			//m_pVertices[k].z /= 50.0f;//m_pVertices[k].z = (m_pVertices[k].z/10.0f +313.378979f);
-			m_pVerticesWithNorms[k] = m_pVertices[k];
-		}
+static __Quaternion N3ToQuaternion(const aiQuaternion& q) {
+	__Quaternion r = {q.x, q.y, q.z, q.w};
+	return r;
+}
 
-		if(nFC>0 && nVC>0) {
-			fwrite(m_pVerticesWithNorms, sizeof(__VertexXyzNormal), nVC, fpSkin);
-			fwrite(m_pIndices, sizeof(Element), 3*nFC, fpSkin);
-		}
+static aiVector3D N3SampleKeys(const aiVectorKey* pKeys, unsigned int iNumKeys, double fTime, const aiVector3D& vDefault) {
+	if(iNumKeys == 0) return vDefault;
+	if(fTime <= pKeys[0].mTime) return pKeys[0].mValue;
 
-		if(nUVC>0) {
-			fwrite(m_pfUVs, sizeof(VertUVs), nUVC, fpSkin);
-			fwrite(m_pIndices, sizeof(Element), 3*nFC, fpSkin);
+	for(unsigned int i=1; i<iNumKeys; ++i) {
+		if(fTime < pKeys[i].mTime) {
+			const aiVectorKey& k0 = pKeys[i-1];
+			const aiVectorKey& k1 = pKeys[i];
+			float t = (float) ((fTime-k0.mTime)/(k1.mTime-k0.mTime));
+			return k0.mValue + (k1.mValue-k0.mValue)*t;
 		}
+	}
 
-		delete m_pfUVs;
-		delete m_pVerticesWithNorms;
+	return pKeys[iNumKeys-1].mValue;
+}
 
-		//CN3Skin::Load()
-		for(int k=0; k<nVC; ++k) {
-			__VertexSkinned skin_vert = {};
-			skin_vert.nAffect = 0;
-			fwrite(&skin_vert, sizeof(__VertexSkinned), 1, fpSkin);
+static aiQuaternion N3SampleKeys(const aiQuatKey* pKeys, unsigned int iNumKeys, double fTime, const aiQuaternion& qDefault) {
+	if(iNumKeys == 0) return qDefault;
+	if(fTime <= pKeys[0].mTime) return pKeys[0].mValue;
+
+	for(unsigned int i=1; i<iNumKeys; ++i) {
+		if(fTime < pKeys[i].mTime) {
+			const aiQuatKey& k0 = pKeys[i-1];
+			const aiQuatKey& k1 = pKeys[i];
+			float t = (float) ((fTime-k0.mTime)/(k1.mTime-k0.mTime));
+			aiQuaternion q;
+			aiQuaternion::Interpolate(q, k0.mValue, k1.mValue, t);
+			return q.Normalize();
 		}
 	}
 
+	return pKeys[iNumKeys-1].mValue;
+}
 
-	fflush(stdout);
-	fclose(fpSkin);
+// NOTE: walk the joint subtree depth first, parents before children, which
+// is the order CN3Joint::Load rebuilds it in
+static void N3AddJoints(N3MeshContext* pCtx, const aiNode* pNode, int iParent, const aiMatrix4x4& mParent,
+	const std::map<const aiNode*, bool>& marked, const std::map<std::string, const aiBone*>& bones) {
 
-	// TEMP: write out the over things
-	fpSkin = fopen("mob_worm.n3anim", "wb");
-	if(fpSkin == NULL) {
-		printf("\nER: Unable to create mesh file!\n");
-		system("pause");
-		exit(-1);
-	}
+	aiMatrix4x4 mGlobal = mParent * pNode->mTransformation;
 
-	int nCount = 0;
-	fwrite(&nCount, sizeof(int), 1, fpSkin);
+	aiVector3D vScale, vPos;
+	aiQuaternion qRot;
+	pNode->mTransformation.Decompose(vScale, qRot, vPos);
 
-	fclose(fpSkin);
+	N3Joint joint;
+	joint.szName = pNode->mName.C_Str();
+	joint.iParent = iParent;
+	joint.iNumChildren = 0;
+	joint.vPos = N3ToVec3(vPos);
+	joint.qRot = N3ToQuaternion(qRot);
+	joint.vScale = N3ToVec3(vScale);
 
-	// TEMP: write out the over things
-	fpSkin = fopen("mob_worm.n3joint", "wb");
-	if(fpSkin == NULL) {
-		printf("\nER: Unable to create mesh file!\n");
-		system("pause");
-		exit(-1);
-	}
-
-	iNL = strlen(szFN);
-	fwrite(&iNL, sizeof(int), 1, fpSkin);
-	fwrite(szFN, sizeof(char), iNL, fpSkin);
-
-	//sizeof(__Vector3)
-	unsigned char data0[12] = {};
-	fwrite(data0, sizeof(unsigned char), 12, fpSkin);
-
-	//sizeof(__Quaternion)
-	//unsigned char data1[16] = {};
-	//fwrite(data1, sizeof(unsigned char), 16, fpSkin);
-	__Quaternion tmp = {}; tmp.w = 1.0f;
-	fwrite(&tmp, sizeof(__Quaternion), 1, fpSkin);
-
-	//sizeof(__Vector3)
-	//unsigned char data2[12] = {};
-	//fwrite(data2, sizeof(unsigned char), 12, fpSkin);
-	Vec3 tmp0 = {1.0f, 1.0f, 1.0f};
-	fwrite(&tmp0, sizeof(Vec3), 1, fpSkin);
-
-	//CN3AnimKey::Load()
-	nCount = 0;
-	fwrite(&nCount, sizeof(int), 1, fpSkin);
-	fwrite(&nCount, sizeof(int), 1, fpSkin);
-	fwrite(&nCount, sizeof(int), 1, fpSkin);
-	//m_KeyOrient
-	fwrite(&nCount, sizeof(int), 1, fpSkin);
-	//nCC
-	fwrite(&nCount, sizeof(int), 1, fpSkin);
-
-	fclose(fpSkin);
-
-	// TEMP: write out the over things
-	fpSkin = fopen("mob_worm_body.n3cpart", "wb");
-	if(fpSkin == NULL) {
-		printf("\nER: Unable to create mesh file!\n");
-		system("pause");
-		exit(-1);
+	std::map<std::string, const aiBone*>::const_iterator bone = bones.find(joint.szName);
+	if(bone != bones.end()) {
+		joint.mOffset = bone->second->mOffsetMatrix;
+	} else {
+		joint.mOffset = mGlobal;
+		joint.mOffset.Inverse();
 	}
 
-	iNL = strlen(szFN);
-	fwrite(&iNL, sizeof(int), 1, fpSkin);
-	fwrite(szFN, sizeof(char), iNL, fpSkin);
+	int iIndex = (int) pCtx->m_Joints.size();
+	pCtx->m_Joints.push_back(joint);
+
+	for(unsigned int i=0; i<pNode->mNumChildren; ++i) {
+		const aiNode* pChild = pNode->mChildren[i];
+		if(marked.find(pChild) == marked.end()) continue;
+
+		pCtx->m_Joints[iIndex].iNumChildren++;
+		N3AddJoints(pCtx, pChild, iIndex, mGlobal, marked, bones);
+	}
+}
+
+// NOTE: every animation is resampled at N3_FRAMES_PER_SEC and laid end to
+// end on the one timeline the joints carry, each getting its own clip
+static void N3SampleAnimations(N3MeshContext* pCtx, const aiScene* pScene) {
+	std::map<std::string, int> joints;
+	for(size_t j=0; j<pCtx->m_Joints.size(); ++j) {
+		joints[pCtx->m_Joints[j].szName] = (int) j;
+	}
+
+	int iFrame = 0;
+
+	for(unsigned int a=0; a<pScene->mNumAnimations; ++a) {
+		const aiAnimation* pAnim = pScene->mAnimations[a];
+
+		double fTicksPerSec = (pAnim->mTicksPerSecond > 0.0) ? pAnim->mTicksPerSecond : 25.0;
+		double fSeconds = pAnim->mDuration/fTicksPerSec;
+		int iNumFrames = (int) ceil(fSeconds*N3_FRAMES_PER_SEC) + 1;
+
+		std::vector<const aiNodeAnim*> channels(pCtx->m_Joints.size(), (const aiNodeAnim*) NULL);
+		for(unsigned int c=0; c<pAnim->mNumChannels; ++c) {
+			std::map<std::string, int>::const_iterator it = joints.find(pAnim->mChannels[c]->mNodeName.C_Str());
+			if(it != joints.end()) channels[it->second] = pAnim->mChannels[c];
+		}
+
+		for(size_t j=0; j<pCtx->m_Joints.size(); ++j) {
+			N3Joint& joint = pCtx->m_Joints[j];
+			const aiNodeAnim* pChannel = channels[j];
+
+			aiVector3D vPos(joint.vPos.x, joint.vPos.y, joint.vPos.z);
+			aiVector3D vScale(joint.vScale.x, joint.vScale.y, joint.vScale.z);
+			aiQuaternion qRot(joint.qRot.w, joint.qRot.x, joint.qRot.y, joint.qRot.z);
+
+			for(int f=0; f<iNumFrames; ++f) {
+				double fTime = (f/N3_FRAMES_PER_SEC)*fTicksPerSec;
+
+				if(pChannel == NULL) {
+					joint.KeyPos.push_back(joint.vPos);
+					joint.KeyRot.push_back(joint.qRot);
+					joint.KeyScale.push_back(joint.vScale);
+					continue;
+				}
+
+				joint.KeyPos.push_back(N3ToVec3(N3SampleKeys(pChannel->mPositionKeys, pChannel->mNumPositionKeys, fTime, vPos)));
+				joint.KeyRot.push_back(N3ToQuaternion(N3SampleKeys(pChannel->mRotationKeys, pChannel->mNumRotationKeys, fTime, qRot)));
+				joint.KeyScale.push_back(N3ToVec3(N3SampleKeys(pChannel->mScalingKeys, pChannel->mNumScalingKeys, fTime, vScale)));
+			}
+		}
+
+		N3AnimClip clip;
+		clip.szName = pAnim->mName.C_Str();
+		if(clip.szName.empty()) {
+			char szName[MAXLEN];
+			sprintf(szName, "Anim%u", a);
+			clip.szName = szName;
+		}
+		clip.fFrmStart = (float) iFrame;
+		clip.fFrmEnd = (float) (iFrame+iNumFrames-1);
+		pCtx->m_AnimClips.push_back(clip);
+
+		iFrame += iNumFrames;
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool N3ParseSkeleton(N3MeshContext* pCtx, const aiScene* pScene) {
+	pCtx->m_Joints.clear();
+	pCtx->m_AnimClips.clear();
+
+	// NOTE: the joints are the nodes the bones of any mesh and the animation
+	// channels name, plus whatever sits between them and the top of the
+	// skeleton
+	std::map<std::string, const aiBone*> bones;
+	std::map<const aiNode*, bool> marked;
+
+	std::vector<std::string> names;
+	for(unsigned int m=0; m<pScene->mNumMeshes; ++m) {
+		const aiMesh* pMesh = pScene->mMeshes[m];
+
+		for(unsigned int b=0; b<pMesh->mNumBones; ++b) {
+			if(bones.count(pMesh->mBones[b]->mName.C_Str())) continue;
+
+			bones[pMesh->mBones[b]->mName.C_Str()] = pMesh->mBones[b];
+			names.push_back(pMesh->mBones[b]->mName.C_Str());
+		}
+	}
+
+	if(bones.empty()) return true;
+	for(unsigned int a=0; a<pScene->mNumAnimations; ++a) {
+		for(unsigned int c=0; c<pScene->mAnimations[a]->mNumChannels; ++c) {
+			names.push_back(pScene->mAnimations[a]->mChannels[c]->mNodeName.C_Str());
+		}
+	}
+
+	for(size_t i=0; i<names.size(); ++i) {
+		const aiNode* pNode = pScene->mRootNode->FindNode(names[i].c_str());
+		if(pNode==NULL && bones.count(names[i])) {
+			printf("\nER: Bone \"%s\" has no node!\n", names[i].c_str());
+			return false;
+		}
+
+		for(; pNode!=NULL && !marked.count(pNode); pNode=pNode->mParent) {
+			marked[pNode] = true;
+		}
+	}
+
+	// NOTE: CN3Joint has a single root, so fall back on the scene root when
+	// the skeleton has more than one
+	const aiNode* pRoot = pScene->mRootNode;
+	std::map<const aiNode*, bool>::iterator root = marked.find(pRoot);
+	if(root != marked.end()) marked.erase(root);
+
+	int iNumTop = 0;
+	const aiNode* pTop = NULL;
+	for(unsigned int i=0; i<pRoot->mNumChildren; ++i) {
+		if(marked.count(pRoot->mChildren[i])) {
+			pTop = pRoot->mChildren[i];
+			iNumTop++;
+		}
+	}
+
+	aiMatrix4x4 mParent;
+	if(iNumTop==1 && !bones.count(pRoot->mName.C_Str())) {
+		mParent = pRoot->mTransformation;
+		pRoot = pTop;
+	}
+	marked[pRoot] = true;
+
+	N3AddJoints(pCtx, pRoot, -1, mParent, marked, bones);
+
+	N3SampleAnimations(pCtx, pScene);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool N3MapFile(N3FileMap* pMap, const char* szFN) {
+	memset(pMap, 0, sizeof(N3FileMap));
+
+#ifdef _WIN32
+	pMap->m_hFile = CreateFileA(szFN, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL
+	);
+	if(pMap->m_hFile == INVALID_HANDLE_VALUE) {
+		pMap->m_hFile = NULL;
+		return false;
+	}
+
+	LARGE_INTEGER iSize;
+	if(!GetFileSizeEx(pMap->m_hFile, &iSize) || iSize.QuadPart==0) {
+		N3UnmapFile(pMap);
+		return false;
+	}
+	pMap->m_iSize = (size_t) iSize.QuadPart;
+
+	pMap->m_hMapping = CreateFileMappingA(pMap->m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(pMap->m_hMapping == NULL) {
+		N3UnmapFile(pMap);
+		return false;
+	}
+
+	pMap->m_pData = (const unsigned char*) MapViewOfFile(pMap->m_hMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	pMap->m_iFD = open(szFN, O_RDONLY);
+	if(pMap->m_iFD < 0) {
+		pMap->m_iFD = 0;
+		return false;
+	}
+
+	struct stat st;
+	if(fstat(pMap->m_iFD, &st)!=0 || st.st_size==0) {
+		N3UnmapFile(pMap);
+		return false;
+	}
+	pMap->m_iSize = (size_t) st.st_size;
+
+	void* pData = mmap(NULL, pMap->m_iSize, PROT_READ, MAP_PRIVATE, pMap->m_iFD, 0);
+	if(pData != MAP_FAILED) pMap->m_pData = (const unsigned char*) pData;
+#endif
+
+	if(pMap->m_pData == NULL) {
+		N3UnmapFile(pMap);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void N3UnmapFile(N3FileMap* pMap) {
+#ifdef _WIN32
+	if(pMap->m_pData) UnmapViewOfFile(pMap->m_pData);
+	if(pMap->m_hMapping) CloseHandle(pMap->m_hMapping);
+	if(pMap->m_hFile) CloseHandle(pMap->m_hFile);
+#else
+	if(pMap->m_pData) munmap((void*) pMap->m_pData, pMap->m_iSize);
+	if(pMap->m_iFD > 0) close(pMap->m_iFD);
+#endif
+
+	memset(pMap, 0, sizeof(N3FileMap));
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: helpers to walk a mapping, each one fails rather than read past the end
+struct N3Cursor {
+	const unsigned char* m_pData;
+	size_t m_iLeft;
+};
+
+static bool N3ReadInt(N3Cursor* pCur, int* pValue) {
+	if(pCur->m_iLeft < sizeof(int)) return false;
+
+	memcpy(pValue, pCur->m_pData, sizeof(int));
+	pCur->m_pData += sizeof(int);
+	pCur->m_iLeft -= sizeof(int);
+
+	return true;
+}
+
+template<typename T>
+static bool N3ReadView(N3Cursor* pCur, int iCount, N3View<T>* pView) {
+	pView->m_pBytes = NULL;
+	pView->m_iCount = 0;
+
+	if(iCount < 0) return false;
+	if(pCur->m_iLeft/sizeof(T) < (size_t) iCount) return false;
+
+	if(iCount > 0) {
+		pView->m_pBytes = pCur->m_pData;
+		pView->m_iCount = (size_t) iCount;
+	}
+
+	pCur->m_pData += iCount*sizeof(T);
+	pCur->m_iLeft -= iCount*sizeof(T);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool N3ParseMesh(const N3FileMap* pMap, N3PMeshView* pView) {
+	memset(pView, 0, sizeof(N3PMeshView));
+
+	N3Cursor cur = {pMap->m_pData, pMap->m_iSize};
+
+	// NOTE: length of the name for the mesh followed by the name itself
+	int nL0 = 0;
+	if(!N3ReadInt(&cur, &nL0)) return false;
+	if(!N3ReadView(&cur, nL0, &pView->m_Name)) return false;
+
+	// NOTE: the counts that size the arrays which follow
+	if(!N3ReadInt(&cur, &pView->m_iNumCollapses)) return false;
+	if(!N3ReadInt(&cur, &pView->m_iTotalIndexChanges)) return false;
+	if(!N3ReadInt(&cur, &pView->m_iMaxNumVertices)) return false;
+	if(!N3ReadInt(&cur, &pView->m_iMaxNumIndices)) return false;
+	if(!N3ReadInt(&cur, &pView->m_iMinNumVertices)) return false;
+	if(!N3ReadInt(&cur, &pView->m_iMinNumIndices)) return false;
+
+	if(!N3ReadView(&cur, pView->m_iMaxNumVertices, &pView->m_Vertices)) return false;
+	if(!N3ReadView(&cur, pView->m_iMaxNumIndices, &pView->m_Indices)) return false;
+	if(!N3ReadView(&cur, pView->m_iNumCollapses, &pView->m_Collapses)) return false;
+	if(!N3ReadView(&cur, pView->m_iTotalIndexChanges, &pView->m_IndexChanges)) return false;
+
+	if(!N3ReadInt(&cur, &pView->m_iLODCtrlValueCount)) return false;
+	if(!N3ReadView(&cur, pView->m_iLODCtrlValueCount, &pView->m_LODCtrlValues)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: point every index a collapse touches at iValue (the new vertex when
+// splitting, CollapseTo when collapsing)
+static void N3SetIndexChanges(const N3MeshContext* pCtx, Element* pIndices, const _N3EdgeCollapse& collapse, int iValue) {
+	const N3View<int> changes = N3IndexChanges(pCtx);
+
+	int iFirst = collapse.iIndexChanges;
+	int iLast = iFirst+collapse.NumIndicesToChange;
+
+	if(iFirst < 0) iFirst = 0;
+	if(iLast > (int) changes.m_iCount) iLast = (int) changes.m_iCount;
+
+	for(int i=iFirst; i<iLast; ++i) {
+		int iChange = -1;
+		changes.Read(i, &iChange);
+		if(iChange>=0 && (size_t) iChange<pCtx->m_iMaxNumIndices) pIndices[iChange] = (Element) iValue;
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool N3LoadMesh(N3MeshContext* pCtx, const char* szFN) {
+	// NOTE: free the previous mesh
+	delete[] pCtx->m_pVertices;
+	delete[] pCtx->m_pIndices;
+	pCtx->m_pVertices = NULL;
+	pCtx->m_pIndices = NULL;
+	pCtx->m_iMaxNumVertices = 0;
+	pCtx->m_iMaxNumIndices = 0;
+	pCtx->m_Collapses.clear();
+	pCtx->m_IndexChanges.clear();
+	pCtx->m_LODCtrlValues.clear();
+	N3UnmapFile(&pCtx->m_Map);
+
+	if(!N3MapFile(&pCtx->m_Map, szFN)) {
+		fprintf(stderr, "\nERROR: Missing mesh %s\n", szFN);
+		return false;
+	}
+
+	const N3PMeshView& view = pCtx->m_View;
+	if(!N3ParseMesh(&pCtx->m_Map, &pCtx->m_View)) {
+		fprintf(stderr, "\nERROR: Corrupt mesh %s\n", szFN);
+		N3UnmapFile(&pCtx->m_Map);
+		return false;
+	}
+
+	pCtx->m_iMaxNumVertices = view.m_Vertices.m_iCount;
+	pCtx->m_iMaxNumIndices  = view.m_Indices.m_iCount;
+
+	// NOTE: the vertices, collapses, index changes and LODCtrls are read
+	// straight from the mapping, the indices are the only thing the
+	// collapses below modify so they need their own copy
+	if(pCtx->m_iMaxNumIndices > 0) {
+		pCtx->m_pIndices = new Element[pCtx->m_iMaxNumIndices];
+		view.m_Indices.Copy(0, pCtx->m_iMaxNumIndices, pCtx->m_pIndices);
+	}
+
+	// NOTE: the file holds the indices in their simplest state, split every
+	// collapse to get back to the full detail mesh
+	int m_iNumVertices = (view.m_iMinNumVertices > 0) ? view.m_iMinNumVertices : 0;
+
+	_N3EdgeCollapse collapse;
+	for(size_t c=0; view.m_Collapses.Read(c, &collapse); ++c) {
+		m_iNumVertices += collapse.NumVerticesToLose;
+		N3SetIndexChanges(pCtx, pCtx->m_pIndices, collapse, m_iNumVertices-1);
+	}
+
+	// NOTE: display debug info
+	if(!pCtx->m_bQuiet) {
+		const char* pName = (const char*) view.m_Name.m_pBytes;
+		std::string szName(pName ? pName : "", view.m_Name.m_iCount);
+
+		printf("\nMeshName: %s\n", szName.c_str());
+		printf("m_iNumCollapses      -> %d\n", view.m_iNumCollapses);
+		printf("m_iTotalIndexChanges -> %d\n", view.m_iTotalIndexChanges);
+		printf("m_iMaxNumVertices    -> %d\n", view.m_iMaxNumVertices);
+		printf("m_iMaxNumIndices     -> %d\n", view.m_iMaxNumIndices);
+		printf("m_iMinNumVertices    -> %d\n", view.m_iMinNumVertices);
+		printf("m_iMinNumIndices     -> %d\n", view.m_iMinNumIndices);
+		printf("m_iLODCtrlValueCount -> %d\n", view.m_iLODCtrlValueCount);
+	}
+
+	fflush(stdout);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: walk the collapse stream once from the full mesh down, taking a
+// snapshot at every LODCtrl on the way. The collapses follow the client's
+// SetLOD: collapse past the wanted vertex count, then split again while the
+// next collapse is marked as belonging with the one before it
+bool N3ExtractLODs(N3MeshContext* pCtx) {
+	pCtx->m_LODLevels.clear();
+
+	const N3View<Vertex> vertices = N3Vertices(pCtx);
+	const N3View<_N3EdgeCollapse> collapses = N3Collapses(pCtx);
+	const N3View<_N3LODCtrlValue> lodCtrls = N3LODCtrlValues(pCtx);
+
+	if(vertices.m_iCount==0 || pCtx->m_pIndices==NULL) {
+		printf("\nER: Mesh data missing!\n");
+		return false;
+	}
+
+	int iMaxNumVertices = (int) vertices.m_iCount;
+
+	// NOTE: the full mesh always comes first, then the LODCtrls from the most
+	// to the least detailed
+	std::vector<_N3LODCtrlValue> lods;
+
+	_N3LODCtrlValue full = {0.0f, iMaxNumVertices};
+	bool bFullDist = false;
+
+	_N3LODCtrlValue lod;
+	for(size_t i=0; lodCtrls.Read(i, &lod); ++i) {
+		if(lod.iNumVertices >= iMaxNumVertices) {
+			if(!bFullDist || lod.fDist<full.fDist) full.fDist = lod.fDist;
+			bFullDist = true;
+		} else if(lod.iNumVertices > 0) {
+			lods.push_back(lod);
+		}
+	}
+
+	std::stable_sort(lods.begin(), lods.end(), [](const _N3LODCtrlValue& l, const _N3LODCtrlValue& r) {
+		return l.iNumVertices > r.iNumVertices;
+	});
+	lods.insert(lods.begin(), full);
+
+	std::vector<Element> indices(pCtx->m_pIndices, pCtx->m_pIndices+pCtx->m_iMaxNumIndices);
+	std::vector<int> remap(iMaxNumVertices, -1);
+
+	int iNumVertices = iMaxNumVertices;
+	int iNumIndices = (int) pCtx->m_iMaxNumIndices;
+	int iLastNumVertices = -1;
+	size_t c = collapses.m_iCount;
+	_N3EdgeCollapse collapse;
+
+	for(size_t l=0; l<lods.size(); ++l) {
+		while(lods[l].iNumVertices<iNumVertices && c>0) {
+			c--;
+			collapses.Read(c, &collapse);
+			iNumIndices -= collapse.NumIndicesToLose;
+			iNumVertices -= collapse.NumVerticesToLose;
+			N3SetIndexChanges(pCtx, &indices[0], collapse, collapse.CollapseTo);
+		}
+
+		while(collapses.Read(c, &collapse) && collapse.bShouldCollapse) {
+			iNumIndices += collapse.NumIndicesToLose;
+			iNumVertices += collapse.NumVerticesToLose;
+			N3SetIndexChanges(pCtx, &indices[0], collapse, iNumVertices-1);
+			c++;
+		}
+
+		// NOTE: the same state twice in a row is the same level
+		if(iNumVertices == iLastNumVertices) continue;
+		iLastNumVertices = iNumVertices;
+
+		int iLive = std::max(0, std::min(iNumIndices, (int) indices.size()));
+		iLive -= iLive%3;
+
+		N3LODLevel level;
+		level.fDist = lods[l].fDist;
+
+		// NOTE: keep the live triangles, renumbering their vertices in the
+		// order they are first used and dropping anything collapsed flat
+		for(int i=0; i<iLive; i+=3) {
+			Element a = indices[i], b = indices[i+1], d = indices[i+2];
+			if(a==b || b==d || a==d) continue;
+			if(a>=iMaxNumVertices || b>=iMaxNumVertices || d>=iMaxNumVertices) continue;
+
+			Element tri[3] = {a, b, d};
+			for(int k=0; k<3; ++k) {
+				if(remap[tri[k]] < 0) {
+					remap[tri[k]] = (int) level.vertices.size();
+
+					Vertex v;
+					vertices.Read(tri[k], &v);
+					level.vertices.push_back(v);
+				}
+				level.indices.push_back((Element) remap[tri[k]]);
+			}
+		}
+
+		for(int i=0; i<iLive; ++i) {
+			if(indices[i] < iMaxNumVertices) remap[indices[i]] = -1;
+		}
+
+		if(level.indices.empty()) break;
+
+		pCtx->m_LODLevels.push_back(level);
+	}
+
+	return !pCtx->m_LODLevels.empty();
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: progressive mesh generation. Vertices are removed one at a time by
+// half-edge collapses picked by their quadric error (Garland & Heckbert) and
+// vertices sharing a position (UV seams) are collapsed together along the
+// seam so the texture never tears. The removal order is then rewritten into
+// the N3PMesh layout: the vertex removed last comes first and the triangles
+// a collapse drops sit at the end of the live index range at that point,
+// which is what the collapse replay in N3LoadMesh (and the client) expects.
+struct N3Quadric {
+	double m[10];
+};
+
+struct N3CollapseCost {
+	int    iClass; // 0 = clean, 1 = flips a triangle, 2 = breaks a UV seam
+	double fError;
+
+	bool operator < (const N3CollapseCost& rhs) const {
+		if(iClass != rhs.iClass) return iClass < rhs.iClass;
+		return fError < rhs.fError;
+	}
+};
+
+// NOTE: iTarget is the group to collapse into, or iGroup itself to merge
+// the wedge iFrom into iInto without moving anything
+struct N3CollapseCandidate {
+	N3CollapseCost cost;
+	int iGroup;
+	int iTarget;
+	int iFrom;
+	int iInto;
+	int iVersion;
+
+	// NOTE: std::priority_queue keeps the largest on top
+	bool operator < (const N3CollapseCandidate& rhs) const {
+		if(rhs.cost < cost) return true;
+		if(cost < rhs.cost) return false;
+		return iGroup > rhs.iGroup;
+	}
+};
+
+struct N3CollapseStep {
+	int  iVertex;
+	int  iTarget;
+	int  iNumLost;
+	int  iFirstChange;
+	int  iNumChanges;
+	bool bGrouped;
+};
+
+struct N3LODBuilder {
+	const Vertex*  pVertices;
+	const Element* pIndices;
+	int iNumVertices;
+	int iNumTris;
+	double fAttribScale;
+
+	// NOTE: optional, packed like N3MeshContext's skin so collapses keep away
+	// from vertices that follow different joints
+	const int*   pSkinFirst;
+	const int*   pSkinJoints;
+	const float* pSkinWeights;
+
+	std::vector<int> idx;
+	std::vector<bool> triAlive;
+	std::vector<int> triLost;
+	std::vector<bool> vertAlive;
+	std::vector<std::vector<int> > vertTris;
+
+	std::vector<int> groupOf;
+	std::vector<std::vector<int> > groupVerts;
+	std::vector<N3Quadric> quadrics;
+	std::vector<int> versions;
+
+	std::vector<N3CollapseStep> steps;
+	std::vector<int> changes;
+};
+
+static void N3QuadricAddPlane(N3Quadric* pQ, double a, double b, double c, double d, double w) {
+	pQ->m[0] += w*a*a; pQ->m[1] += w*a*b; pQ->m[2] += w*a*c; pQ->m[3] += w*a*d;
+	pQ->m[4] += w*b*b; pQ->m[5] += w*b*c; pQ->m[6] += w*b*d;
+	pQ->m[7] += w*c*c; pQ->m[8] += w*c*d;
+	pQ->m[9] += w*d*d;
+}
+
+static double N3QuadricError(const N3Quadric& q0, const N3Quadric& q1, const Vertex& v) {
+	double m[10];
+	for(int i=0; i<10; ++i) m[i] = q0.m[i]+q1.m[i];
+
+	double x = v.x, y = v.y, z = v.z;
+	double e = m[0]*x*x + 2*m[1]*x*y + 2*m[2]*x*z + 2*m[3]*x
+		+ m[4]*y*y + 2*m[5]*y*z + 2*m[6]*y
+		+ m[7]*z*z + 2*m[8]*z
+		+ m[9];
+
+	return (e > 0.0) ? e : 0.0;
+}
+
+static void N3TriNormal(const Vertex& a, const Vertex& b, const Vertex& c, double n[3]) {
+	double e0[3] = {b.x-a.x, b.y-a.y, b.z-a.z};
+	double e1[3] = {c.x-a.x, c.y-a.y, c.z-a.z};
+
+	n[0] = e0[1]*e1[2] - e0[2]*e1[1];
+	n[1] = e0[2]*e1[0] - e0[0]*e1[2];
+	n[2] = e0[0]*e1[1] - e0[1]*e1[0];
+}
+
+// NOTE: how differently u and v are skinned, from 0 (same joints and
+// weights) to 2 (nothing in common)
+static double N3SkinDistance(const N3LODBuilder& b, int u, int v) {
+	if(b.pSkinFirst == NULL) return 0.0;
+
+	double fDist = 0.0;
+	for(int i=b.pSkinFirst[u]; i<b.pSkinFirst[u+1]; ++i) {
+		double w = b.pSkinWeights[i];
+		for(int j=b.pSkinFirst[v]; j<b.pSkinFirst[v+1]; ++j) {
+			if(b.pSkinJoints[j] == b.pSkinJoints[i]) w -= b.pSkinWeights[j];
+		}
+		fDist += fabs(w);
+	}
+
+	for(int j=b.pSkinFirst[v]; j<b.pSkinFirst[v+1]; ++j) {
+		bool bShared = false;
+		for(int i=b.pSkinFirst[u]; i<b.pSkinFirst[u+1]; ++i) {
+			if(b.pSkinJoints[i] == b.pSkinJoints[j]) bShared = true;
+		}
+		if(!bShared) fDist += b.pSkinWeights[j];
+	}
+
+	return fDist;
+}
+
+// NOTE: the alive vertex of group iGroup sharing the most live triangles with u
+static int N3FindTarget(const N3LODBuilder& b, int u, int iGroup) {
+	int iBest = -1, iBestCount = 0;
+
+	const std::vector<int>& tris = b.vertTris[u];
+	for(size_t i=0; i<tris.size(); ++i) {
+		int t = tris[i];
+		if(!b.triAlive[t]) continue;
+
+		for(int k=0; k<3; ++k) {
+			int w = b.idx[3*t+k];
+			if(w==u || !b.vertAlive[w]) continue;
+			if(iGroup>=0 && b.groupOf[w]!=iGroup) continue;
+
+			int iCount = 0;
+			for(size_t j=0; j<tris.size(); ++j) {
+				int s = tris[j];
+				if(!b.triAlive[s]) continue;
+				if(b.idx[3*s]==w || b.idx[3*s+1]==w || b.idx[3*s+2]==w) iCount++;
+			}
+
+			if(iCount > iBestCount) {
+				iBest = w;
+				iBestCount = iCount;
+			}
+		}
+	}
+
+	return iBest;
+}
+
+static void N3NeighbourGroups(const N3LODBuilder& b, int g, std::vector<int>& groups) {
+	groups.clear();
+
+	const std::vector<int>& verts = b.groupVerts[g];
+	for(size_t i=0; i<verts.size(); ++i) {
+		int u = verts[i];
+		if(!b.vertAlive[u]) continue;
+
+		const std::vector<int>& tris = b.vertTris[u];
+		for(size_t j=0; j<tris.size(); ++j) {
+			if(!b.triAlive[tris[j]]) continue;
+
+			for(int k=0; k<3; ++k) {
+				int h = b.groupOf[b.idx[3*tris[j]+k]];
+				if(h == g) continue;
+				if(std::find(groups.begin(), groups.end(), h) == groups.end()) groups.push_back(h);
+			}
+		}
+	}
+}
+
+static N3CollapseCandidate N3EvaluateGroup(const N3LODBuilder& b, int g) {
+	N3CollapseCandidate best;
+	best.cost.iClass = 0;
+	best.cost.fError = 0.0;
+	best.iGroup = g;
+	best.iTarget = -1;
+	best.iFrom = -1;
+	best.iInto = -1;
+	best.iVersion = b.versions[g];
+
+	const std::vector<int>& verts = b.groupVerts[g];
+
+	// NOTE: merging two wedges of the same point never moves geometry, it
+	// only costs the texture and shading difference over the wedge's area
+	for(size_t i=0; i<verts.size(); ++i) {
+		int u = verts[i];
+		if(!b.vertAlive[u]) continue;
+
+		double fArea = 0.0;
+		const std::vector<int>& tris = b.vertTris[u];
+		for(size_t k=0; k<tris.size(); ++k) {
+			int t = tris[k];
+			if(!b.triAlive[t]) continue;
+
+			double n[3];
+			N3TriNormal(b.pVertices[b.idx[3*t]], b.pVertices[b.idx[3*t+1]], b.pVertices[b.idx[3*t+2]], n);
+			fArea += 0.5*sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+		}
+
+		for(size_t j=0; j<verts.size(); ++j) {
+			int v = verts[j];
+			if(v==u || !b.vertAlive[v]) continue;
+
+			const Vertex& p = b.pVertices[u];
+			const Vertex& q = b.pVertices[v];
+
+			double fUV = (p.u-q.u)*(p.u-q.u) + (p.v-q.v)*(p.v-q.v);
+			double fNormal = 1.0 - (p.nx*q.nx + p.ny*q.ny + p.nz*q.nz);
+			double fSkin = N3SkinDistance(b, u, v);
+
+			N3CollapseCost cost;
+			cost.iClass = 0;
+			cost.fError = fArea*b.fAttribScale*(fUV + 0.1*fNormal + fSkin);
+
+			if(best.iFrom<0 || cost < best.cost) {
+				best.cost = cost;
+				best.iTarget = g;
+				best.iFrom = u;
+				best.iInto = v;
+			}
+		}
+	}
+
+	std::vector<int> groups;
+	N3NeighbourGroups(b, g, groups);
+
+	// NOTE: nothing left to collapse into (isolated or fully degenerate)
+	if(groups.empty()) {
+		if(best.iFrom < 0) {
+			best.cost.iClass = 0;
+			best.cost.fError = 0.0;
+			best.iTarget = -1;
+		}
+		return best;
+	}
+
+	for(size_t i=0; i<groups.size(); ++i) {
+		int h = groups[i];
+		const Vertex& vTo = b.pVertices[b.groupVerts[h][0]];
+
+		N3CollapseCost cost;
+		cost.iClass = 0;
+		cost.fError = N3QuadricError(b.quadrics[g], b.quadrics[h], vTo);
+
+		for(size_t j=0; j<verts.size(); ++j) {
+			int u = verts[j];
+			if(!b.vertAlive[u]) continue;
+
+			bool bHasTris = false;
+			bool bReaches = false;
+			double fArea = 0.0;
+
+			const std::vector<int>& tris = b.vertTris[u];
+			for(size_t k=0; k<tris.size(); ++k) {
+				int t = tris[k];
+				if(!b.triAlive[t]) continue;
+				bHasTris = true;
+
+				if(b.pSkinFirst != NULL) {
+					double n[3];
+					N3TriNormal(b.pVertices[b.idx[3*t]], b.pVertices[b.idx[3*t+1]], b.pVertices[b.idx[3*t+2]], n);
+					fArea += 0.5*sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+				}
+
+				int c0 = b.idx[3*t], c1 = b.idx[3*t+1], c2 = b.idx[3*t+2];
+				if(b.groupOf[c0]==h || b.groupOf[c1]==h || b.groupOf[c2]==h) {
+					bReaches = true;
+					continue;
+				}
+
+				// NOTE: this triangle survives the collapse, make sure it does
+				// not turn over
+				Vertex p[3] = {b.pVertices[c0], b.pVertices[c1], b.pVertices[c2]};
+				double n0[3], n1[3];
+				N3TriNormal(p[0], p[1], p[2], n0);
+				for(int c=0; c<3; ++c) if(b.idx[3*t+c] == u) p[c] = vTo;
+				N3TriNormal(p[0], p[1], p[2], n1);
+
+				if(n0[0]*n1[0]+n0[1]*n1[1]+n0[2]*n1[2] < 0.0 && cost.iClass < 1) cost.iClass = 1;
+			}
+
+			if(bHasTris && !bReaches) cost.iClass = 2;
+
+			// NOTE: the vertex it lands on decides how the area around it bends
+			cost.fError += fArea*b.fAttribScale*N3SkinDistance(b, u, b.groupVerts[h][0]);
+		}
+
+		if(best.iTarget<0 || cost < best.cost) {
+			best.cost = cost;
+			best.iTarget = h;
+			best.iFrom = -1;
+			best.iInto = -1;
+		}
+	}
+
+	return best;
+}
+
+static void N3CollapseGroup(N3LODBuilder& b, const N3CollapseCandidate& cand) {
+	int g = cand.iGroup;
+	int h = cand.iTarget;
+
+	const std::vector<int>& verts = b.groupVerts[g];
+	size_t iFirstStep = b.steps.size();
+
+	for(size_t i=0; i<verts.size(); ++i) {
+		int u = verts[i];
+		if(!b.vertAlive[u]) continue;
+		if(h==g && u!=cand.iFrom) continue;
+
+		// NOTE: stay along the seam if possible, otherwise take any neighbour
+		int v = -1;
+		if(h == g) v = cand.iInto;
+		else if(h >= 0) v = N3FindTarget(b, u, h);
+		if(v < 0) v = N3FindTarget(b, u, -1);
+
+		N3CollapseStep step;
+		step.iVertex = u;
+		step.iTarget = v;
+		step.iNumLost = 0;
+		step.iFirstChange = (int) b.changes.size();
+		step.iNumChanges = 0;
+		step.bGrouped = false;
+
+		std::vector<int>& tris = b.vertTris[u];
+		for(size_t k=0; k<tris.size(); ++k) {
+			int t = tris[k];
+			if(!b.triAlive[t]) continue;
+
+			bool bLost = (v < 0);
+			for(int c=0; c<3; ++c) if(b.idx[3*t+c] == v) bLost = true;
+
+			if(bLost) {
+				b.triAlive[t] = false;
+				b.triLost[t] = (int) b.steps.size();
+				step.iNumLost++;
+				continue;
+			}
+
+			for(int c=0; c<3; ++c) {
+				if(b.idx[3*t+c] != u) continue;
+
+				b.idx[3*t+c] = v;
+				b.changes.push_back(3*t+c);
+				step.iNumChanges++;
+			}
+
+			b.vertTris[v].push_back(t);
+		}
+
+		b.vertAlive[u] = false;
+		tris.clear();
+
+		if(b.steps.size() > iFirstStep) b.steps.back().bGrouped = true;
+		b.steps.push_back(step);
+	}
+
+	if(h>=0 && h!=g) {
+		for(int i=0; i<10; ++i) b.quadrics[h].m[i] += b.quadrics[g].m[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: runs the collapses on b (pVertices, pIndices and the counts set, the
+// skin optional) until only iTargetVertices are left
+static bool N3RunCollapses(N3LODBuilder& b, int iTargetVertices) {
+	b.idx.assign(b.pIndices, b.pIndices+3*b.iNumTris);
+	b.triAlive.assign(b.iNumTris, true);
+	b.triLost.assign(b.iNumTris, -1);
+	b.vertAlive.assign(b.iNumVertices, true);
+	b.vertTris.resize(b.iNumVertices);
+
+	for(int t=0; t<b.iNumTris; ++t) {
+		for(int c=0; c<3; ++c) {
+			int u = b.idx[3*t+c];
+			if(u >= b.iNumVertices) return false;
+			if(c>0 && b.idx[3*t]==u) continue;
+			if(c>1 && b.idx[3*t+1]==u) continue;
+			b.vertTris[u].push_back(t);
+		}
+	}
+
+	// NOTE: vertices at the same position are wedges of one point
+	std::vector<int> order(b.iNumVertices);
+	for(int i=0; i<b.iNumVertices; ++i) order[i] = i;
+
+	const Vertex* pV = b.pVertices;
+	std::sort(order.begin(), order.end(), [pV](int l, int r) {
+		if(pV[l].x != pV[r].x) return pV[l].x < pV[r].x;
+		if(pV[l].y != pV[r].y) return pV[l].y < pV[r].y;
+		if(pV[l].z != pV[r].z) return pV[l].z < pV[r].z;
+		return l < r;
+	});
+
+	b.groupOf.resize(b.iNumVertices);
+	for(int i=0; i<b.iNumVertices; ++i) {
+		int u = order[i];
+		if(i==0 || pV[u].x!=pV[order[i-1]].x || pV[u].y!=pV[order[i-1]].y || pV[u].z!=pV[order[i-1]].z)
+			b.groupVerts.push_back(std::vector<int>());
+
+		b.groupOf[u] = (int) b.groupVerts.size()-1;
+		b.groupVerts.back().push_back(u);
+	}
+
+	int iNumGroups = (int) b.groupVerts.size();
+
+	// NOTE: wedge merges are costed in texture space, scale them so a full
+	// UV tile weighs about the same as moving across the whole mesh
+	float fMin[3] = {pV[0].x, pV[0].y, pV[0].z};
+	float fMax[3] = {pV[0].x, pV[0].y, pV[0].z};
+	for(int i=1; i<b.iNumVertices; ++i) {
+		fMin[0] = std::min(fMin[0], pV[i].x); fMax[0] = std::max(fMax[0], pV[i].x);
+		fMin[1] = std::min(fMin[1], pV[i].y); fMax[1] = std::max(fMax[1], pV[i].y);
+		fMin[2] = std::min(fMin[2], pV[i].z); fMax[2] = std::max(fMax[2], pV[i].z);
+	}
+
+	b.fAttribScale = 0.0;
+	for(int k=0; k<3; ++k) b.fAttribScale += (double) (fMax[k]-fMin[k])*(fMax[k]-fMin[k]);
+
+	// NOTE: plane quadrics of every triangle, area weighted, plus a stiff
+	// perpendicular plane along every open edge so silhouettes hold. Edges
+	// where a sheet folds back onto itself (double sided blades) count as
+	// open too, otherwise the outline could slide around in the plane for free
+	N3Quadric zero;
+	memset(&zero, 0, sizeof(N3Quadric));
+	b.quadrics.assign(iNumGroups, zero);
+	b.versions.assign(iNumGroups, 0);
+
+	std::map<std::pair<int, int>, std::vector<int> > edgeTris;
+	for(int t=0; t<b.iNumTris; ++t) {
+		const Vertex& p0 = pV[b.idx[3*t]];
+		const Vertex& p1 = pV[b.idx[3*t+1]];
+		const Vertex& p2 = pV[b.idx[3*t+2]];
+
+		double n[3];
+		N3TriNormal(p0, p1, p2, n);
+		double fLen = sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+		if(fLen <= 0.0) continue;
+
+		double a = n[0]/fLen, bb = n[1]/fLen, c = n[2]/fLen;
+		double d = -(a*p0.x + bb*p0.y + c*p0.z);
+
+		for(int k=0; k<3; ++k) {
+			N3QuadricAddPlane(&b.quadrics[b.groupOf[b.idx[3*t+k]]], a, bb, c, d, 0.5*fLen);
+
+			int g0 = b.groupOf[b.idx[3*t+k]];
+			int g1 = b.groupOf[b.idx[3*t+(k+1)%3]];
+			if(g0 != g1) edgeTris[std::make_pair(std::min(g0, g1), std::max(g0, g1))].push_back(t);
+		}
+	}
+
+	for(int t=0; t<b.iNumTris; ++t) {
+		double n[3];
+		N3TriNormal(pV[b.idx[3*t]], pV[b.idx[3*t+1]], pV[b.idx[3*t+2]], n);
+
+		for(int k=0; k<3; ++k) {
+			int u0 = b.idx[3*t+k], u1 = b.idx[3*t+(k+1)%3];
+			int g0 = b.groupOf[u0], g1 = b.groupOf[u1];
+			if(g0 == g1) continue;
+
+			const std::vector<int>& tris = edgeTris[std::make_pair(std::min(g0, g1), std::max(g0, g1))];
+			if(tris.size() == 2) {
+				int s = (tris[0] == t) ? tris[1] : tris[0];
+
+				double m[3];
+				N3TriNormal(pV[b.idx[3*s]], pV[b.idx[3*s+1]], pV[b.idx[3*s+2]], m);
+
+				double fDot = n[0]*m[0]+n[1]*m[1]+n[2]*m[2];
+				double fLen = sqrt((n[0]*n[0]+n[1]*n[1]+n[2]*n[2])*(m[0]*m[0]+m[1]*m[1]+m[2]*m[2]));
+				if(fDot > -0.5*fLen) continue;
+			} else if(tris.size() != 1) {
+				continue;
+			}
+
+			double e[3] = {pV[u1].x-pV[u0].x, pV[u1].y-pV[u0].y, pV[u1].z-pV[u0].z};
+			double p[3] = {e[1]*n[2]-e[2]*n[1], e[2]*n[0]-e[0]*n[2], e[0]*n[1]-e[1]*n[0]};
+			double fLen = sqrt(p[0]*p[0]+p[1]*p[1]+p[2]*p[2]);
+			if(fLen <= 0.0) continue;
+
+			double a = p[0]/fLen, bb = p[1]/fLen, c = p[2]/fLen;
+			double d = -(a*pV[u0].x + bb*pV[u0].y + c*pV[u0].z);
+			double w = 1000.0*(e[0]*e[0]+e[1]*e[1]+e[2]*e[2]);
+
+			N3QuadricAddPlane(&b.quadrics[g0], a, bb, c, d, w);
+			N3QuadricAddPlane(&b.quadrics[g1], a, bb, c, d, w);
+		}
+	}
+
+	// NOTE: greedily collapse the cheapest group, re-costing the groups
+	// around it after each collapse
+	std::priority_queue<N3CollapseCandidate> heap;
+	for(int g=0; g<iNumGroups; ++g) heap.push(N3EvaluateGroup(b, g));
+
+	std::vector<int> touched;
+	std::vector<int> around;
+
+	while(!heap.empty() && (int) b.steps.size()<b.iNumVertices-iTargetVertices) {
+		N3CollapseCandidate top = heap.top();
+		heap.pop();
+
+		int g = top.iGroup;
+		if(top.iVersion != b.versions[g]) continue;
+
+		N3CollapseCandidate fresh = N3EvaluateGroup(b, g);
+		if(top.cost < fresh.cost) {
+			b.versions[g]++;
+			fresh.iVersion = b.versions[g];
+			heap.push(fresh);
+			continue;
+		}
+
+		N3NeighbourGroups(b, g, touched);
+
+		size_t iFirstStep = b.steps.size();
+		N3CollapseGroup(b, fresh);
+
+		b.versions[g]++;
+		if(fresh.iTarget == g) {
+			fresh = N3EvaluateGroup(b, g);
+			heap.push(fresh);
+		}
+
+		for(size_t s=iFirstStep; s<b.steps.size(); ++s) {
+			int v = b.steps[s].iTarget;
+			if(v < 0 || !b.vertAlive[v]) continue;
+
+			N3NeighbourGroups(b, b.groupOf[v], around);
+			touched.insert(touched.end(), around.begin(), around.end());
+			touched.push_back(b.groupOf[v]);
+		}
+
+		std::sort(touched.begin(), touched.end());
+		touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+		for(size_t i=0; i<touched.size(); ++i) {
+			int h = touched[i];
+			if(h == g) continue;
+
+			b.versions[h]++;
+			heap.push(N3EvaluateGroup(b, h));
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: average cache miss ratio, the misses per triangle of a FIFO cache
+// of iCacheSize vertices like the one the hardware keeps after transform
+static float N3ComputeACMR(const Element* pIndices, int iNumIndices, int iCacheSize) {
+	if(iNumIndices < 3) return 0.0f;
+
+	std::vector<int> stamps;
+	int iNumMisses = 0;
+
+	for(int i=0; i<iNumIndices; ++i) {
+		int v = pIndices[i];
+		if(v >= (int) stamps.size()) stamps.resize(v+1, -iCacheSize);
+
+		if(iNumMisses-stamps[v] >= iCacheSize) {
+			stamps[v] = ++iNumMisses;
+		}
+	}
+
+	return (float) iNumMisses/(iNumIndices/3);
+}
+
+// NOTE: Tipsify (Sander, Nehab, Barczak 2007), the same ordering Assimp's
+// ImproveCacheLocality uses. Fans around one vertex at a time and moves on
+// to the neighbour that is still in cache and has the fewest triangles left
+static void N3OptimizeTriangles(std::vector<int>& indices, int iNumVertices, int iCacheSize) {
+	int iNumTris = (int) indices.size()/3;
+	if(iNumTris < 2) return;
+
+	std::vector<int> live(iNumVertices, 0);
+	for(size_t i=0; i<indices.size(); ++i) live[indices[i]]++;
+
+	std::vector<int> first(iNumVertices+1, 0);
+	for(int v=0; v<iNumVertices; ++v) first[v+1] = first[v]+live[v];
+
+	std::vector<int> adj(indices.size());
+	std::vector<int> fill(first.begin(), first.end()-1);
+	for(size_t i=0; i<indices.size(); ++i) adj[fill[indices[i]]++] = (int) i/3;
+
+	std::vector<int> stamps(iNumVertices, 0);
+	std::vector<bool> emitted(iNumTris, false);
+	std::vector<int> deadEnd;
+	std::vector<int> around;
+	std::vector<int> out;
+	out.reserve(indices.size());
+
+	int iTime = iCacheSize+1;
+	int iCursor = 0;
+	int f = 0;
+
+	while(f >= 0) {
+		around.clear();
+
+		for(int k=first[f]; k<first[f+1]; ++k) {
+			int t = adj[k];
+			if(emitted[t]) continue;
+			emitted[t] = true;
+
+			for(int c=0; c<3; ++c) {
+				int v = indices[3*t+c];
+				out.push_back(v);
+				deadEnd.push_back(v);
+				around.push_back(v);
+				live[v]--;
+
+				if(iTime-stamps[v] > iCacheSize) stamps[v] = iTime++;
+			}
+		}
+
+		// NOTE: prefer the neighbour that stays in cache the longest once
+		// its remaining triangles are fanned
+		int iBest = -1, iBestPriority = -1;
+		for(size_t i=0; i<around.size(); ++i) {
+			int v = around[i];
+			if(live[v] <= 0) continue;
+
+			int iPriority = 0;
+			if(iTime-stamps[v]+2*live[v] <= iCacheSize) iPriority = iTime-stamps[v];
+			if(iPriority > iBestPriority) {
+				iBest = v;
+				iBestPriority = iPriority;
+			}
+		}
+
+		while(iBest<0 && !deadEnd.empty()) {
+			int v = deadEnd.back();
+			deadEnd.pop_back();
+			if(live[v] > 0) iBest = v;
+		}
+
+		while(iBest<0 && iCursor<iNumVertices) {
+			if(live[iCursor] > 0) iBest = iCursor;
+			iCursor++;
+		}
+
+		f = iBest;
+	}
+
+	indices.swap(out);
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: a table of the context's vertices by index, two are the same when
+// their bytes match, with bSkin their joints and weights as well
+struct N3WeldHash {
+	const N3MeshContext* pCtx;
+	bool bSkin;
+
+	size_t operator () (int i) const {
+		uint32_t iHash = SuperFastHash((const char*) &pCtx->m_pVertices[i], sizeof(Vertex));
+		if(bSkin) {
+			int iFirst = pCtx->m_SkinFirst[i];
+			uint32_t iNumAffect = (uint32_t) (pCtx->m_SkinFirst[i+1]-iFirst);
+			if(iNumAffect > 0) {
+				iHash = SuperFastHash((const char*) &pCtx->m_SkinJoints[iFirst], iNumAffect*sizeof(int), iHash);
+				iHash = SuperFastHash((const char*) &pCtx->m_SkinWeights[iFirst], iNumAffect*sizeof(float), iHash);
+			}
+		}
+		return iHash;
+	}
+};
+
+struct N3WeldEqual {
+	const N3MeshContext* pCtx;
+	bool bSkin;
+
+	bool operator () (int l, int r) const {
+		if(memcmp(&pCtx->m_pVertices[l], &pCtx->m_pVertices[r], sizeof(Vertex))) return false;
+		if(!bSkin) return true;
+
+		int iFirstL = pCtx->m_SkinFirst[l], iFirstR = pCtx->m_SkinFirst[r];
+		int iNumAffect = pCtx->m_SkinFirst[l+1]-iFirstL;
+		if(iNumAffect != pCtx->m_SkinFirst[r+1]-iFirstR) return false;
+
+		return iNumAffect == 0 || (
+			!memcmp(&pCtx->m_SkinJoints[iFirstL], &pCtx->m_SkinJoints[iFirstR], iNumAffect*sizeof(int)) &&
+			!memcmp(&pCtx->m_SkinWeights[iFirstL], &pCtx->m_SkinWeights[iFirstR], iNumAffect*sizeof(float)));
+	}
+};
+
+typedef std::unordered_map<int, int, N3WeldHash, N3WeldEqual> N3WeldMap;
+
+static N3WeldMap N3MakeWeldMap(const N3MeshContext* pCtx, bool bSkin) {
+	N3WeldHash hash = {pCtx, bSkin};
+	N3WeldEqual equal = {pCtx, bSkin};
+	N3WeldMap unique(pCtx->m_iMaxNumVertices, hash, equal);
+
+	return unique;
+}
+
+//-----------------------------------------------------------------------------
+bool N3GenerateLOD(N3MeshContext* pCtx) {
+	// NOTE: everything is built on copies and only handed to the context
+	// once it all worked, a failure leaves the mesh as it was imported
+	int iNumVertices = (int) pCtx->m_iMaxNumVertices;
+	int iNumTris = (int) (pCtx->m_iMaxNumIndices/3);
+
+	if(pCtx->m_pVertices==NULL || pCtx->m_pIndices==NULL) return false;
+	if(iNumVertices==0 || iNumTris==0) return false;
+
+	for(int i=0; i<3*iNumTris; ++i) {
+		if(pCtx->m_pIndices[i] >= iNumVertices) return false;
+	}
+
+	// NOTE: Assimp hands every face corner its own vertex, weld the exact
+	// duplicates first or no two triangles would ever share an edge
+	N3WeldMap unique = N3MakeWeldMap(pCtx, false);
+	std::vector<int> weld(iNumVertices);
+	std::vector<Vertex> welded;
+
+	for(int i=0; i<iNumVertices; ++i) {
+		std::pair<N3WeldMap::iterator, bool> it = unique.insert(std::make_pair(i, (int) welded.size()));
+
+		weld[i] = it.first->second;
+		if(it.second) welded.push_back(pCtx->m_pVertices[i]);
+	}
+
+	std::vector<Element> weldedIndices(3*iNumTris);
+	for(int i=0; i<3*iNumTris; ++i) {
+		weldedIndices[i] = (Element) weld[pCtx->m_pIndices[i]];
+	}
+
+	N3LODBuilder b;
+	b.pVertices = &welded[0];
+	b.pIndices = &weldedIndices[0];
+	b.iNumVertices = (int) welded.size();
+	b.iNumTris = iNumTris;
+	b.pSkinFirst = NULL;
+	b.pSkinJoints = NULL;
+	b.pSkinWeights = NULL;
+
+	if(!N3RunCollapses(b, 0)) return false;
+
+	if((int) b.steps.size() != b.iNumVertices) return false;
+
+	// NOTE: the vertex removed last comes first
+	std::vector<int> remap(b.iNumVertices);
+	for(int s=0; s<b.iNumVertices; ++s) remap[b.steps[s].iVertex] = b.iNumVertices-1-s;
+
+	// NOTE: triangles dropped late come first so every collapse drops the
+	// tail of the live range
+	std::vector<int> triOrder(b.iNumTris);
+	for(int t=0; t<b.iNumTris; ++t) triOrder[t] = t;
+
+	std::stable_sort(triOrder.begin(), triOrder.end(), [&b](int l, int r) {
+		return b.triLost[l] > b.triLost[r];
+	});
+
+	std::vector<int> triRemap(b.iNumTris);
+	for(int t=0; t<b.iNumTris; ++t) triRemap[triOrder[t]] = t;
+
+	Vertex* pVertices = new Vertex[b.iNumVertices];
+	for(int i=0; i<b.iNumVertices; ++i) pVertices[remap[i]] = welded[i];
+
+	Element* pIndices = new Element[3*b.iNumTris];
+	for(int t=0; t<b.iNumTris; ++t) {
+		for(int c=0; c<3; ++c) {
+			pIndices[3*triRemap[t]+c] = (Element) remap[weldedIndices[3*t+c]];
+		}
+	}
+
+	// NOTE: the collapses are stored in split order, the index changes in
+	// collapse order
+	std::vector<_N3EdgeCollapse> collapses(b.iNumVertices);
+	std::vector<int> indexChanges(b.changes.size());
+
+	for(int s=0; s<b.iNumVertices; ++s) {
+		const N3CollapseStep& step = b.steps[s];
+		_N3EdgeCollapse& collapse = collapses[b.iNumVertices-1-s];
+
+		memset(&collapse, 0, sizeof(_N3EdgeCollapse));
+		collapse.NumIndicesToLose = 3*step.iNumLost;
+		collapse.NumIndicesToChange = step.iNumChanges;
+		collapse.NumVerticesToLose = 1;
+		collapse.iIndexChanges = step.iFirstChange;
+		collapse.CollapseTo = (step.iTarget >= 0) ? remap[step.iTarget] : 0;
+		collapse.bShouldCollapse = step.bGrouped;
+
+		for(int i=0; i<step.iNumChanges; ++i) {
+			int iChange = b.changes[step.iFirstChange+i];
+			indexChanges[step.iFirstChange+i] = 3*triRemap[iChange/3] + iChange%3;
+		}
+	}
+
+	// NOTE: nothing below can fail, commit the new mesh
+	delete[] pCtx->m_pVertices;
+	pCtx->m_pVertices = pVertices;
+	pCtx->m_iMaxNumVertices = b.iNumVertices;
+
+	delete[] pCtx->m_pIndices;
+	pCtx->m_pIndices = pIndices;
+
+	pCtx->m_Collapses.swap(collapses);
+	pCtx->m_IndexChanges.swap(indexChanges);
+	pCtx->m_LODCtrlValues.clear();
+
+	// NOTE: the vertex order is fixed by the collapses and the triangle
+	// order by when each is lost, only ties keep the order the import chose
+	if(pCtx->m_iCacheSize > 0) {
+		pCtx->m_fACMR = N3ComputeACMR(pIndices, 3*b.iNumTris, pCtx->m_iCacheSize);
+	}
+
+	// NOTE: the file holds the indices in their simplest state, the client
+	// starts there and splits its way up
+	for(int s=0; s<b.iNumVertices; ++s) {
+		const _N3EdgeCollapse& collapse = pCtx->m_Collapses[b.iNumVertices-1-s];
+		N3SetIndexChanges(pCtx, pIndices, collapse, collapse.CollapseTo);
+	}
+
+	for(int i=0; i<pCtx->m_iNumLODs; ++i) {
+		_N3LODCtrlValue lod;
+		lod.fDist = pCtx->m_LODDistances[i];
+		lod.iNumVertices = (int) (pCtx->m_LODRatios[i]*b.iNumVertices + 0.5f);
+		pCtx->m_LODCtrlValues.push_back(lod);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool N3BuildMesh(N3MeshContext* pCtx, const char* szFN) {
+	FILE* fpMesh = fopen(szFN, "wb");
+	if(fpMesh == NULL) {
+		printf("\nER: Unable to create mesh file!\n");
+		return false;
+	}
+
+	int nL = 0;
+	fwrite(&nL, sizeof(uint32_t), 1, fpMesh);
+
+	const N3View<Vertex> vertices = N3Vertices(pCtx);
+	const N3View<_N3EdgeCollapse> collapses = N3Collapses(pCtx);
+	const N3View<int> indexChanges = N3IndexChanges(pCtx);
+	const N3View<_N3LODCtrlValue> lodCtrls = N3LODCtrlValues(pCtx);
+
+	// NOTE: with collapses the mesh collapses all the way down to nothing
+	int m_iNumCollapses = (int) collapses.m_iCount;
+	int m_iTotalIndexChanges = (int) indexChanges.m_iCount;
+	int m_iMinNumIndices = m_iNumCollapses ? 0 : pCtx->m_iMaxNumIndices;
+	int m_iMinNumVertices = m_iNumCollapses ? 0 : pCtx->m_iMaxNumVertices;
+
+	fwrite(&m_iNumCollapses,      sizeof(uint32_t), 1, fpMesh);
+	fwrite(&m_iTotalIndexChanges, sizeof(uint32_t), 1, fpMesh);
+	fwrite(&pCtx->m_iMaxNumVertices,    sizeof(uint32_t), 1, fpMesh);
+	fwrite(&pCtx->m_iMaxNumIndices,     sizeof(uint32_t), 1, fpMesh);
+	fwrite(&m_iMinNumVertices,    sizeof(uint32_t), 1, fpMesh);
+	fwrite(&m_iMinNumIndices,     sizeof(uint32_t), 1, fpMesh);
+
+	// NOTE: the arrays are written from wherever they live, bytes as they are
+	if(vertices.m_iCount > 0) {
+		fwrite(vertices.m_pBytes, vertices.Size(), 1, fpMesh);
+	}
+
+	if(pCtx->m_iMaxNumIndices > 0) {
+		fwrite(pCtx->m_pIndices, sizeof(Element), pCtx->m_iMaxNumIndices, fpMesh);
+	}
+
+	if(m_iNumCollapses > 0) {
+		fwrite(collapses.m_pBytes, collapses.Size(), 1, fpMesh);
+	}
+
+	if(m_iTotalIndexChanges > 0) {
+		fwrite(indexChanges.m_pBytes, indexChanges.Size(), 1, fpMesh);
+	}
+
+	int m_iLODCtrlValueCount = (int) lodCtrls.m_iCount;
+	fwrite(&m_iLODCtrlValueCount, sizeof(uint32_t), 1, fpMesh);
+
+	if(m_iLODCtrlValueCount > 0) {
+		fwrite(lodCtrls.m_pBytes, lodCtrls.Size(), 1, fpMesh);
+	}
+	
+	printf("\nDB: MeshName: \"\"\n");
+	printf("DB: m_iNumCollapses      -> %d\n", m_iNumCollapses);
+	printf("DB: m_iTotalIndexChanges -> %d\n", m_iTotalIndexChanges);
+	printf("DB: m_iMaxNumVertices    -> %d\n", pCtx->m_iMaxNumVertices);
+	printf("DB: m_iMaxNumIndices     -> %d\n", pCtx->m_iMaxNumIndices);
+	printf("DB: m_iMinNumVertices    -> %d\n", m_iMinNumVertices);
+	printf("DB: m_iMinNumIndices     -> %d\n", m_iMinNumIndices);
+	printf("DB: m_iLODCtrlValueCount -> %d\n", m_iLODCtrlValueCount);
+
+	fflush(stdout);
+	fclose(fpMesh);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool N3WriteFile(const char* szFN, const N3WriteBuffer& buf) {
+	FILE* fp = fopen(szFN, "wb");
+	if(fp == NULL) {
+		printf("\nER: Unable to create \"%s\"!\n", szFN);
+		return false;
+	}
+
+	size_t iSize = buf.m_Data.size();
+	bool bWritten = (iSize==0 || fwrite(&buf.m_Data[0], 1, iSize, fp)==iSize);
+	fclose(fp);
+
+	if(!bWritten) printf("\nER: Unable to write \"%s\"!\n", szFN);
+	return bWritten;
+}
+
+static void N3WriteName(N3WriteBuffer* pBuf, const std::string& szName) {
+	pBuf->WriteInt((int) szName.size());
+	pBuf->WriteArray(szName.c_str(), szName.size());
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: one character LOD slot, the context's mesh simplified down to
+// fRatio of its vertices. source maps every vertex of the LOD back to the
+// context vertex (and skin) it came from
+struct N3SkinLOD {
+	float fRatio;
+	bool  bResult;
+	std::vector<int>     source;
+	std::vector<Element> indices;
+};
+
+// NOTE: vertices are welded first like N3GenerateLOD does, but only when
+// their skin matches as well, then collapsed with the skin weights in the
+// cost so the joints' areas keep their outline
+static void N3SimplifySkin(const N3MeshContext* pCtx, N3SkinLOD* pLOD) {
+	pLOD->bResult = false;
+	pLOD->source.clear();
+	pLOD->indices.clear();
+
+	int iNumVertices = (int) pCtx->m_iMaxNumVertices;
+	int iNumTris = (int) (pCtx->m_iMaxNumIndices/3);
+	bool bSkinned = (pCtx->m_SkinFirst.size() == (size_t) iNumVertices+1);
+
+	N3WeldMap unique = N3MakeWeldMap(pCtx, bSkinned);
+	std::vector<int> weld(iNumVertices);
+	std::vector<int> source;
+	std::vector<Vertex> vertices;
+	std::vector<int> skinFirst(1, 0);
+	std::vector<int> skinJoints;
+	std::vector<float> skinWeights;
+
+	for(int i=0; i<iNumVertices; ++i) {
+		std::pair<N3WeldMap::iterator, bool> it = unique.insert(std::make_pair(i, (int) source.size()));
+
+		weld[i] = it.first->second;
+		if(!it.second) continue;
+
+		int iFirst = 0, iNumAffect = 0;
+		if(bSkinned) {
+			iFirst = pCtx->m_SkinFirst[i];
+			iNumAffect = pCtx->m_SkinFirst[i+1]-iFirst;
+		}
+
+		source.push_back(i);
+		vertices.push_back(pCtx->m_pVertices[i]);
+
+		for(int k=0; k<iNumAffect; ++k) {
+			skinJoints.push_back(pCtx->m_SkinJoints[iFirst+k]);
+			skinWeights.push_back(pCtx->m_SkinWeights[iFirst+k]);
+		}
+		skinFirst.push_back((int) skinJoints.size());
+	}
+
+	std::vector<Element> indices(3*iNumTris);
+	for(int i=0; i<3*iNumTris; ++i) {
+		if(pCtx->m_pIndices[i] >= iNumVertices) return;
+		indices[i] = (Element) weld[pCtx->m_pIndices[i]];
+	}
+
+	int iNumUnique = (int) source.size();
+	int iTarget = std::max(3, (int) ceil(pLOD->fRatio*iNumUnique));
+
+	std::vector<int> live;
+	if(iTarget >= iNumUnique || iNumTris == 0) {
+		live.assign(indices.begin(), indices.end());
+	} else {
+		N3LODBuilder b;
+		b.pVertices = &vertices[0];
+		b.pIndices = &indices[0];
+		b.iNumVertices = iNumUnique;
+		b.iNumTris = iNumTris;
+		b.pSkinFirst = bSkinned ? &skinFirst[0] : NULL;
+		b.pSkinJoints = skinJoints.empty() ? NULL : &skinJoints[0];
+		b.pSkinWeights = skinWeights.empty() ? NULL : &skinWeights[0];
+		if(b.pSkinJoints == NULL) b.pSkinFirst = NULL;
+
+		if(!N3RunCollapses(b, iTarget)) return;
+
+		for(int t=0; t<iNumTris; ++t) {
+			if(!b.triAlive[t]) continue;
+			live.insert(live.end(), b.idx.begin()+3*t, b.idx.begin()+3*t+3);
+		}
+	}
+
+	// NOTE: each slot is a plain indexed mesh, so its triangles are free to
+	// be reordered for the cache before the vertices follow their first use
+	if(pCtx->m_iCacheSize > 0) {
+		std::vector<int> tris;
+		tris.reserve(live.size());
+		for(size_t i=0; i+2<live.size(); i+=3) {
+			if(live[i]==live[i+1] || live[i+1]==live[i+2] || live[i]==live[i+2]) continue;
+			tris.insert(tris.end(), live.begin()+i, live.begin()+i+3);
+		}
+		N3OptimizeTriangles(tris, iNumUnique, pCtx->m_iCacheSize);
+		live.swap(tris);
+	}
+
+	// NOTE: keep what is left, renumbered in the order it is first used
+	std::vector<int> remap(iNumUnique, -1);
+	for(size_t i=0; i+2<live.size(); i+=3) {
+		if(live[i]==live[i+1] || live[i+1]==live[i+2] || live[i]==live[i+2]) continue;
+
+		for(int k=0; k<3; ++k) {
+			int u = live[i+k];
+			if(remap[u] < 0) {
+				remap[u] = (int) pLOD->source.size();
+				pLOD->source.push_back(source[u]);
+			}
+			pLOD->indices.push_back((Element) remap[u]);
+		}
+	}
+
+	pLOD->bResult = true;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: the per-vertex streams of a CN3IMesh/CN3Skin for one LOD, converted
+// once from the context's vertices and written out in bulk
+struct N3SkinStreams {
+	std::vector<__VertexXyzNormal> m_VerticesWithNorms;
+	std::vector<VertUVs>           m_UVs;
+	N3WriteBuffer                  m_SkinBlock;
+};
+
+// NOTE: CN3Skin::Load follows each __VertexSkinned with its joint indices,
+// and their weights too when there is more than one. A vertex on a single
+// joint keeps its position in that joint's space, otherwise in mesh space
+static void N3BuildSkinStreams(const N3MeshContext* pCtx, const N3SkinLOD& lod, N3SkinStreams* pStreams) {
+	const Vertex* pVertices = pCtx->m_pVertices;
+	int iNumVertices = (int) lod.source.size();
+	bool bSkinned = (pCtx->m_SkinFirst.size() == pCtx->m_iMaxNumVertices+1);
+
+	pStreams->m_VerticesWithNorms.resize(iNumVertices);
+	pStreams->m_UVs.resize(iNumVertices);
+	pStreams->m_SkinBlock.m_Data.clear();
+	pStreams->m_SkinBlock.m_Data.reserve(iNumVertices*sizeof(__VertexSkinnedFile));
+
+	for(int k=0; k<iNumVertices; ++k) {
+		int i = lod.source[k];
+		pStreams->m_UVs[k] = pVertices[i];
+
+		//pVertices[i].x /= 50.0f;//pVertices[i].x = (pVertices[i].x/10.0f +312.931f);
+		//pVertices[i].y /= 50.0f;
+		//pVertices[i].z /= 50.0f;//pVertices[i].z = (pVertices[i].z/10.0f +313.378979f);
+		pStreams->m_VerticesWithNorms[k] = pVertices[i];
+
+		__VertexSkinnedFile skin_vert = {};
+		int iFirst = bSkinned ? pCtx->m_SkinFirst[i] : 0;
+		skin_vert.nAffect = bSkinned ? (pCtx->m_SkinFirst[i+1]-iFirst) : 0;
+
+		if(skin_vert.nAffect > 0) {
+			aiVector3D vOrigin(pVertices[i].x, pVertices[i].y, pVertices[i].z);
+			if(skin_vert.nAffect == 1) {
+				vOrigin = pCtx->m_Joints[pCtx->m_SkinJoints[iFirst]].mOffset * vOrigin;
+			}
+			skin_vert.vOrigin = N3ToVec3(vOrigin);
+		}
+
+		pStreams->m_SkinBlock.WriteArray(&skin_vert, 1);
+
+		if(skin_vert.nAffect > 0) {
+			pStreams->m_SkinBlock.WriteArray(&pCtx->m_SkinJoints[iFirst], skin_vert.nAffect);
+		}
+		if(skin_vert.nAffect > 1) {
+			pStreams->m_SkinBlock.WriteArray(&pCtx->m_SkinWeights[iFirst], skin_vert.nAffect);
+		}
+	}
+}
+
+static void N3WriteSkinLOD(N3WriteBuffer* pBuf, const N3SkinStreams& streams, const Element* pIndices, int iNumIndices) {
+	// CN3IMesh::Load()
+	pBuf->WriteInt(0);
+
+	int nFC = 0, nVC = 0, nUVC = 0;
+	nFC  = iNumIndices/3;
+	pBuf->WriteInt(nFC);
+	nVC  = (int) streams.m_VerticesWithNorms.size();
+	pBuf->WriteInt(nVC);
+	nUVC = (int) streams.m_UVs.size();
+	pBuf->WriteInt(nUVC);
+
+	if(nFC>0 && nVC>0) {
+		pBuf->WriteArray(&streams.m_VerticesWithNorms[0], nVC);
+		pBuf->WriteArray(pIndices, 3*nFC);
+	}
+
+	if(nUVC>0) {
+		pBuf->WriteArray(&streams.m_UVs[0], nUVC);
+		pBuf->WriteArray(pIndices, 3*nFC);
+	}
+
+	//CN3Skin::Load()
+	if(nVC>0) pBuf->Write(&streams.m_SkinBlock.m_Data[0], streams.m_SkinBlock.m_Data.size());
+}
+
+//-----------------------------------------------------------------------------
+// CN3AnimKey::Load()
+template<typename T>
+static void N3WriteKeys(N3WriteBuffer* pBuf, const std::vector<T>& keys, int eType) {
+	pBuf->WriteInt((int) keys.size());
+	if(keys.empty()) return;
+
+	float fSamplingRate = N3_FRAMES_PER_SEC;
+	pBuf->WriteInt(eType);
+	pBuf->WriteArray(&fSamplingRate, 1);
+	pBuf->WriteArray(&keys[0], keys.size());
+}
+
+// NOTE: CN3Joint::Load reads a joint then recurses into its children, so
+// writing the list front to back rebuilds the same tree
+static void N3WriteJoints(N3WriteBuffer* pBuf, const N3MeshContext* pCtx, const char* szFN) {
+	enum { KEY_VECTOR3 = 0, KEY_QUATERNION = 1 };
+
+	if(pCtx->m_Joints.empty()) {
+		// NOTE: nothing to follow, a single joint at rest
+		N3WriteName(pBuf, szFN);
+
+		Vec3 vPos = {0.0f, 0.0f, 0.0f};
+		__Quaternion qRot = {0.0f, 0.0f, 0.0f, 1.0f};
+		Vec3 vScale = {1.0f, 1.0f, 1.0f};
+		pBuf->WriteArray(&vPos, 1);
+		pBuf->WriteArray(&qRot, 1);
+		pBuf->WriteArray(&vScale, 1);
+
+		// m_KeyPos, m_KeyRot, m_KeyScale, m_KeyOrient, nCC
+		for(int i=0; i<5; ++i) pBuf->WriteInt(0);
+		return;
+	}
+
+	for(size_t j=0; j<pCtx->m_Joints.size(); ++j) {
+		const N3Joint& joint = pCtx->m_Joints[j];
+
+		// CN3Transform::Load()
+		N3WriteName(pBuf, joint.szName);
+		pBuf->WriteArray(&joint.vPos, 1);
+		pBuf->WriteArray(&joint.qRot, 1);
+		pBuf->WriteArray(&joint.vScale, 1);
+
+		N3WriteKeys(pBuf, joint.KeyPos, KEY_VECTOR3);
+		N3WriteKeys(pBuf, joint.KeyRot, KEY_QUATERNION);
+		N3WriteKeys(pBuf, joint.KeyScale, KEY_VECTOR3);
+
+		// m_KeyOrient
+		pBuf->WriteInt(0);
+
+		pBuf->WriteInt(joint.iNumChildren);
+	}
+}
+
+// NOTE: __AnimData::Load starts with the slot the name pointer used to sit
+// in, then the frame ranges, then the name itself
+static void N3WriteAnims(N3WriteBuffer* pBuf, const N3MeshContext* pCtx) {
+	pBuf->WriteInt((int) pCtx->m_AnimClips.size());
+
+	for(size_t a=0; a<pCtx->m_AnimClips.size(); ++a) {
+		const N3AnimClip& clip = pCtx->m_AnimClips[a];
+
+		float fData[11] = {};
+		fData[0] = clip.fFrmStart;  // fFrmStart
+		fData[1] = clip.fFrmEnd;    // fFrmEnd
+		fData[2] = N3_FRAMES_PER_SEC; // fFrmPerSec
+		fData[7] = 0.25f;           // fTimeBlend
+		// fFrmPlugTrace*, fFrmSound*, iBlendFlags and fFrmStrike* stay 0
+
+		pBuf->WriteInt(0);
+		pBuf->WriteArray(fData, 11);
+		N3WriteName(pBuf, clip.szName);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool N3BuildSkin(N3MeshContext* pCtx, const char* szFN) {
+	N3WriteBuffer buf;
+
+	N3WriteName(&buf, szFN);
+
+	// NOTE: every slot is simplified from the full mesh on its own thread
+	N3SkinLOD lods[MAX_CHR_LOD];
+	std::vector<std::thread> workers;
+
+	for(int i=0; i<MAX_CHR_LOD; ++i) {
+		lods[i].fRatio = pCtx->m_SkinLODRatios[i];
+		workers.push_back(std::thread(N3SimplifySkin, pCtx, &lods[i]));
+	}
+	for(size_t i=0; i<workers.size(); ++i) workers[i].join();
+
+	for(int i=0; i<MAX_CHR_LOD; ++i) {
+		if(!lods[i].bResult) {
+			printf("\nER: Unable to simplify LOD%d!\n", i);
+			return false;
+		}
+
+		N3SkinStreams streams;
+		N3BuildSkinStreams(pCtx, lods[i], &streams);
+
+		const Element* pIndices = lods[i].indices.empty() ? NULL : &lods[i].indices[0];
+		N3WriteSkinLOD(&buf, streams, pIndices, (int) lods[i].indices.size());
+
+		if(!pCtx->m_bQuiet) {
+			printf("DB: LOD%d -> %u vertices, %u triangles (%.2f)\n", i,
+				(unsigned int) lods[i].source.size(),
+				(unsigned int) lods[i].indices.size()/3,
+				lods[i].fRatio
+			);
+			if(pCtx->m_iCacheSize > 0) {
+				printf("DB: LOD%d ACMR %.3f (cache %d)\n", i,
+					N3ComputeACMR(pIndices, (int) lods[i].indices.size(), pCtx->m_iCacheSize),
+					pCtx->m_iCacheSize
+				);
+			}
+		}
+	}
+
+	if(!N3WriteFile(szFN, buf)) return false;
+
+	std::string szBase = N3StripExtension(szFN);
+	std::string szPart = szBase + ".n3cpart";
+
+	// CN3CPart::Load()
+	N3WriteBuffer part;
+	N3WriteName(&part, szPart);
 
 	int m_dwReserved = 0;
-	fwrite(&m_dwReserved, sizeof(int), 1, fpSkin);
+	part.WriteInt(m_dwReserved);
+
+	//sizeof(__Material)
+	unsigned char data3[92] = {};
+	part.WriteArray(data3, 92);
+
+	// DXT name
+	N3WriteName(&part, szBase + ".dxt");
+
+	// Skin name
+	N3WriteName(&part, szFN);
+
+	if(!N3WriteFile(szPart.c_str(), part)) return false;
+
+	if(!pCtx->m_bQuiet) {
+		printf("DB: %u weights\n", (unsigned int) pCtx->m_SkinWeights.size());
+	}
+
+	fflush(stdout);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: the .n3joint and .n3anim next to szFN, shared by every part
+bool N3BuildSkeleton(N3MeshContext* pCtx, const char* szFN) {
+	std::string szBase = N3StripExtension(szFN);
+	std::string szAnim  = szBase + ".n3anim";
+	std::string szJoint = szBase + ".n3joint";
+
+	// CN3AnimControl::Load()
+	N3WriteBuffer anim;
+	N3WriteAnims(&anim, pCtx);
+	if(!N3WriteFile(szAnim.c_str(), anim)) return false;
+
+	N3WriteBuffer joint;
+	N3WriteJoints(&joint, pCtx, szJoint.c_str());
+	if(!N3WriteFile(szJoint.c_str(), joint)) return false;
+
+	if(!pCtx->m_bQuiet) {
+		printf("DB: %u joints, %u animations\n",
+			(unsigned int) pCtx->m_Joints.size(),
+			(unsigned int) pCtx->m_AnimClips.size()
+		);
+	}
+
+	fflush(stdout);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+static void N3InitScene(aiScene* pScene, const char* szFN) {
+	pScene->mRootNode = new aiNode();
+
+	pScene->mMaterials = new aiMaterial*[1];
+	pScene->mMaterials[0] = NULL;
+	pScene->mNumMaterials = 1;
+
+	pScene->mMaterials[0] = new aiMaterial();
+
+	aiString strTex(szFN);
+	pScene->mMaterials[0]->AddProperty(
+		&strTex, AI_MATKEY_TEXTURE(aiTextureType_DIFFUSE, 0)
+	);
+}
+
+static aiMesh* N3CreateMesh(const N3View<Vertex>& vertices, const Element* pIndices, size_t iNumIndices) {
+	size_t iNumVertices = vertices.m_iCount;
+
+	aiMesh* pMesh = new aiMesh();
+	pMesh->mMaterialIndex = 0;
+
+	pMesh->mVertices = new aiVector3D[iNumVertices];
+	pMesh->mNumVertices = iNumVertices;
+
+	pMesh->mTextureCoords[0] = new aiVector3D[iNumVertices];
+	pMesh->mNumUVComponents[0] = iNumVertices;
+
+	for(unsigned int i=0; i<iNumVertices; ++i) {
+		Vertex v;
+		vertices.Read(i, &v);
+		pMesh->mVertices[i] = aiVector3D(v.x, v.y, v.z);
+		pMesh->mTextureCoords[0][i] = aiVector3D(v.u, (1.0f-v.v), 0);
+	}
+
+	pMesh->mFaces = new aiFace[(iNumIndices/3)];
+	pMesh->mNumFaces = (iNumIndices/3);
+
+	for(unsigned int i=0; i<(iNumIndices/3); ++i) {
+		aiFace& face = pMesh->mFaces[i];
+
+		face.mIndices = new unsigned int[3];
+		face.mNumIndices = 3;
+
+		face.mIndices[0] = pIndices[3*i+0];
+		face.mIndices[1] = pIndices[3*i+1];
+		face.mIndices[2] = pIndices[3*i+2];
+	}
+
+	return pMesh;
+}
+
+//-----------------------------------------------------------------------------
+bool GenerateScene(N3MeshContext* pCtx, const char* szFN) {
+	N3InitScene(&pCtx->m_Scene, szFN);
 
-	//sizeof(__Material)
-	unsigned char data3[92] = {};
-	fwrite(data3, sizeof(unsigned char), 92, fpSkin);
+	const N3View<Vertex> vertices = N3Vertices(pCtx);
 
-	// DXT name
-	char dxt_name[] = "item\\capture_flag.dxt";
-	iNL = strlen(dxt_name);
-	fwrite(&iNL, sizeof(int), 1, fpSkin);
-	fwrite(dxt_name, sizeof(char), iNL, fpSkin);
+	if(vertices.m_iCount>0 && pCtx->m_pIndices!=NULL) {
 
-	// Skin name
-	char skin_name[] = "item\\capture_flag.n3cskins";
-	iNL = strlen(skin_name);
-	fwrite(&iNL, sizeof(int), 1, fpSkin);
-	fwrite(skin_name, sizeof(char), iNL, fpSkin);
+		pCtx->m_Scene.mMeshes = new aiMesh*[1];
+		pCtx->m_Scene.mMeshes[0] = NULL;
+		pCtx->m_Scene.mNumMeshes = 1;
+
+		pCtx->m_Scene.mMeshes[0] = N3CreateMesh(
+			vertices, pCtx->m_pIndices, pCtx->m_iMaxNumIndices
+		);
+
+		pCtx->m_Scene.mRootNode->mMeshes = new unsigned int[1];
+		pCtx->m_Scene.mRootNode->mMeshes[0] = 0;
+		pCtx->m_Scene.mRootNode->mNumMeshes = 1;
+	} else {
+		printf("Failed!\n");
+		printf("\nER: Mesh data missing!\n");
+		return false;
+	}
+
+	if(!pCtx->m_bQuiet) printf("Success!\n");
+
+	fflush(stdout);
 
-	fclose(fpSkin);
+	return true;
 }
 
 //-----------------------------------------------------------------------------
-void GenerateScene(const char* szFN) {
-	m_Scene.mRootNode = new aiNode();
+// NOTE: iLevel picks a single level, -1 puts every level in the scene each
+// under its own "LOD<n>" node
+bool GenerateLODScene(N3MeshContext* pCtx, aiScene* pScene, const char* szFN, int iLevel) {
+	const std::vector<N3LODLevel>& levels = pCtx->m_LODLevels;
+
+	if(levels.empty() || iLevel>=(int) levels.size()) {
+		printf("Failed!\n");
+		printf("\nER: Mesh data missing!\n");
+		return false;
+	}
 
-	m_Scene.mMaterials = new aiMaterial*[1];
-	m_Scene.mMaterials[0] = NULL;
-	m_Scene.mNumMaterials = 1;
+	N3InitScene(pScene, szFN);
 
-	m_Scene.mMaterials[0] = new aiMaterial();
+	unsigned int iFirst = (iLevel < 0) ? 0 : iLevel;
+	unsigned int iNumMeshes = (iLevel < 0) ? (unsigned int) levels.size() : 1;
 
-	aiString strTex(szFN);
-	m_Scene.mMaterials[0]->AddProperty(
-		&strTex, AI_MATKEY_TEXTURE(aiTextureType_DIFFUSE, 0)
+	pScene->mMeshes = new aiMesh*[iNumMeshes];
+	pScene->mNumMeshes = iNumMeshes;
+
+	pScene->mRootNode->mChildren = new aiNode*[iNumMeshes];
+	pScene->mRootNode->mNumChildren = iNumMeshes;
+
+	for(unsigned int i=0; i<iNumMeshes; ++i) {
+		const N3LODLevel& level = levels[iFirst+i];
+
+		pScene->mMeshes[i] = N3CreateMesh(
+			N3MakeView(level.vertices), &level.indices[0], level.indices.size()
+		);
+
+		char szName[MAXLEN];
+		sprintf(szName, "LOD%u", iFirst+i);
+
+		aiNode* pNode = new aiNode(szName);
+		pNode->mParent = pScene->mRootNode;
+		pNode->mMeshes = new unsigned int[1];
+		pNode->mMeshes[0] = i;
+		pNode->mNumMeshes = 1;
+
+		pScene->mRootNode->mChildren[i] = pNode;
+	}
+
+	if(!pCtx->m_bQuiet) printf("Success!\n");
+
+	fflush(stdout);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+const aiExportFormatDesc* FindExportFormat(Assimp::Exporter* pExporter, const char* pFormatID) {
+	size_t iNumFormats = pExporter->GetExportFormatCount();
+
+	for(unsigned int i=0; i<iNumFormats; ++i) {
+		const aiExportFormatDesc* pFormatDesc;
+		pFormatDesc = pExporter->GetExportFormatDescription(i);
+
+		if(!strcmp(pFormatID, pFormatDesc->id)) {
+			return pFormatDesc;
+		}
+	}
+
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+static bool N3HasExtension(const std::string& szFN, const char* szExt) {
+	size_t iLen = strlen(szExt);
+	if(szFN.size() < iLen) return false;
+
+	for(size_t i=0; i<iLen; ++i) {
+		char c = szFN[szFN.size()-iLen+i];
+		if(c>='A' && c<='Z') c += 'a'-'A';
+		if(c != szExt[i]) return false;
+	}
+
+	return true;
+}
+
+static std::string N3StripExtension(const std::string& szFN) {
+	size_t iDot = szFN.find_last_of('.');
+	size_t iSep = szFN.find_last_of("/\\");
+
+	if(iDot==std::string::npos || (iSep!=std::string::npos && iDot<iSep))
+		return szFN;
+
+	return szFN.substr(0, iDot);
+}
+
+static bool N3IsDirectory(const char* szPath) {
+#ifdef _WIN32
+	DWORD dwAttrib = GetFileAttributesA(szPath);
+	return (dwAttrib!=INVALID_FILE_ATTRIBUTES && (dwAttrib&FILE_ATTRIBUTE_DIRECTORY));
+#else
+	struct stat st;
+	return (stat(szPath, &st)==0 && S_ISDIR(st.st_mode));
+#endif
+}
+
+// NOTE: list the entries of a single directory, split into files and folders
+static void N3ListDirectory(const std::string& szDir, std::vector<std::string>& files, std::vector<std::string>& dirs) {
+#ifdef _WIN32
+	WIN32_FIND_DATAA fd;
+	HANDLE hFind = FindFirstFileA((szDir+"\\*").c_str(), &fd);
+	if(hFind == INVALID_HANDLE_VALUE) return;
+
+	do {
+		if(!strcmp(fd.cFileName, ".") || !strcmp(fd.cFileName, "..")) continue;
+
+		if(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) dirs.push_back(fd.cFileName);
+		else files.push_back(fd.cFileName);
+	} while(FindNextFileA(hFind, &fd));
+
+	FindClose(hFind);
+#else
+	DIR* pDir = opendir(szDir.c_str());
+	if(pDir == NULL) return;
+
+	struct dirent* pEntry;
+	while((pEntry = readdir(pDir)) != NULL) {
+		if(!strcmp(pEntry->d_name, ".") || !strcmp(pEntry->d_name, "..")) continue;
+
+		if(N3IsDirectory((szDir+"/"+pEntry->d_name).c_str())) dirs.push_back(pEntry->d_name);
+		else files.push_back(pEntry->d_name);
+	}
+
+	closedir(pDir);
+#endif
+}
+
+// NOTE: the texture is whatever .dxt sits next to the mesh, renamed to the
+// .bmp that N3TexViewerPNG produces from it
+static void N3CollectDirectory(const std::string& szDir, const char* szExt, std::vector<N3BatchJob>& jobs) {
+	std::vector<std::string> files;
+	std::vector<std::string> dirs;
+	N3ListDirectory(szDir, files, dirs);
+
+	std::string szTexture;
+	for(size_t i=0; i<files.size(); ++i) {
+		if(N3HasExtension(files[i], ".dxt")) {
+			szTexture = N3StripExtension(files[i]) + ".bmp";
+			break;
+		}
+	}
+
+	for(size_t i=0; i<files.size(); ++i) {
+		if(!N3HasExtension(files[i], ".n3pmesh")) continue;
+
+		N3BatchJob job;
+		job.szMesh = szDir + "/" + files[i];
+		job.szTexture = szTexture;
+		job.szOutput = N3StripExtension(job.szMesh) + "." + szExt;
+		jobs.push_back(job);
+	}
+
+	for(size_t i=0; i<dirs.size(); ++i) {
+		N3CollectDirectory(szDir + "/" + dirs[i], szExt, jobs);
+	}
+}
+
+// NOTE: read the next (optionally quoted) token of a manifest line
+static bool N3NextToken(const char*& pLine, std::string& szToken) {
+	while(*pLine==' ' || *pLine=='\t') ++pLine;
+	if(*pLine=='\0' || *pLine=='\r' || *pLine=='\n') return false;
+
+	szToken.clear();
+	if(*pLine == '"') {
+		++pLine;
+		while(*pLine!='\0' && *pLine!='"') szToken += *pLine++;
+		if(*pLine == '"') ++pLine;
+	} else {
+		while(*pLine!='\0' && *pLine!=' ' && *pLine!='\t' && *pLine!='\r' && *pLine!='\n')
+			szToken += *pLine++;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool N3CollectBatchJobs(const char* szPath, const char* szExt, std::vector<N3BatchJob>& jobs) {
+	if(N3IsDirectory(szPath)) {
+		N3CollectDirectory(szPath, szExt, jobs);
+		return true;
+	}
+
+	// NOTE: otherwise this is a manifest, one "mesh [texture]" per line
+	FILE* fpList = fopen(szPath, "r");
+	if(fpList == NULL) {
+		printf("\nER: Unable to open \"%s\"!\n", szPath);
+		return false;
+	}
+
+	char szLine[MAXLEN];
+	while(fgets(szLine, MAXLEN, fpList)) {
+		const char* pLine = szLine;
+
+		N3BatchJob job;
+		if(!N3NextToken(pLine, job.szMesh) || job.szMesh[0]=='#') continue;
+
+		if(!N3NextToken(pLine, job.szTexture)) {
+			job.szTexture = N3StripExtension(job.szMesh) + ".bmp";
+			size_t iSep = job.szTexture.find_last_of("/\\");
+			if(iSep != std::string::npos) job.szTexture = job.szTexture.substr(iSep+1);
+		}
+
+		job.szOutput = N3StripExtension(job.szMesh) + "." + szExt;
+		jobs.push_back(job);
+	}
+
+	fclose(fpList);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+struct N3BatchQueue {
+	const std::vector<N3BatchJob>* pJobs;
+	const char* pFormatID;
+
+	std::atomic<size_t> iNext;
+	std::atomic<size_t> iDone;
+	std::atomic<size_t> iFailed;
+	std::mutex mtxLog;
+};
+
+static void N3BatchWorker(N3BatchQueue* pQueue) {
+	// NOTE: the exporter keeps per-call state so every worker owns one
+	Assimp::Exporter exporter;
+
+	const std::vector<N3BatchJob>& jobs = *pQueue->pJobs;
+
+	for(;;) {
+		size_t i = pQueue->iNext++;
+		if(i >= jobs.size()) break;
+
+		const N3BatchJob& job = jobs[i];
+
+		N3MeshContext* pCtx = new N3MeshContext();
+		pCtx->m_bQuiet = true;
+
+		bool bDone = N3LoadMesh(pCtx, job.szMesh.c_str()) &&
+			GenerateScene(pCtx, job.szTexture.c_str()) &&
+			exporter.Export(&pCtx->m_Scene, pQueue->pFormatID, job.szOutput.c_str())==aiReturn_SUCCESS;
+
+		delete pCtx;
+
+		if(!bDone) pQueue->iFailed++;
+		size_t iDone = ++pQueue->iDone;
+
+		std::lock_guard<std::mutex> lock(pQueue->mtxLog);
+		printf("DB: [%u/%u] %s -> %s\n",
+			(unsigned int) iDone,
+			(unsigned int) jobs.size(),
+			job.szMesh.c_str(),
+			bDone ? job.szOutput.c_str() : "Failed!"
+		);
+		fflush(stdout);
+	}
+}
+
+int N3RunBatch(const char* pFormatID, const char* szPath, unsigned int iNumThreads) {
+	Assimp::Exporter* pExporter = new Assimp::Exporter();
+	const aiExportFormatDesc* pFormatDesc = FindExportFormat(pExporter, pFormatID);
+
+	if(pFormatDesc == NULL) {
+		printf("\nER: That format is not supported! Check the following list\n");
+		delete pExporter;
+		system("N3PMeshConvert -formats\n");
+		return -1;
+	}
+
+	std::vector<N3BatchJob> jobs;
+	bool bCollected = N3CollectBatchJobs(szPath, pFormatDesc->fileExtension, jobs);
+
+	delete pExporter;
+	pExporter = NULL;
+
+	if(!bCollected) return -1;
+
+	if(iNumThreads == 0) iNumThreads = std::thread::hardware_concurrency();
+	if(iNumThreads == 0) iNumThreads = 1;
+	if(iNumThreads > jobs.size()) iNumThreads = (unsigned int) jobs.size();
+
+	printf("\nDB: Converting %u meshes to %s on %u threads...\n",
+		(unsigned int) jobs.size(), pFormatID, iNumThreads
+	);
+
+	N3BatchQueue queue;
+	queue.pJobs = &jobs;
+	queue.pFormatID = pFormatID;
+	queue.iNext = 0;
+	queue.iDone = 0;
+	queue.iFailed = 0;
+
+	std::vector<std::thread> workers;
+	for(unsigned int i=0; i<iNumThreads; ++i) {
+		workers.push_back(std::thread(N3BatchWorker, &queue));
+	}
+
+	for(size_t i=0; i<workers.size(); ++i) {
+		workers[i].join();
+	}
+
+	printf("\nDB: %u converted, %u failed\n",
+		(unsigned int) (jobs.size()-queue.iFailed),
+		(unsigned int) queue.iFailed
 	);
 
-	if(m_pVertices!=NULL && m_pIndices!=NULL) {
+	return (queue.iFailed > 0) ? -1 : 0;
+}
+
+//-----------------------------------------------------------------------------
+int N3PrintInfo(const char* szPath) {
+	std::vector<N3BatchJob> jobs;
+
+	if(N3IsDirectory(szPath)) {
+		N3CollectDirectory(szPath, "", jobs);
+	} else {
+		N3BatchJob job;
+		job.szMesh = szPath;
+		jobs.push_back(job);
+	}
+
+	// NOTE: only the headers are validated and read so the array pages of
+	// the mapping are never touched
+	int iNumBad = 0;
+	for(size_t i=0; i<jobs.size(); ++i) {
+		const char* szFN = jobs[i].szMesh.c_str();
+
+		N3FileMap map;
+		if(!N3MapFile(&map, szFN)) {
+			printf("ER: %s -> Missing!\n", szFN);
+			iNumBad++;
+			continue;
+		}
+
+		N3PMeshView view;
+		if(N3ParseMesh(&map, &view)) {
+			const char* pName = (const char*) view.m_Name.m_pBytes;
+			std::string szName(pName ? pName : "", view.m_Name.m_iCount);
+
+			printf("DB: %s -> \"%s\" %d vertices, %d indices, %d collapses, %d LODs\n",
+				szFN,
+				szName.c_str(),
+				view.m_iMaxNumVertices,
+				view.m_iMaxNumIndices,
+				view.m_iNumCollapses,
+				view.m_iLODCtrlValueCount
+			);
+		} else {
+			printf("ER: %s -> Corrupt!\n", szFN);
+			iNumBad++;
+		}
+
+		N3UnmapFile(&map);
+	}
+
+	fflush(stdout);
+
+	return (iNumBad > 0) ? -1 : 0;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: N3PZ, a .n3pmesh packed for the asset archive and the patch server.
+// Everything but the vertex and index arrays is kept as is, the indices are
+// delta coded and the lot goes through zlib. By default the vertices are kept
+// as they are so unpacking gives back the exact file, with N3PZ_QUANTIZED
+// they are cut down to positions quantized within their AABB, octahedral
+// normals and 16-bit UVs, which unpacks to the same layout with the vertices
+// snapped to that grid
+#define N3PZ_VERSION   1
+#define N3PZ_QUANTIZED 0x1
+
+#pragma pack(push, 1)
+struct N3PackHeader {
+	char     szMagic[4];
+	uint32_t iVersion;
+	uint32_t iFlags;
+	uint32_t iFileSize;
+	uint32_t iVertexOffset;
+	uint32_t iNumVertices;
+	uint32_t iNumIndices;
+	uint32_t iCRC;
+	float    vMin[3];
+	float    vMax[3];
+	float    fUVMin[2];
+	float    fUVMax[2];
+	uint32_t iRawSize;
+	uint32_t iPackedSize;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(N3PackHeader) == 80, "N3PackHeader is 80 bytes on disk");
+
+// NOTE: the seven 16-bit streams of a quantized vertex, each stored as its
+// low byte plane followed by its high one
+#define N3PZ_NUM_STREAMS 7
+
+static uint16_t N3Quantize(float f, float fMin, float fScale) {
+	float t = (f-fMin)*fScale;
+	if(!(t > 0.0f)) return 0;
+	if(t >= 65535.0f) return 65535;
+	return (uint16_t) (t+0.5f);
+}
+
+static float N3Dequantize(uint16_t q, float fMin, float fStep) {
+	return fMin + q*fStep;
+}
+
+static float N3QuantizeScale(float fMin, float fMax) {
+	return (fMax > fMin) ? 65535.0f/(fMax-fMin) : 0.0f;
+}
+
+static float N3QuantizeStep(float fMin, float fMax) {
+	return (fMax > fMin) ? (fMax-fMin)/65535.0f : 0.0f;
+}
+
+static int16_t N3ToSnorm(float f) {
+	if(!(f > -1.0f)) return -32767;
+	if(f >= 1.0f) return 32767;
+	return (int16_t) floorf(f*32767.0f+0.5f);
+}
+
+// NOTE: folds the unit sphere onto an octahedron and that flat onto a square
+static void N3EncodeOctahedral(float x, float y, float z, uint16_t* pOut) {
+	float s = fabsf(x)+fabsf(y)+fabsf(z);
+	if(!(s > 0.0f)) s = 1.0f;
+
+	float u = x/s, v = y/s;
+	if(z < 0.0f) {
+		float fu = (1.0f-fabsf(v))*(u >= 0.0f ? 1.0f : -1.0f);
+		float fv = (1.0f-fabsf(u))*(v >= 0.0f ? 1.0f : -1.0f);
+		u = fu; v = fv;
+	}
+
+	pOut[0] = (uint16_t) N3ToSnorm(u);
+	pOut[1] = (uint16_t) N3ToSnorm(v);
+}
+
+static void N3DecodeOctahedral(uint16_t qu, uint16_t qv, float* pN) {
+	float u = (int16_t) qu/32767.0f;
+	float v = (int16_t) qv/32767.0f;
+	float z = 1.0f-fabsf(u)-fabsf(v);
+
+	if(z < 0.0f) {
+		float fu = (1.0f-fabsf(v))*(u >= 0.0f ? 1.0f : -1.0f);
+		float fv = (1.0f-fabsf(u))*(v >= 0.0f ? 1.0f : -1.0f);
+		u = fu; v = fv;
+	}
+
+	float l = sqrtf(u*u+v*v+z*z);
+	pN[0] = u/l; pN[1] = v/l; pN[2] = z/l;
+}
+
+static void N3GrowBounds(float f, float* pMin, float* pMax) {
+	if(f != f || f-f != 0.0f) return;
+	if(f < *pMin) *pMin = f;
+	if(f > *pMax) *pMax = f;
+}
+
+//-----------------------------------------------------------------------------
+static bool N3EncodePack(const N3FileMap* pMap, bool bQuantize, N3WriteBuffer* pOut) {
+	N3PMeshView view;
+	if(!N3ParseMesh(pMap, &view)) return false;
+
+	N3PackHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.szMagic, "N3PZ", 4);
+	header.iVersion = N3PZ_VERSION;
+	header.iFlags = bQuantize ? N3PZ_QUANTIZED : 0;
+	header.iFileSize = (uint32_t) pMap->m_iSize;
+	header.iVertexOffset = (uint32_t) (sizeof(int)+view.m_Name.m_iCount+6*sizeof(int));
+	header.iNumVertices = (uint32_t) view.m_Vertices.m_iCount;
+	header.iNumIndices = (uint32_t) view.m_Indices.m_iCount;
+
+	size_t iArrays = header.iNumVertices*sizeof(Vertex)+header.iNumIndices*sizeof(Element);
+	size_t iTail = header.iVertexOffset+iArrays;
+
+	std::vector<unsigned char> raw;
+	raw.reserve(pMap->m_iSize);
+	raw.insert(raw.end(), pMap->m_pData, pMap->m_pData+header.iVertexOffset);
+	raw.insert(raw.end(), pMap->m_pData+iTail, pMap->m_pData+pMap->m_iSize);
+
+	// NOTE: the vertices are taken from the mapping as they are, or one at a
+	// time when they get quantized
+	const N3View<Vertex>& vertices = view.m_Vertices;
+
+	if(!bQuantize) {
+		if(header.iNumVertices > 0) {
+			raw.insert(raw.end(), vertices.m_pBytes, vertices.m_pBytes+vertices.Size());
+		}
+	} else {
+		for(int k=0; k<3; ++k) { header.vMin[k] = FLT_MAX; header.vMax[k] = -FLT_MAX; }
+		for(int k=0; k<2; ++k) { header.fUVMin[k] = FLT_MAX; header.fUVMax[k] = -FLT_MAX; }
+
+		Vertex v;
+		for(size_t i=0; vertices.Read(i, &v); ++i) {
+			N3GrowBounds(v.x, &header.vMin[0], &header.vMax[0]);
+			N3GrowBounds(v.y, &header.vMin[1], &header.vMax[1]);
+			N3GrowBounds(v.z, &header.vMin[2], &header.vMax[2]);
+			N3GrowBounds(v.u, &header.fUVMin[0], &header.fUVMax[0]);
+			N3GrowBounds(v.v, &header.fUVMin[1], &header.fUVMax[1]);
+		}
+
+		for(int k=0; k<3; ++k) if(header.vMin[k] > header.vMax[k]) header.vMin[k] = header.vMax[k] = 0.0f;
+		for(int k=0; k<2; ++k) if(header.fUVMin[k] > header.fUVMax[k]) header.fUVMin[k] = header.fUVMax[k] = 0.0f;
+
+		float fScale[5];
+		for(int k=0; k<3; ++k) fScale[k] = N3QuantizeScale(header.vMin[k], header.vMax[k]);
+		for(int k=0; k<2; ++k) fScale[3+k] = N3QuantizeScale(header.fUVMin[k], header.fUVMax[k]);
+
+		size_t iNumVertices = vertices.m_iCount;
+		size_t iFirst = raw.size();
+		raw.resize(iFirst+N3PZ_NUM_STREAMS*2*iNumVertices);
+		unsigned char* pStreams = raw.empty() ? NULL : &raw[iFirst];
+
+		for(size_t i=0; vertices.Read(i, &v); ++i) {
+			uint16_t q[N3PZ_NUM_STREAMS];
+			q[0] = N3Quantize(v.x, header.vMin[0], fScale[0]);
+			q[1] = N3Quantize(v.y, header.vMin[1], fScale[1]);
+			q[2] = N3Quantize(v.z, header.vMin[2], fScale[2]);
+			N3EncodeOctahedral(v.nx, v.ny, v.nz, &q[3]);
+			q[5] = N3Quantize(v.u, header.fUVMin[0], fScale[3]);
+			q[6] = N3Quantize(v.v, header.fUVMin[1], fScale[4]);
+
+			for(int k=0; k<N3PZ_NUM_STREAMS; ++k) {
+				pStreams[(2*k)*iNumVertices+i]   = (unsigned char) (q[k] & 0xFF);
+				pStreams[(2*k+1)*iNumVertices+i] = (unsigned char) (q[k] >> 8);
+			}
+		}
+	}
+
+	// NOTE: zigzag coded deltas keep the small steps between neighbouring
+	// indices in small values either way
+	Element iPrev = 0;
+	Element iIndex;
+	for(uint32_t i=0; view.m_Indices.Read(i, &iIndex); ++i) {
+		int16_t iDelta = (int16_t) (uint16_t) (iIndex-iPrev);
+		uint16_t iZigZag = (uint16_t) (((uint16_t) iDelta << 1) ^ (uint16_t) (iDelta >> 15));
+		raw.push_back((unsigned char) (iZigZag & 0xFF));
+		raw.push_back((unsigned char) (iZigZag >> 8));
+
+		iPrev = iIndex;
+	}
+
+	uLongf iPackedSize = compressBound((uLong) raw.size());
+	std::vector<unsigned char> packed(iPackedSize);
+
+	if(compress2(&packed[0], &iPackedSize, raw.empty() ? NULL : &raw[0], (uLong) raw.size(), Z_BEST_COMPRESSION) != Z_OK) {
+		return false;
+	}
+
+	header.iRawSize = (uint32_t) raw.size();
+	header.iPackedSize = (uint32_t) iPackedSize;
+	header.iCRC = (uint32_t) crc32(0L, pMap->m_pData, (uInt) pMap->m_iSize);
+
+	pOut->m_Data.clear();
+	pOut->WriteArray(&header, 1);
+	pOut->Write(&packed[0], iPackedSize);
+
+	return true;
+}
+
+// NOTE: raw is scratch space kept by the caller so that unpacking many files
+// in a row doesn't allocate for each one
+static bool N3DecodePack(const unsigned char* pData, size_t iSize, std::vector<unsigned char>* pRaw, std::vector<unsigned char>* pOut) {
+	N3PackHeader header;
+	if(iSize < sizeof(header)) return false;
+	memcpy(&header, pData, sizeof(header));
+
+	if(memcmp(header.szMagic, "N3PZ", 4) || header.iVersion != N3PZ_VERSION) return false;
+	if(header.iPackedSize != iSize-sizeof(header)) return false;
+
+	bool bQuantize = (header.iFlags & N3PZ_QUANTIZED) != 0;
+	size_t iNumVertices = header.iNumVertices;
+	size_t iNumIndices = header.iNumIndices;
+
+	size_t iArrays = iNumVertices*sizeof(Vertex)+iNumIndices*sizeof(Element);
+	if(header.iVertexOffset > header.iFileSize || iArrays > header.iFileSize-header.iVertexOffset) return false;
+
+	size_t iRest = header.iFileSize-iArrays;
+	size_t iVertexBytes = bQuantize ? N3PZ_NUM_STREAMS*2*iNumVertices : iNumVertices*sizeof(Vertex);
+	if(header.iRawSize != iRest+iVertexBytes+iNumIndices*sizeof(Element)) return false;
+
+	pRaw->resize(header.iRawSize);
+	pOut->resize(header.iFileSize);
+	if(header.iFileSize == 0) return true;
+
+	uLongf iRawSize = header.iRawSize;
+	if(uncompress(&(*pRaw)[0], &iRawSize, pData+sizeof(header), header.iPackedSize) != Z_OK) return false;
+	if(iRawSize != header.iRawSize) return false;
+
+	const unsigned char* pRawData = &(*pRaw)[0];
+	unsigned char* pFile = &(*pOut)[0];
+
+	size_t iTail = header.iVertexOffset+iArrays;
+	memcpy(pFile, pRawData, header.iVertexOffset);
+	memcpy(pFile+iTail, pRawData+header.iVertexOffset, iRest-header.iVertexOffset);
 
-		m_Scene.mMeshes = new aiMesh*[1];
-		m_Scene.mMeshes[0] = NULL;
-		m_Scene.mNumMeshes = 1;
+	const unsigned char* pStreams = pRawData+iRest;
+	unsigned char* pVertices = pFile+header.iVertexOffset;
 
-		m_Scene.mMeshes[0] = new aiMesh();
-		m_Scene.mMeshes[0]->mMaterialIndex = 0;
+	if(!bQuantize) {
+		memcpy(pVertices, pStreams, iVertexBytes);
+	} else {
+		float fStep[5];
+		for(int k=0; k<3; ++k) fStep[k] = N3QuantizeStep(header.vMin[k], header.vMax[k]);
+		for(int k=0; k<2; ++k) fStep[3+k] = N3QuantizeStep(header.fUVMin[k], header.fUVMax[k]);
+
+		for(size_t i=0; i<iNumVertices; ++i) {
+			uint16_t q[N3PZ_NUM_STREAMS];
+			for(int k=0; k<N3PZ_NUM_STREAMS; ++k) {
+				q[k] = (uint16_t) (pStreams[(2*k)*iNumVertices+i] | (pStreams[(2*k+1)*iNumVertices+i] << 8));
+			}
+
+			Vertex v;
+			v.x = N3Dequantize(q[0], header.vMin[0], fStep[0]);
+			v.y = N3Dequantize(q[1], header.vMin[1], fStep[1]);
+			v.z = N3Dequantize(q[2], header.vMin[2], fStep[2]);
+
+			float n[3];
+			N3DecodeOctahedral(q[3], q[4], n);
+			v.nx = n[0]; v.ny = n[1]; v.nz = n[2];
+
+			v.u = N3Dequantize(q[5], header.fUVMin[0], fStep[3]);
+			v.v = N3Dequantize(q[6], header.fUVMin[1], fStep[4]);
+
+			memcpy(pVertices+i*sizeof(Vertex), &v, sizeof(Vertex));
+		}
+	}
 
-		m_Scene.mRootNode->mMeshes = new unsigned int[1];
-		m_Scene.mRootNode->mMeshes[0] = 0;
-		m_Scene.mRootNode->mNumMeshes = 1;
+	const unsigned char* pDeltas = pStreams+iVertexBytes;
+	unsigned char* pIndices = pVertices+iNumVertices*sizeof(Vertex);
 
-		aiMesh* pMesh = m_Scene.mMeshes[0];
+	Element iPrev = 0;
+	for(size_t i=0; i<iNumIndices; ++i) {
+		uint16_t iZigZag = (uint16_t) (pDeltas[2*i] | (pDeltas[2*i+1] << 8));
+		int16_t iDelta = (int16_t) ((iZigZag >> 1) ^ (uint16_t) -(int16_t) (iZigZag & 1));
 
-		pMesh->mVertices = new aiVector3D[m_iMaxNumVertices];
-		pMesh->mNumVertices = m_iMaxNumVertices;
+		Element iIndex = (Element) (iPrev+iDelta);
+		memcpy(pIndices+i*sizeof(Element), &iIndex, sizeof(Element));
 
-		pMesh->mTextureCoords[0] = new aiVector3D[m_iMaxNumVertices];
-		pMesh->mNumUVComponents[0] = m_iMaxNumVertices;
+		iPrev = iIndex;
+	}
+
+	// NOTE: a quantized pack only promises the layout, not the vertex bits
+	if(!bQuantize && crc32(0L, pFile, header.iFileSize) != header.iCRC) return false;
+
+	return true;
+}
 
-		for(unsigned int i=0; i<m_iMaxNumVertices; ++i) {
-			Vertex v = m_pVertices[i];
-			pMesh->mVertices[i] = aiVector3D(v.x, v.y, v.z);
-			pMesh->mTextureCoords[0][i] = aiVector3D(v.u, (1.0f-v.v), 0);
+//-----------------------------------------------------------------------------
+static bool N3PackMesh(const char* szFN, const char* szOut, bool bQuantize, size_t* pSize, size_t* pPacked) {
+	N3FileMap map;
+	if(!N3MapFile(&map, szFN)) return false;
+
+	N3WriteBuffer buf;
+	bool bDone = N3EncodePack(&map, bQuantize, &buf);
+
+	// NOTE: never ship a pack that doesn't unpack, lossless ones must come
+	// back bit for bit and quantized ones with everything but the vertices
+	if(bDone) {
+		std::vector<unsigned char> raw, file;
+		bDone = N3DecodePack(&buf.m_Data[0], buf.m_Data.size(), &raw, &file) && file.size()==map.m_iSize;
+
+		if(bDone && !bQuantize) {
+			bDone = (map.m_iSize == 0) || !memcmp(&file[0], map.m_pData, map.m_iSize);
+		} else if(bDone) {
+			N3PackHeader header;
+			memcpy(&header, &buf.m_Data[0], sizeof(header));
+
+			size_t iVertices = header.iVertexOffset+header.iNumVertices*sizeof(Vertex);
+			bDone = !memcmp(&file[0], map.m_pData, header.iVertexOffset) &&
+				!memcmp(&file[iVertices], map.m_pData+iVertices, map.m_iSize-iVertices);
 		}
+	}
+
+	*pSize = map.m_iSize;
+	N3UnmapFile(&map);
+
+	if(!bDone) return false;
 
-		pMesh->mFaces = new aiFace[(m_iMaxNumIndices/3)];
-		pMesh->mNumFaces = (m_iMaxNumIndices/3);
+	*pPacked = buf.m_Data.size();
 
-		for(unsigned int i=0; i<(m_iMaxNumIndices/3); ++i) {
-			aiFace& face = pMesh->mFaces[i];
+	return N3WriteFile(szOut, buf);
+}
+
+int N3PackMeshes(const char* szPath, bool bQuantize) {
+	std::vector<N3BatchJob> jobs;
+
+	if(N3IsDirectory(szPath)) {
+		N3CollectDirectory(szPath, "n3pz", jobs);
+	} else {
+		N3BatchJob job;
+		job.szMesh = szPath;
+		job.szOutput = N3StripExtension(job.szMesh) + ".n3pz";
+		jobs.push_back(job);
+	}
+
+	size_t iTotal = 0, iTotalPacked = 0;
+	int iNumBad = 0;
 
-			face.mIndices = new unsigned int[3];
-			face.mNumIndices = 3;
+	for(size_t i=0; i<jobs.size(); ++i) {
+		const N3BatchJob& job = jobs[i];
 
-			face.mIndices[0] = m_pIndices[3*i+0];
-			face.mIndices[1] = m_pIndices[3*i+1];
-			face.mIndices[2] = m_pIndices[3*i+2];
+		size_t iSize = 0, iPacked = 0;
+		if(!N3PackMesh(job.szMesh.c_str(), job.szOutput.c_str(), bQuantize, &iSize, &iPacked)) {
+			printf("ER: %s -> Failed!\n", job.szMesh.c_str());
+			iNumBad++;
+			continue;
 		}
+
+		iTotal += iSize;
+		iTotalPacked += iPacked;
+
+		printf("DB: %s -> %s %u -> %u bytes\n",
+			job.szMesh.c_str(),
+			job.szOutput.c_str(),
+			(unsigned int) iSize,
+			(unsigned int) iPacked
+		);
+	}
+
+	if(iTotal > 0) {
+		printf("DB: %u files, %u -> %u bytes (%.1f%%)\n",
+			(unsigned int) (jobs.size()-iNumBad),
+			(unsigned int) iTotal,
+			(unsigned int) iTotalPacked,
+			100.0f*iTotalPacked/iTotal
+		);
+	}
+
+	fflush(stdout);
+
+	return (iNumBad > 0) ? -1 : 0;
+}
+
+bool N3UnpackMesh(const char* szFN, const char* szOut) {
+	N3FileMap map;
+	if(!N3MapFile(&map, szFN)) {
+		printf("ER: %s -> Missing!\n", szFN);
+		return false;
+	}
+
+	std::vector<unsigned char> raw, file;
+	bool bDone = N3DecodePack(map.m_pData, map.m_iSize, &raw, &file);
+	N3UnmapFile(&map);
+
+	if(!bDone) {
+		printf("ER: %s -> Corrupt!\n", szFN);
+		return false;
+	}
+
+	N3WriteBuffer buf;
+	buf.m_Data.swap(file);
+	if(!N3WriteFile(szOut, buf)) return false;
+
+	printf("DB: %s -> %s %u bytes\n", szFN, szOut, (unsigned int) buf.m_Data.size());
+	fflush(stdout);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: packs every mesh in memory both ways and times unpacking them all,
+// the throughput is counted in unpacked .n3pmesh bytes
+int N3BenchPack(const char* szPath, int iIterations) {
+	std::vector<N3BatchJob> jobs;
+
+	if(N3IsDirectory(szPath)) {
+		N3CollectDirectory(szPath, "", jobs);
 	} else {
-		printf("Failed!\n");
-		printf("\nER: Mesh data missing!\n");
-		system("pause");
-		exit(-1);
+		N3BatchJob job;
+		job.szMesh = szPath;
+		jobs.push_back(job);
 	}
 
-	printf("Success!\n");
+	std::vector<unsigned char> raw, file;
+
+	for(int m=0; m<2; ++m) {
+		bool bQuantize = (m == 1);
+
+		std::vector<N3WriteBuffer> packs;
+		size_t iTotal = 0, iTotalPacked = 0;
+
+		for(size_t i=0; i<jobs.size(); ++i) {
+			N3FileMap map;
+			if(!N3MapFile(&map, jobs[i].szMesh.c_str())) continue;
+
+			packs.push_back(N3WriteBuffer());
+			if(N3EncodePack(&map, bQuantize, &packs.back())) {
+				iTotal += map.m_iSize;
+				iTotalPacked += packs.back().m_Data.size();
+			} else {
+				printf("ER: %s -> Corrupt!\n", jobs[i].szMesh.c_str());
+				packs.pop_back();
+			}
+
+			N3UnmapFile(&map);
+		}
+
+		if(packs.empty()) {
+			printf("ER: Nothing to unpack in %s!\n", szPath);
+			return -1;
+		}
+
+		std::chrono::high_resolution_clock::time_point tStart = std::chrono::high_resolution_clock::now();
+
+		for(int it=0; it<iIterations; ++it) {
+			for(size_t i=0; i<packs.size(); ++i) {
+				if(!N3DecodePack(&packs[i].m_Data[0], packs[i].m_Data.size(), &raw, &file)) {
+					printf("ER: Unpacking failed!\n");
+					return -1;
+				}
+			}
+		}
+
+		double fSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now()-tStart).count();
+		double fBytes = (double) iTotal*iIterations;
+
+		printf("DB: %-8s %u files, %u -> %u bytes (%.1f%%), %.1f MB/s, %.2f us per file\n",
+			bQuantize ? "quantize" : "lossless",
+			(unsigned int) packs.size(),
+			(unsigned int) iTotal,
+			(unsigned int) iTotalPacked,
+			100.0f*iTotalPacked/iTotal,
+			fSeconds > 0.0 ? fBytes/fSeconds/(1024.0*1024.0) : 0.0,
+			1e6*fSeconds/((double) packs.size()*iIterations)
+		);
+	}
 
 	fflush(stdout);
+
+	return 0;
 }
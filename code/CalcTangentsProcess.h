@@ -108,6 +108,9 @@ private:
     /** Configuration option: maximum smoothing angle, in radians*/
     float configMaxAngle;
     unsigned int configSourceUV;
+
+    /** Number of threads the meshes are distributed on */
+    unsigned int configNumThreads;
 };
 
 } // end of namespace Assimp
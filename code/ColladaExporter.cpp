@@ -58,6 +58,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <memory>
 #include <ctime>
 #include <set>
+#include <sstream>
 
 using namespace Assimp;
 
@@ -71,17 +72,17 @@ void ExportSceneCollada(const char* pFile, IOSystem* pIOSystem, const aiScene* p
     std::string path = DefaultIOSystem::absolutePath(std::string(pFile));
     std::string file = DefaultIOSystem::completeBaseName(std::string(pFile));
 
-    // invoke the exporter
-    ColladaExporter iDoTheExportThing( pScene, pIOSystem, path, file);
-
-    // we're still here - export successfully completed. Write result to the given IOSYstem
     std::unique_ptr<IOStream> outfile (pIOSystem->Open(pFile,"wt"));
     if(outfile == NULL) {
         throw DeadlyExportError("could not open output .dae file: " + std::string(pFile));
     }
+    IOStreamWriter out(outfile.get());
 
-    // XXX maybe use a small wrapper around IOStream that behaves like std::stringstream in order to avoid the extra copy.
-    outfile->Write( iDoTheExportThing.mOutput.str().c_str(), static_cast<size_t>(iDoTheExportThing.mOutput.tellp()),1);
+    // invoke the exporter
+    ColladaExporter iDoTheExportThing( pScene, pIOSystem, path, file, out);
+
+    // we're still here - export successfully completed
+    out.flush();
 }
 
 } // end of namespace Assimp
@@ -90,12 +91,8 @@ void ExportSceneCollada(const char* pFile, IOSystem* pIOSystem, const aiScene* p
 
 // ------------------------------------------------------------------------------------------------
 // Constructor for a specific scene to export
-ColladaExporter::ColladaExporter( const aiScene* pScene, IOSystem* pIOSystem, const std::string& path, const std::string& file) : mIOSystem(pIOSystem), mPath(path), mFile(file)
+ColladaExporter::ColladaExporter( const aiScene* pScene, IOSystem* pIOSystem, const std::string& path, const std::string& file, IOStreamWriter& out) : mOutput(out), mIOSystem(pIOSystem), mPath(path), mFile(file)
 {
-    // make sure that all formatting happens using the standard, C locale and not the user's current locale
-    mOutput.imbue( std::locale("C") );
-    mOutput.precision(16);
-
     mScene = pScene;
     mSceneOwned = false;
 
@@ -1044,24 +1041,25 @@ aiBone* findBone( const aiScene* scene, const char * name) {
 // Recursively writes the given node
 void ColladaExporter::WriteNode( const aiScene* pScene, aiNode* pNode)
 {
-    // the node must have a name
-    if (pNode->mName.length == 0)
+    // the node must have a name. Make one up without touching the scene, which may be the caller's
+    aiString nodeName = pNode->mName;
+    if (nodeName.length == 0)
     {
         std::stringstream ss;
         ss << "Node_" << pNode;
-        pNode->mName.Set(ss.str());
+        nodeName.Set(ss.str());
     }
 
     // If the node is associated with a bone, it is a joint node (JOINT)
     // otherwise it is a normal node (NODE)
     const char * node_type;
-    if (NULL == findBone(pScene, pNode->mName.C_Str())) {
+    if (NULL == findBone(pScene, nodeName.C_Str())) {
         node_type = "NODE";
     } else {
         node_type = "JOINT";
     }
 
-    const std::string node_name_escaped = XMLEscape(pNode->mName.data);
+    const std::string node_name_escaped = XMLEscape(nodeName.data);
     mOutput << startstr
             << "<node id=\"" << node_name_escaped
             << "\" name=\"" << node_name_escaped
@@ -1082,14 +1080,14 @@ void ColladaExporter::WriteNode( const aiScene* pScene, aiNode* pNode)
     if(pNode->mNumMeshes==0){
         //check if it is a camera node
         for(size_t i=0; i<mScene->mNumCameras; i++){
-            if(mScene->mCameras[i]->mName == pNode->mName){
+            if(mScene->mCameras[i]->mName == nodeName){
                 mOutput << startstr <<"<instance_camera url=\"#" << node_name_escaped << "-camera\"/>" << endstr;
                 break;
             }
         }
         //check if it is a light node
         for(size_t i=0; i<mScene->mNumLights; i++){
-            if(mScene->mLights[i]->mName == pNode->mName){
+            if(mScene->mLights[i]->mName == nodeName){
                 mOutput << startstr <<"<instance_light url=\"#" << node_name_escaped << "-light\"/>" << endstr;
                 break;
             }
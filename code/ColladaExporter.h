@@ -49,7 +49,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/mesh.h>
 #include <assimp/light.h>
 #include <assimp/Exporter.hpp>
-#include <sstream>
+#include "IOStreamWriter.h"
 #include <vector>
 #include <map>
 
@@ -64,8 +64,8 @@ namespace Assimp
 class ColladaExporter
 {
 public:
-    /// Constructor for a specific scene to export
-    ColladaExporter( const aiScene* pScene, IOSystem* pIOSystem, const std::string& path, const std::string& file);
+    /// Constructor for a specific scene to export, the document is written to out
+    ColladaExporter( const aiScene* pScene, IOSystem* pIOSystem, const std::string& path, const std::string& file, IOStreamWriter& out);
 
     /// Destructor
     virtual ~ColladaExporter();
@@ -125,8 +125,8 @@ protected:
     std::string GetMeshId( size_t pIndex) const { return std::string( "meshId" ) + std::to_string(pIndex); }
 
 public:
-    /// Stringstream to write all output into
-    std::stringstream mOutput;
+    /// Writer to write all output into
+    IOStreamWriter& mOutput;
 
 protected:
     /// The IOSystem for output
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <map>
 #include <vector>
+#include <algorithm>
 #include <stdint.h>
 #include <assimp/light.h>
 #include <assimp/mesh.h>
@@ -324,6 +325,77 @@ struct SubMesh
     size_t mNumFaces; ///< number of faces in this submesh
 };
 
+/** A growing array of per-vertex data. It is allocated with new[] like the arrays of an aiMesh,
+ *  so a mesh which takes all of it can adopt the storage instead of copying it. */
+template <typename T>
+class VertexStream
+{
+public:
+    VertexStream() : mData( NULL), mSize( 0), mCapacity( 0) {}
+    ~VertexStream() { delete [] mData; }
+
+    size_t size() const { return mSize; }
+    size_t capacity() const { return mCapacity; }
+    bool empty() const { return mSize == 0; }
+
+    T& operator[]( size_t pIndex) { return mData[pIndex]; }
+    const T& operator[]( size_t pIndex) const { return mData[pIndex]; }
+    const T* data() const { return mData; }
+
+    void reserve( size_t pCapacity)
+    {
+        if( pCapacity <= mCapacity)
+            return;
+        T* data = new T[pCapacity];
+        std::copy( mData, mData + mSize, data);
+        delete [] mData;
+        mData = data;
+        mCapacity = pCapacity;
+    }
+
+    void push_back( const T& pValue)
+    {
+        if( mSize == mCapacity)
+            reserve( std::max( mCapacity * 2, size_t( 16)));
+        mData[mSize++] = pValue;
+    }
+
+    /** Pads the array with the given value up to the given size, or cuts it */
+    void resize( size_t pSize, const T& pValue)
+    {
+        if( pSize > mCapacity)
+            reserve( std::max( pSize, mCapacity * 2));
+        if( pSize > mSize)
+            std::fill( mData + mSize, mData + pSize, pValue);
+        mSize = pSize;
+    }
+
+    void clear()
+    {
+        delete [] mData;
+        mData = NULL;
+        mSize = mCapacity = 0;
+    }
+
+    /** Hands the storage over to the caller, who frees it with delete[]. The stream is empty afterwards. */
+    T* release()
+    {
+        T* data = mData;
+        mData = NULL;
+        mSize = mCapacity = 0;
+        return data;
+    }
+
+private:
+    // not copyable, the storage has a single owner
+    VertexStream( const VertexStream&);
+    VertexStream& operator=( const VertexStream&);
+
+    T* mData;
+    size_t mSize;
+    size_t mCapacity;
+};
+
 /** Contains data for a single mesh */
 struct Mesh
 {
@@ -343,12 +415,12 @@ struct Mesh
     std::vector<InputChannel> mPerVertexData;
 
     // actual mesh data, assembled on encounter of a <p> element. Verbose format, not indexed
-    std::vector<aiVector3D> mPositions;
-    std::vector<aiVector3D> mNormals;
-    std::vector<aiVector3D> mTangents;
-    std::vector<aiVector3D> mBitangents;
-    std::vector<aiVector3D> mTexCoords[AI_MAX_NUMBER_OF_TEXTURECOORDS];
-    std::vector<aiColor4D>  mColors[AI_MAX_NUMBER_OF_COLOR_SETS];
+    VertexStream<aiVector3D> mPositions;
+    VertexStream<aiVector3D> mNormals;
+    VertexStream<aiVector3D> mTangents;
+    VertexStream<aiVector3D> mBitangents;
+    VertexStream<aiVector3D> mTexCoords[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+    VertexStream<aiColor4D>  mColors[AI_MAX_NUMBER_OF_COLOR_SETS];
 
     unsigned int mNumUVComponents[AI_MAX_NUMBER_OF_TEXTURECOORDS];
 
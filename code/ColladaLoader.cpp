@@ -146,6 +146,7 @@ void ColladaLoader::InternReadFile( const std::string& pFile, aiScene* pScene, I
 
     // clean all member arrays - just for safety, it should work even if we did not
     mMeshIndexByID.clear();
+    mMeshInstanceCount.clear();
     mMaterialIndexByName.clear();
     mMeshes.clear();
     newMats.clear();
@@ -170,6 +171,9 @@ void ColladaLoader::InternReadFile( const std::string& pFile, aiScene* pScene, I
     // create the materials first, for the meshes to find
     BuildMaterials( parser, pScene);
 
+    // count the mesh instances so that each source mesh can be dropped after its last use
+    CountMeshInstances( parser, parser.mRootNode);
+
     // build the node hierarchy from it
     pScene->mRootNode = BuildHierarchy( parser, parser.mRootNode);
 
@@ -224,7 +228,7 @@ void ColladaLoader::InternReadFile( const std::string& pFile, aiScene* pScene, I
 
 // ------------------------------------------------------------------------------------------------
 // Recursively constructs a scene node for the given parser node and returns it.
-aiNode* ColladaLoader::BuildHierarchy( const ColladaParser& pParser, const Collada::Node* pNode)
+aiNode* ColladaLoader::BuildHierarchy( ColladaParser& pParser, const Collada::Node* pNode)
 {
     // create a node for it
     aiNode* node = new aiNode();
@@ -298,6 +302,41 @@ void ColladaLoader::ResolveNodeInstances( const ColladaParser& pParser, const Co
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// Counts the mesh instances of the given node and its children, following the same
+// node instances BuildHierarchy() will visit later on
+void ColladaLoader::CountMeshInstances( const ColladaParser& pParser, const Collada::Node* pNode)
+{
+    for( const Collada::MeshInstance& mid : pNode->mMeshes)
+    {
+        ColladaParser::MeshLibrary::const_iterator srcMeshIt = pParser.mMeshLibrary.find( mid.mMeshOrController);
+        if( srcMeshIt == pParser.mMeshLibrary.end())
+        {
+            ColladaParser::ControllerLibrary::const_iterator srcContrIt = pParser.mControllerLibrary.find( mid.mMeshOrController);
+            if( srcContrIt == pParser.mControllerLibrary.end())
+                continue;
+            srcMeshIt = pParser.mMeshLibrary.find( srcContrIt->second.mMeshId);
+            if( srcMeshIt == pParser.mMeshLibrary.end())
+                continue;
+        }
+        ++mMeshInstanceCount[srcMeshIt->second];
+    }
+
+    for( const Collada::Node* child : pNode->mChildren)
+        CountMeshInstances( pParser, child);
+
+    // resolve node instances quietly, BuildHierarchy() reports the broken ones
+    for( const Collada::NodeInstance& nodeInst : pNode->mNodeInstances)
+    {
+        const ColladaParser::NodeLibrary::const_iterator itt = pParser.mNodeLibrary.find( nodeInst.mNode);
+        const Collada::Node* nd = itt == pParser.mNodeLibrary.end() ? NULL : (*itt).second;
+        if( !nd)
+            nd = FindNode( pParser.mRootNode, nodeInst.mNode);
+        if( nd)
+            CountMeshInstances( pParser, nd);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Resolve UV channels
 void ColladaLoader::ApplyVertexToEffectSemanticMapping(Collada::Sampler& sampler,
@@ -437,9 +476,25 @@ void ColladaLoader::BuildCamerasForNode( const ColladaParser& pParser, const Col
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// Frees the vertex streams of a source mesh which won't be referenced anymore
+static void ReleaseVertexStreams( Collada::Mesh& pMesh)
+{
+    pMesh.mPositions.clear();
+    pMesh.mNormals.clear();
+    pMesh.mTangents.clear();
+    pMesh.mBitangents.clear();
+    for( size_t a = 0; a < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++a)
+        pMesh.mTexCoords[a].clear();
+    for( size_t a = 0; a < AI_MAX_NUMBER_OF_COLOR_SETS; ++a)
+        pMesh.mColors[a].clear();
+    std::vector<size_t>().swap( pMesh.mFaceSize);
+    std::vector<size_t>().swap( pMesh.mFacePosIndices);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Builds meshes for the given node and references them
-void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Collada::Node* pNode, aiNode* pTarget)
+void ColladaLoader::BuildMeshesForNode( ColladaParser& pParser, const Collada::Node* pNode, aiNode* pTarget)
 {
     // accumulated mesh references by this node
     std::vector<size_t> newMeshRefs;
@@ -448,7 +503,7 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
     // add a mesh for each subgroup in each collada mesh
     for( const Collada::MeshInstance& mid : pNode->mMeshes)
     {
-        const Collada::Mesh* srcMesh = NULL;
+        Collada::Mesh* srcMesh = NULL;
         const Collada::Controller* srcController = NULL;
 
         // find the referred mesh
@@ -476,6 +531,10 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
             srcMesh = srcMeshIt->second;
         }
 
+        // the last instance of a source mesh may hand its vertex streams over to the new meshes
+        std::map<const Collada::Mesh*, size_t>::iterator countIt = mMeshInstanceCount.find( srcMesh);
+        const bool lastInstance = countIt != mMeshInstanceCount.end() && countIt->second == 1;
+
         // build a mesh for each of its subgroups
         size_t vertexStart = 0, faceStart = 0;
         for( size_t sm = 0; sm < srcMesh->mSubMeshes.size(); ++sm)
@@ -534,7 +593,7 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
             else
             {
                 // else we have to add the mesh to the collection and store its newly assigned index at the node
-                aiMesh* dstMesh = CreateMesh( pParser, srcMesh, submesh, srcController, vertexStart, faceStart);
+                aiMesh* dstMesh = CreateMesh( pParser, srcMesh, submesh, srcController, vertexStart, faceStart, lastInstance);
 
                 // store the mesh, and store its new index in the node
                 newMeshRefs.push_back( mMeshes.size());
@@ -550,6 +609,10 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
                 }
       }
         }
+
+        // release the source data after its last instance has been converted
+        if( countIt != mMeshInstanceCount.end() && --countIt->second == 0)
+            ReleaseVertexStreams( *srcMesh);
     }
 
     // now place all mesh references we gathered in the target node
@@ -561,10 +624,23 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// Returns a vertex stream's range as a new array. Takes over the whole stream instead if allowed to.
+template <typename T>
+static T* TakeOrCopyStream( Collada::VertexStream<T>& pStream, size_t pStart, size_t pCount, bool pTake)
+{
+    if( pTake)
+        return pStream.release();
+
+    T* data = new T[pCount];
+    std::copy( pStream.data() + pStart, pStream.data() + pStart + pCount, data);
+    return data;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Creates a mesh for the given ColladaMesh face subset and returns the newly created mesh
-aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::Mesh* pSrcMesh, const Collada::SubMesh& pSubMesh,
-    const Collada::Controller* pSrcController, size_t pStartVertex, size_t pStartFace)
+aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, Collada::Mesh* pSrcMesh, const Collada::SubMesh& pSubMesh,
+    const Collada::Controller* pSrcController, size_t pStartVertex, size_t pStartFace, bool pTakeStreams)
 {
     aiMesh* dstMesh = new aiMesh;
 
@@ -574,37 +650,26 @@ aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::
     const size_t numVertices = std::accumulate( pSrcMesh->mFaceSize.begin() + pStartFace,
         pSrcMesh->mFaceSize.begin() + pStartFace + pSubMesh.mNumFaces, 0);
 
+    // nobody needs the streams after us and we use all of them: adopt them instead of copying
+    const bool takeStreams = pTakeStreams && pStartVertex == 0 && numVertices == pSrcMesh->mPositions.size();
+
     // copy positions
     dstMesh->mNumVertices = numVertices;
-    dstMesh->mVertices = new aiVector3D[numVertices];
-    std::copy( pSrcMesh->mPositions.begin() + pStartVertex, pSrcMesh->mPositions.begin() +
-        pStartVertex + numVertices, dstMesh->mVertices);
+    dstMesh->mVertices = TakeOrCopyStream( pSrcMesh->mPositions, pStartVertex, numVertices, takeStreams);
 
     // normals, if given. HACK: (thom) Due to the glorious Collada spec we never
     // know if we have the same number of normals as there are positions. So we
     // also ignore any vertex attribute if it has a different count
     if( pSrcMesh->mNormals.size() >= pStartVertex + numVertices)
-    {
-        dstMesh->mNormals = new aiVector3D[numVertices];
-        std::copy( pSrcMesh->mNormals.begin() + pStartVertex, pSrcMesh->mNormals.begin() +
-            pStartVertex + numVertices, dstMesh->mNormals);
-    }
+        dstMesh->mNormals = TakeOrCopyStream( pSrcMesh->mNormals, pStartVertex, numVertices, takeStreams);
 
     // tangents, if given.
     if( pSrcMesh->mTangents.size() >= pStartVertex + numVertices)
-    {
-        dstMesh->mTangents = new aiVector3D[numVertices];
-        std::copy( pSrcMesh->mTangents.begin() + pStartVertex, pSrcMesh->mTangents.begin() +
-            pStartVertex + numVertices, dstMesh->mTangents);
-    }
+        dstMesh->mTangents = TakeOrCopyStream( pSrcMesh->mTangents, pStartVertex, numVertices, takeStreams);
 
     // bitangents, if given.
     if( pSrcMesh->mBitangents.size() >= pStartVertex + numVertices)
-    {
-        dstMesh->mBitangents = new aiVector3D[numVertices];
-        std::copy( pSrcMesh->mBitangents.begin() + pStartVertex, pSrcMesh->mBitangents.begin() +
-            pStartVertex + numVertices, dstMesh->mBitangents);
-    }
+        dstMesh->mBitangents = TakeOrCopyStream( pSrcMesh->mBitangents, pStartVertex, numVertices, takeStreams);
 
     // same for texturecoords, as many as we have
     // empty slots are not allowed, need to pack and adjust UV indexes accordingly
@@ -612,10 +677,7 @@ aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::
     {
         if( pSrcMesh->mTexCoords[a].size() >= pStartVertex + numVertices)
         {
-            dstMesh->mTextureCoords[real] = new aiVector3D[numVertices];
-            for( size_t b = 0; b < numVertices; ++b)
-                dstMesh->mTextureCoords[real][b] = pSrcMesh->mTexCoords[a][pStartVertex+b];
-
+            dstMesh->mTextureCoords[real] = TakeOrCopyStream( pSrcMesh->mTexCoords[a], pStartVertex, numVertices, takeStreams);
             dstMesh->mNumUVComponents[real] = pSrcMesh->mNumUVComponents[a];
             ++real;
         }
@@ -626,8 +688,7 @@ aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::
     {
         if( pSrcMesh->mColors[a].size() >= pStartVertex + numVertices)
         {
-            dstMesh->mColors[real] = new aiColor4D[numVertices];
-            std::copy( pSrcMesh->mColors[a].begin() + pStartVertex, pSrcMesh->mColors[a].begin() + pStartVertex + numVertices,dstMesh->mColors[real]);
+            dstMesh->mColors[real] = TakeOrCopyStream( pSrcMesh->mColors[a], pStartVertex, numVertices, takeStreams);
             ++real;
         }
     }
@@ -108,19 +108,25 @@ protected:
     void InternReadFile( const std::string& pFile, aiScene* pScene, IOSystem* pIOHandler);
 
     /** Recursively constructs a scene node for the given parser node and returns it. */
-    aiNode* BuildHierarchy( const ColladaParser& pParser, const Collada::Node* pNode);
+    aiNode* BuildHierarchy( ColladaParser& pParser, const Collada::Node* pNode);
 
     /** Resolve node instances */
     void ResolveNodeInstances( const ColladaParser& pParser, const Collada::Node* pNode,
         std::vector<const Collada::Node*>& resolved);
 
-    /** Builds meshes for the given node and references them */
-    void BuildMeshesForNode( const ColladaParser& pParser, const Collada::Node* pNode,
+    /** Counts how often each source mesh is instanced by the hierarchy below the given node */
+    void CountMeshInstances( const ColladaParser& pParser, const Collada::Node* pNode);
+
+    /** Builds meshes for the given node and references them. Frees the vertex streams
+     * of the source meshes which are not going to be instanced again. */
+    void BuildMeshesForNode( ColladaParser& pParser, const Collada::Node* pNode,
         aiNode* pTarget);
 
-    /** Creates a mesh for the given ColladaMesh face subset and returns the newly created mesh */
-    aiMesh* CreateMesh( const ColladaParser& pParser, const Collada::Mesh* pSrcMesh, const Collada::SubMesh& pSubMesh,
-        const Collada::Controller* pSrcController, size_t pStartVertex, size_t pStartFace);
+    /** Creates a mesh for the given ColladaMesh face subset and returns the newly created mesh.
+     * If pTakeStreams is set and the subset spans the whole source mesh, the new mesh adopts
+     * the vertex streams of the source mesh instead of copying them. */
+    aiMesh* CreateMesh( const ColladaParser& pParser, Collada::Mesh* pSrcMesh, const Collada::SubMesh& pSubMesh,
+        const Collada::Controller* pSrcController, size_t pStartVertex, size_t pStartFace, bool pTakeStreams);
 
     /** Builds cameras for the given node and references them */
     void BuildCamerasForNode( const ColladaParser& pParser, const Collada::Node* pNode,
@@ -218,6 +224,10 @@ protected:
     /** Which mesh-material compound was stored under which mesh ID */
     std::map<ColladaMeshIndex, size_t> mMeshIndexByID;
 
+    /** Number of not yet processed instances of each source mesh. Once it drops to zero,
+     *  the mesh's vertex streams are released to lower the peak memory usage. */
+    std::map<const Collada::Mesh*, size_t> mMeshInstanceCount;
+
     /** Which material was stored under which index in the scene */
     std::map<std::string, size_t> mMaterialIndexByName;
 
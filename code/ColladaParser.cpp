@@ -103,8 +103,16 @@ ColladaParser::ColladaParser( IOSystem* pIOHandler, const std::string& pFile)
         ThrowException("Collada: Unable to open file.");
     }
 
+    // the reader made its own copy of the file, drop the wrapper's one before parsing
+    mIOWrapper.reset();
+
     // start reading
     ReadContents();
+
+    // the reader holds a copy of the whole file, which is of no use
+    // once everything is parsed - don't keep it while the meshes are built
+    delete mReader;
+    mReader = NULL;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1936,17 +1944,22 @@ void ColladaParser::ReadDataArray()
             }
         } else
         {
-            data.mValues.reserve( count);
+            // parse into the array the accessors read from, in one batch as long as the text holds plain numbers
+            data.mValues.resize( count);
+            float* values = count ? &data.mValues[0] : NULL;
 
-            for( unsigned int a = 0; a < count; a++)
+            unsigned int parsed = count;
+            content = fast_atoreal_array<float>( content, content + ::strlen( content), values, parsed);
+            SkipSpacesAndLineEnd( &content);
+
+            // whatever the batch stopped at is read one number at a time
+            for( unsigned int a = parsed; a < count; a++)
             {
                 if( *content == 0)
                     ThrowException( "Expected more values while reading float_array contents.");
 
-                float value;
                 // read a number
-                content = fast_atoreal_move<float>( content, value);
-                data.mValues.push_back( value);
+                content = fast_atoreal_move<float>( content, values[a]);
                 // skip whitespace after it
                 SkipSpacesAndLineEnd( &content);
             }
@@ -2243,6 +2256,16 @@ void ColladaParser::ReadInputChannel( std::vector<InputChannel>& poChannels)
     SkipElement();
 }
 
+// ------------------------------------------------------------------------------------------------
+// Makes room for numVertices more entries in an array without losing its geometric growth
+template <typename Array>
+static void Reserve( Array& pArray, size_t numVertices)
+{
+    const size_t required = pArray.size() + numVertices;
+    if( pArray.capacity() < required)
+        pArray.reserve( std::max( required, pArray.capacity() * 2));
+}
+
 // ------------------------------------------------------------------------------------------------
 // Reads a <p> primitive index list and assembles the mesh data into the given mesh
 size_t ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pPerIndexChannels,
@@ -2280,12 +2303,17 @@ size_t ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pP
             break;
     }
 
-    // and read all indices into a temporary array
+    // Triangles and polylists state their index count upfront and use each vertex once, in order.
+    // Their vertices are assembled right while the <p> is parsed, the others go through an index array.
+    const bool streamed = (pPrimType == Prim_Triangles || pPrimType == Prim_Polylist)
+        && pNumPrimitives > 0 && expectedPointCount > 0;
+
+    // read all indices into a temporary array
     std::vector<size_t> indices;
-    if( expectedPointCount > 0)
+    if( !streamed && expectedPointCount > 0)
         indices.reserve( expectedPointCount * numOffsets);
 
-    if (pNumPrimitives > 0) // It is possible to not contain any indices
+    if( !streamed && pNumPrimitives > 0) // It is possible to not contain any indices
     {
         const char* content = GetTextContent();
         while( *content != 0)
@@ -2299,8 +2327,8 @@ size_t ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pP
         }
     }
 
-	// complain if the index count doesn't fit
-    if( expectedPointCount > 0 && indices.size() != expectedPointCount * numOffsets) {
+	// complain if the index count doesn't fit. Streamed lists are checked while reading
+    if( !streamed && expectedPointCount > 0 && indices.size() != expectedPointCount * numOffsets) {
         if (pPrimType == Prim_Lines) {
             // HACK: We just fix this number since SketchUp 15.3.331 writes the wrong 'count' for 'lines'
             ReportWarning( "Expected different index count in <p> element, %d instead of %d.", indices.size(), expectedPointCount * numOffsets);
@@ -2349,6 +2377,40 @@ size_t ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pP
             acc->mData = &ResolveLibraryReference( mDataLibrary, acc->mSource);
     }
 
+    if( streamed)
+    {
+        ReserveVertexStreams( pMesh, pPerIndexChannels, expectedPointCount);
+        Reserve( pMesh->mFaceSize, pNumPrimitives);
+
+        std::vector<size_t> vertexIndices( numOffsets);
+        const char* content = GetTextContent();
+        for( size_t currentPrimitive = 0; currentPrimitive < pNumPrimitives; ++currentPrimitive)
+        {
+            const size_t numPoints = pPrimType == Prim_Triangles ? 3 : pVCount[currentPrimitive];
+            for( size_t currentVertex = 0; currentVertex < numPoints; ++currentVertex)
+            {
+                for( size_t offset = 0; offset < numOffsets; ++offset)
+                {
+                    if( *content == 0)
+                        ThrowException( "Expected different index count in <p> element.");
+
+                    // Hack: (thom) Some exporters put negative indices sometimes. We just try to carry on anyways.
+                    vertexIndices[offset] = size_t( std::max( 0, strtol10( content, &content)));
+                    SkipSpacesAndLineEnd( &content);
+                }
+                CopyVertexIndices( &vertexIndices[0], perVertexOffset, pMesh, pPerIndexChannels);
+            }
+
+            // store the face size to later reconstruct the face from
+            pMesh->mFaceSize.push_back( numPoints);
+        }
+        if( *content != 0)
+            ThrowException( "Expected different index count in <p> element.");
+
+        TestClosing( "p");
+        return pNumPrimitives;
+    }
+
     // For continued primitives, the given count does not come all in one <p>, but only one primitive per <p>
     size_t numPrimitives = pNumPrimitives;
     if( pPrimType == Prim_TriFans || pPrimType == Prim_Polygon)
@@ -2359,8 +2421,14 @@ size_t ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pP
         numPrimitives = numberOfVertices - 2;
     }
 
-    pMesh->mFaceSize.reserve( numPrimitives);
-    pMesh->mFacePosIndices.reserve( indices.size() / numOffsets);
+    // determine the number of vertices this adds to the mesh, so the vertex
+    // streams can be allocated once instead of growing with each vertex
+    size_t numNewVertices = indices.size() / numOffsets;
+    if( pPrimType == Prim_TriStrips)
+        numNewVertices = numPrimitives * 3;
+
+    ReserveVertexStreams( pMesh, pPerIndexChannels, numNewVertices);
+    Reserve( pMesh->mFaceSize, numPrimitives);
 
     size_t polylistStartVertex = 0;
     for (size_t currentPrimitive = 0; currentPrimitive < numPrimitives; currentPrimitive++)
@@ -2410,6 +2478,45 @@ size_t ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pP
     return numPrimitives;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Makes room for the given number of vertices in all streams the input channels of a mesh write to
+void ColladaParser::ReserveVertexStreams( Mesh* pMesh, const std::vector<InputChannel>& pPerIndexChannels, size_t numVertices)
+{
+    Reserve( pMesh->mPositions, numVertices);
+    Reserve( pMesh->mFacePosIndices, numVertices);
+
+    for( size_t i = 0; i < 2; ++i)
+    {
+        const std::vector<InputChannel>& channels = i == 0 ? pMesh->mPerVertexData : pPerIndexChannels;
+        for( const InputChannel& channel : channels)
+        {
+            switch( channel.mType)
+            {
+                case IT_Normal:
+                    Reserve( pMesh->mNormals, numVertices);
+                    break;
+                case IT_Tangent:
+                    Reserve( pMesh->mTangents, numVertices);
+                    break;
+                case IT_Bitangent:
+                    Reserve( pMesh->mBitangents, numVertices);
+                    break;
+                case IT_Texcoord:
+                    if( channel.mIndex < AI_MAX_NUMBER_OF_TEXTURECOORDS)
+                        Reserve( pMesh->mTexCoords[channel.mIndex], numVertices);
+                    break;
+                case IT_Color:
+                    if( channel.mIndex < AI_MAX_NUMBER_OF_COLOR_SETS)
+                        Reserve( pMesh->mColors[channel.mIndex], numVertices);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
 void ColladaParser::CopyVertex(size_t currentVertex, size_t numOffsets, size_t numPoints, size_t perVertexOffset, Mesh* pMesh, std::vector<InputChannel>& pPerIndexChannels, size_t currentPrimitive, const std::vector<size_t>& indices){
     // calculate the base offset of the vertex whose attributes we ant to copy
     size_t baseOffset = currentPrimitive * numOffsets * numPoints + currentVertex * numOffsets;
@@ -2418,15 +2525,21 @@ void ColladaParser::CopyVertex(size_t currentVertex, size_t numOffsets, size_t n
     size_t maxIndexRequested = baseOffset + numOffsets - 1;
     ai_assert(maxIndexRequested < indices.size());
 
+    CopyVertexIndices(&indices[baseOffset], perVertexOffset, pMesh, pPerIndexChannels);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Copies the data for a single vertex into the mesh, given the vertex's indices for all offsets
+void ColladaParser::CopyVertexIndices(const size_t* pIndices, size_t perVertexOffset, Mesh* pMesh, std::vector<InputChannel>& pPerIndexChannels){
     // extract per-vertex channels using the global per-vertex offset
     for (std::vector<InputChannel>::iterator it = pMesh->mPerVertexData.begin(); it != pMesh->mPerVertexData.end(); ++it)
-        ExtractDataObjectFromChannel(*it, indices[baseOffset + perVertexOffset], pMesh);
+        ExtractDataObjectFromChannel(*it, pIndices[perVertexOffset], pMesh);
     // and extract per-index channels using there specified offset
     for (std::vector<InputChannel>::iterator it = pPerIndexChannels.begin(); it != pPerIndexChannels.end(); ++it)
-        ExtractDataObjectFromChannel(*it, indices[baseOffset + it->mOffset], pMesh);
+        ExtractDataObjectFromChannel(*it, pIndices[it->mOffset], pMesh);
 
     // store the vertex-data index for later assignment of bone vertex weights
-    pMesh->mFacePosIndices.push_back(indices[baseOffset + perVertexOffset]);
+    pMesh->mFacePosIndices.push_back(pIndices[perVertexOffset]);
 }
 
 void ColladaParser::ReadPrimTriStrips(size_t numOffsets, size_t perVertexOffset, Mesh* pMesh, std::vector<InputChannel>& pPerIndexChannels, size_t currentPrimitive, const std::vector<size_t>& indices){
@@ -2476,7 +2589,7 @@ void ColladaParser::ExtractDataObjectFromChannel( const InputChannel& pInput, si
         case IT_Normal:
             // pad to current vertex count if necessary
             if( pMesh->mNormals.size() < pMesh->mPositions.size()-1)
-                pMesh->mNormals.insert( pMesh->mNormals.end(), pMesh->mPositions.size() - pMesh->mNormals.size() - 1, aiVector3D( 0, 1, 0));
+                pMesh->mNormals.resize( pMesh->mPositions.size() - 1, aiVector3D( 0, 1, 0));
 
             // ignore all normal streams except 0 - there can be only one normal
             if( pInput.mIndex == 0)
@@ -2487,7 +2600,7 @@ void ColladaParser::ExtractDataObjectFromChannel( const InputChannel& pInput, si
         case IT_Tangent:
             // pad to current vertex count if necessary
             if( pMesh->mTangents.size() < pMesh->mPositions.size()-1)
-                pMesh->mTangents.insert( pMesh->mTangents.end(), pMesh->mPositions.size() - pMesh->mTangents.size() - 1, aiVector3D( 1, 0, 0));
+                pMesh->mTangents.resize( pMesh->mPositions.size() - 1, aiVector3D( 1, 0, 0));
 
             // ignore all tangent streams except 0 - there can be only one tangent
             if( pInput.mIndex == 0)
@@ -2498,7 +2611,7 @@ void ColladaParser::ExtractDataObjectFromChannel( const InputChannel& pInput, si
         case IT_Bitangent:
             // pad to current vertex count if necessary
             if( pMesh->mBitangents.size() < pMesh->mPositions.size()-1)
-                pMesh->mBitangents.insert( pMesh->mBitangents.end(), pMesh->mPositions.size() - pMesh->mBitangents.size() - 1, aiVector3D( 0, 0, 1));
+                pMesh->mBitangents.resize( pMesh->mPositions.size() - 1, aiVector3D( 0, 0, 1));
 
             // ignore all bitangent streams except 0 - there can be only one bitangent
             if( pInput.mIndex == 0)
@@ -2512,8 +2625,7 @@ void ColladaParser::ExtractDataObjectFromChannel( const InputChannel& pInput, si
             {
                 // pad to current vertex count if necessary
                 if( pMesh->mTexCoords[pInput.mIndex].size() < pMesh->mPositions.size()-1)
-                    pMesh->mTexCoords[pInput.mIndex].insert( pMesh->mTexCoords[pInput.mIndex].end(),
-                        pMesh->mPositions.size() - pMesh->mTexCoords[pInput.mIndex].size() - 1, aiVector3D( 0, 0, 0));
+                    pMesh->mTexCoords[pInput.mIndex].resize( pMesh->mPositions.size() - 1, aiVector3D( 0, 0, 0));
 
                 pMesh->mTexCoords[pInput.mIndex].push_back( aiVector3D( obj[0], obj[1], obj[2]));
                 if (0 != acc.mSubOffset[2] || 0 != acc.mSubOffset[3]) /* hack ... consider cleaner solution */
@@ -2529,8 +2641,7 @@ void ColladaParser::ExtractDataObjectFromChannel( const InputChannel& pInput, si
             {
                 // pad to current vertex count if necessary
                 if( pMesh->mColors[pInput.mIndex].size() < pMesh->mPositions.size()-1)
-                    pMesh->mColors[pInput.mIndex].insert( pMesh->mColors[pInput.mIndex].end(),
-                        pMesh->mPositions.size() - pMesh->mColors[pInput.mIndex].size() - 1, aiColor4D( 0, 0, 0, 1));
+                    pMesh->mColors[pInput.mIndex].resize( pMesh->mPositions.size() - 1, aiColor4D( 0, 0, 0, 1));
 
                 aiColor4D result(0, 0, 0, 1);
                 for (size_t i = 0; i < pInput.mResolved->mSize; ++i)
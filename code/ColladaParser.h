@@ -189,11 +189,19 @@ namespace Assimp
         size_t ReadPrimitives( Collada::Mesh* pMesh, std::vector<Collada::InputChannel>& pPerIndexChannels,
                               size_t pNumPrimitives, const std::vector<size_t>& pVCount, Collada::PrimitiveType pPrimType);
 
+        /** Preallocates the mesh data arrays the given input channels write to for numVertices more vertices */
+        void ReserveVertexStreams( Collada::Mesh* pMesh, const std::vector<Collada::InputChannel>& pPerIndexChannels,
+                                   size_t numVertices);
+
         /** Copies the data for a single primitive into the mesh, based on the InputChannels */
         void CopyVertex(size_t currentVertex, size_t numOffsets, size_t numPoints, size_t perVertexOffset,
                         Collada::Mesh* pMesh, std::vector<Collada::InputChannel>& pPerIndexChannels,
                         size_t currentPrimitive, const std::vector<size_t>& indices);
 
+        /** Copies the data for a single vertex into the mesh, given the vertex's indices for all offsets */
+        void CopyVertexIndices(const size_t* pIndices, size_t perVertexOffset, Collada::Mesh* pMesh,
+                               std::vector<Collada::InputChannel>& pPerIndexChannels);
+
         /** Reads one triangle of a tristrip into the mesh */
         void ReadPrimTriStrips(size_t numOffsets, size_t perVertexOffset, Collada::Mesh* pMesh,
                                std::vector<Collada::InputChannel>& pPerIndexChannels, size_t currentPrimitive, const std::vector<size_t>& indices);
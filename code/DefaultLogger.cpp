@@ -61,6 +61,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #   include <mutex>
 
 std::mutex loggerMutex;
+std::mutex loggerStreamMutex;
 #endif
 
 namespace Assimp    {
@@ -379,6 +380,11 @@ void DefaultLogger::WriteToStreams(const char *message, ErrorSeverity ErrorSev )
 {
     ai_assert(NULL != message);
 
+    // post processing steps may log from several threads at once
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    std::lock_guard<std::mutex> lock(loggerStreamMutex);
+#endif
+
     // Check whether this is a repeated message
     if (! ::strncmp( message,lastMsg, lastLen-1))
     {
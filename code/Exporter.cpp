@@ -91,6 +91,7 @@ void ExportSceneGLTF(const char*, IOSystem*, const aiScene*, const ExportPropert
 void ExportSceneGLB(const char*, IOSystem*, const aiScene*, const ExportProperties*);
 void ExportSceneAssbin(const char*, IOSystem*, const aiScene*, const ExportProperties*);
 void ExportSceneAssxml(const char*, IOSystem*, const aiScene*, const ExportProperties*);
+void ExportSceneN3PMesh(const char*, IOSystem*, const aiScene*, const ExportProperties*);
 
 // ------------------------------------------------------------------------------------------------
 // global array of all export formats which Assimp supports in its current build
@@ -151,6 +152,11 @@ Exporter::ExportFormatEntry gExporters[] =
 #ifndef ASSIMP_BUILD_NO_ASSXML_EXPORTER
     Exporter::ExportFormatEntry( "assxml", "Assxml Document", "assxml" , &ExportSceneAssxml, 0),
 #endif
+
+#ifndef ASSIMP_BUILD_NO_N3PMESH_EXPORTER
+    Exporter::ExportFormatEntry( "n3pmesh", "Knight Online N3PMesh (static)", "n3pmesh", &ExportSceneN3PMesh,
+        aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_GenNormals),
+#endif
 };
 
 #define ASSIMP_NUM_EXPORTERS (sizeof(gExporters)/sizeof(gExporters[0]))
@@ -198,6 +204,48 @@ public:
 };
 
 
+// ------------------------------------------------------------------------------------------------
+// Parts of the scene the post processing steps in pp modify, see the AI_INT_SCENE_PART flags.
+// Export only copies those and shares the rest with the caller's scene, so any step missing here
+// must be assumed to modify everything.
+static unsigned int GetModifiedSceneParts(unsigned int pp)
+{
+    static const struct {
+        unsigned int steps;
+        unsigned int parts;
+    } stepParts[] = {
+        { aiProcess_ValidateDataStructure, 0 },
+        { aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices | aiProcess_Triangulate
+            | aiProcess_GenNormals | aiProcess_GenSmoothNormals | aiProcess_ImproveCacheLocality
+            | aiProcess_FixInfacingNormals | aiProcess_LimitBoneWeights | aiProcess_FindDegenerates
+            | aiProcess_FlipWindingOrder,
+          AI_INT_SCENE_PART_MESHES },
+        { aiProcess_SortByPType | aiProcess_SplitLargeMeshes | aiProcess_OptimizeMeshes,
+          AI_INT_SCENE_PART_MESHES | AI_INT_SCENE_PART_NODES },
+        { aiProcess_FlipUVs | aiProcess_GenUVCoords | aiProcess_TransformUVCoords | aiProcess_RemoveRedundantMaterials,
+          AI_INT_SCENE_PART_MESHES | AI_INT_SCENE_PART_MATERIALS },
+    };
+
+    unsigned int parts = 0, known = 0;
+    for (size_t i = 0; i < sizeof(stepParts) / sizeof(stepParts[0]); ++i) {
+        if (pp & stepParts[i].steps) {
+            parts |= stepParts[i].parts;
+        }
+        known |= stepParts[i].steps;
+    }
+    return (pp & ~known) ? AI_INT_SCENE_PART_ALL : parts;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Deletes the working copy of a scene that is exported, see SceneCombiner::CopySceneParts()
+struct ExportSceneDeleter {
+    unsigned int mParts;
+
+    void operator () (aiScene* scene) const {
+        SceneCombiner::FreeSceneParts(scene, mParts);
+    }
+};
+
 } // end of namespace Assimp
 
 
@@ -319,12 +367,6 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
 
             try {
 
-                // Always create a full copy of the scene. We might optimize this one day,
-                // but for now it is the most pragmatic way.
-                aiScene* scenecopy_tmp;
-                SceneCombiner::CopyScene(&scenecopy_tmp,pScene);
-
-                std::unique_ptr<aiScene> scenecopy(scenecopy_tmp);
                 const ScenePrivateData* const priv = ScenePriv(pScene);
 
                 // steps that are not idempotent, i.e. we might need to run them again, usually to get back to the
@@ -346,7 +388,7 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
 
                 // If the input scene is not in verbose format, but there is at least postprocessing step that relies on it,
                 // we need to run the MakeVerboseFormat step first.
-                bool must_join_again = false;
+                bool make_verbose = false;
                 if (!is_verbose_format) {
 
                     bool verbosify = false;
@@ -358,16 +400,33 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
                             break;
                         }
                     }
+                    make_verbose = verbosify || (exp.mEnforcePP & aiProcess_JoinIdenticalVertices);
+                }
 
-                    if (verbosify || (exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
-                        DefaultLogger::get()->debug("export: Scene data not in verbose format, applying MakeVerboseFormat step first");
+                // Only copy what the steps are going to modify, and nothing at all if no step runs.
+                // MakeVerboseFormat and JoinIdenticalVertices, which may run on their own, touch the meshes only.
+                std::unique_ptr<aiScene, ExportSceneDeleter> scenecopy(NULL, ExportSceneDeleter{ 0 });
+                if (pp || make_verbose) {
+                    const unsigned int parts = GetModifiedSceneParts(pp) | (make_verbose ? AI_INT_SCENE_PART_MESHES : 0);
 
-                        MakeVerboseFormatProcess proc;
-                        proc.Execute(scenecopy.get());
+                    aiScene* scenecopy_tmp;
+                    SceneCombiner::CopySceneParts(&scenecopy_tmp,pScene,parts);
+                    scenecopy.get_deleter().mParts = parts;
+                    scenecopy.reset(scenecopy_tmp);
+                }
+                else {
+                    DefaultLogger::get()->debug("export: No post processing to apply, exporting the scene as-is");
+                }
 
-                        if(!(exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
-                            must_join_again = true;
-                        }
+                bool must_join_again = false;
+                if (make_verbose) {
+                    DefaultLogger::get()->debug("export: Scene data not in verbose format, applying MakeVerboseFormat step first");
+
+                    MakeVerboseFormatProcess proc;
+                    proc.Execute(scenecopy.get());
+
+                    if(!(exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
+                        must_join_again = true;
                     }
                 }
 
@@ -418,7 +477,7 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
                 }
 
                 ExportProperties emptyProperties;  // Never pass NULL ExportProperties so Exporters don't have to worry.
-                exp.mExportFunction(pPath,pimpl->mIOSystem.get(),scenecopy.get(), pProperties ? pProperties : &emptyProperties);
+                exp.mExportFunction(pPath,pimpl->mIOSystem.get(),scenecopy ? scenecopy.get() : pScene, pProperties ? pProperties : &emptyProperties);
             }
             catch (DeadlyExportError& err) {
                 pimpl->mError = err.what();
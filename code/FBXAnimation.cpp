@@ -109,6 +109,8 @@ AnimationCurveNode::AnimationCurveNode(uint64_t id, const Element& element, cons
     const char* whitelist[] = {"Model","NodeAttribute"};
     const std::vector<const Connection*>& conns = doc.GetConnectionsBySourceSequenced(ID(),whitelist,2);
 
+    bool skipped = false;
+
     for(const Connection* con : conns) {
 
         // link should go for a property
@@ -131,6 +133,12 @@ AnimationCurveNode::AnimationCurveNode(uint64_t id, const Element& element, cons
             }
         }
 
+        // don't construct models that are not imported
+        if (!doc.IsModelRequired(con->dest) && con->LazyDestinationObject().GetElement().KeyToken().View() == "Model") {
+            skipped = true;
+            continue;
+        }
+
         const Object* const ob = con->DestinationObject();
         if(!ob) {
             DOMWarning("failed to read destination object for AnimationCurveNode->Model link, ignoring",&element);
@@ -148,7 +156,7 @@ AnimationCurveNode::AnimationCurveNode(uint64_t id, const Element& element, cons
         break;
     }
 
-    if(!target) {
+    if(!target && !skipped) {
         DOMWarning("failed to resolve target Model/NodeAttribute/Constraint for AnimationCurveNode",&element);
     }
 
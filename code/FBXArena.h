@@ -0,0 +1,222 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  FBXArena.h
+ *  @brief Bump allocator holding the tokens and the DOM of one FBX file
+ */
+#ifndef INCLUDED_AI_FBX_ARENA_H
+#define INCLUDED_AI_FBX_ARENA_H
+
+#include <assimp/ai_assert.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Assimp {
+namespace FBX {
+
+/** Bump allocator for the many small objects making up an FBX document.
+ *
+ *  Memory is handed out from large blocks and never returned individually;
+ *  everything is released at once when the arena is destroyed. Objects with
+ *  non-trivial destructors created through #New are destroyed at that time,
+ *  in reverse order of creation. The arena is not thread-safe. */
+class Arena
+{
+public:
+
+    explicit Arena(size_t blockSize = 64 * 1024)
+    : blockSize(blockSize)
+    , cursor()
+    , blockEnd()
+    {}
+
+    ~Arena() {
+        for (size_t i = destructors.size(); i > 0; --i) {
+            destructors[i - 1].first(destructors[i - 1].second);
+        }
+    }
+
+public:
+
+    /** Get size bytes of uninitialized memory aligned for any scalar type */
+    void* Allocate(size_t size) {
+        static const size_t align = alignof(std::max_align_t);
+        size = (size + align - 1) & ~(align - 1);
+
+        if (static_cast<size_t>(blockEnd - cursor) < size) {
+            // large requests get a block of their own so the current block isn't wasted
+            if (size > blockSize / 4) {
+                blocks.push_back(std::unique_ptr<char[]>(new char[size]));
+                return blocks.back().get();
+            }
+            blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+            cursor = blocks.back().get();
+            blockEnd = cursor + blockSize;
+        }
+
+        char* const p = cursor;
+        cursor += size;
+        return p;
+    }
+
+    /** Construct an object in the arena */
+    template <typename T, typename... Args>
+    T* New(Args&&... args) {
+        void* const p = Allocate(sizeof(T));
+        if (std::is_trivially_destructible<T>::value) {
+            return new (p) T(std::forward<Args>(args)...);
+        }
+
+        // make room for the destructor first so the object can't leak if that throws.
+        // The constructor may create further objects, so the entry has to be found again.
+        destructors.push_back(std::make_pair(&Destroy<T>, static_cast<void*>(NULL)));
+        const size_t entry = destructors.size() - 1;
+        T* t;
+        try {
+            t = new (p) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            destructors[entry].first = &DestroyNothing;
+            throw;
+        }
+        destructors[entry].second = t;
+        return t;
+    }
+
+private:
+
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    template <typename T>
+    static void Destroy(void* p) {
+        static_cast<T*>(p)->~T();
+    }
+
+    static void DestroyNothing(void*) {
+    }
+
+private:
+
+    const size_t blockSize;
+    char* cursor;
+    char* blockEnd;
+
+    std::vector< std::unique_ptr<char[]> > blocks;
+    std::vector< std::pair<void (*)(void*), void*> > destructors;
+};
+
+
+/** STL allocator drawing from an #Arena. deallocate() is a no-op, so it
+ *  suits containers that are filled once and released with the arena. */
+template <typename T>
+class ArenaAllocator
+{
+public:
+
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+
+    explicit ArenaAllocator(Arena& arena)
+    : arena(&arena)
+    {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+    : arena(other.arena)
+    {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T*, size_t) {
+        // memory is released together with the arena
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* p) {
+        p->~U();
+    }
+
+    size_t max_size() const {
+        return static_cast<size_t>(-1) / sizeof(T);
+    }
+
+    template <typename U>
+    bool operator == (const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator != (const ArenaAllocator<U>& other) const {
+        return arena != other.arena;
+    }
+
+private:
+
+    template <typename U> friend class ArenaAllocator;
+
+    Arena* arena;
+};
+
+} // ! FBX
+} // ! Assimp
+
+#endif // ! INCLUDED_AI_FBX_ARENA_H
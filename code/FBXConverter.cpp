@@ -458,6 +458,11 @@ Converter::Converter( aiScene* out, const Document& doc )
         // unfortunately this means we have to evaluate all objects
         for( const ObjectMap::value_type& v : doc.Objects() ) {
 
+            // don't construct geometry or models just to find out they aren't materials
+            if ( v.second->GetElement().KeyToken().View() != "Material" ) {
+                continue;
+            }
+
             const Object* ob = v.second->Get();
             if ( !ob ) {
                 continue;
@@ -521,6 +526,11 @@ void Converter::ConvertNodes( uint64_t id, aiNode& parent, const aiMatrix4x4& pa
                 continue;
             }
 
+            // don't even construct models outside the subtrees selected for import
+            if ( !doc.IsModelRequired( con->src ) ) {
+                continue;
+            }
+
             const Object* const object = con->SourceObject();
             if ( !object ) {
                 FBXImporter::LogWarn( "failed to convert source object for Model link" );
@@ -581,17 +591,22 @@ void Converter::ConvertNodes( uint64_t id, aiNode& parent, const aiMatrix4x4& pa
                     new_abs_transform *= prenode->mTransformation;
                 }
 
+                // parents of selected models are kept as empty nodes
+                const bool selected = doc.IsModelSelected( model->ID() );
+
                 // attach geometry
-                ConvertModel( *model, *nodes_chain.back(), new_abs_transform );
+                if ( selected ) {
+                    ConvertModel( *model, *nodes_chain.back(), new_abs_transform );
+                }
 
                 // attach sub-nodes
                 ConvertNodes( model->ID(), *nodes_chain.back(), new_abs_transform );
 
-                if ( doc.Settings().readLights ) {
+                if ( selected && doc.Settings().readLights ) {
                     ConvertLights( *model );
                 }
 
-                if ( doc.Settings().readCameras ) {
+                if ( selected && doc.Settings().readCameras ) {
                     ConvertCameras( *model );
                 }
 
@@ -53,6 +53,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXDocumentUtil.h"
 #include "FBXProperties.h"
 
+#include <algorithm>
 #include <memory>
 #include <functional>
 
@@ -85,26 +86,10 @@ static void dumpObjectClassInfo( const char* obtype, const std::string &classtag
 }
 
 // ------------------------------------------------------------------------------------------------
-const Object* LazyObject::Get(bool dieOnError)
+// read the name of an object without constructing it
+static std::string ParseObjectName(const Element& element)
 {
-    if(IsBeingConstructed() || FailedToConstruct()) {
-        return NULL;
-    }
-
-    if (object.get()) {
-        return object.get();
-    }
-
-    // if this is the root object, we return a dummy since there
-    // is no root object int he fbx file - it is just referenced
-    // with id 0.
-    if(id == 0L) {
-        object.reset(new Object(id, element, "Model::RootNode"));
-        return object.get();
-    }
-
-    const Token& key = element.KeyToken();
-    const TokenList& tokens = element.Tokens();
+    const ElementTokenList& tokens = element.Tokens();
 
     if(tokens.size() < 3) {
         DOMError("expected at least 3 tokens: id, name and class tag",&element);
@@ -128,7 +113,34 @@ const Object* LazyObject::Get(bool dieOnError)
             }
         }
     }
+    return name;
+}
+
+// ------------------------------------------------------------------------------------------------
+const Object* LazyObject::Get(bool dieOnError)
+{
+    if(IsBeingConstructed() || FailedToConstruct()) {
+        return NULL;
+    }
+
+    if (object.get()) {
+        return object.get();
+    }
+
+    // if this is the root object, we return a dummy since there
+    // is no root object int he fbx file - it is just referenced
+    // with id 0.
+    if(id == 0L) {
+        object.reset(new Object(id, element, "Model::RootNode"));
+        return object.get();
+    }
+
+    const Token& key = element.KeyToken();
+    const ElementTokenList& tokens = element.Tokens();
+
+    const std::string name = ParseObjectName(element);
 
+    const char* err;
     const std::string classtag = ParseTokenAsString(*tokens[2],err);
     if (err) {
         DOMError(err,&element);
@@ -267,6 +279,7 @@ FileGlobalSettings::~FileGlobalSettings()
 Document::Document(const Parser& parser, const ImportSettings& settings)
 : settings(settings)
 , parser(parser)
+, selectAllModels(true)
 {
     // Cannot use array default initialization syntax because vc8 fails on it
     for (auto &timeStamp : creationTimeStamp) {
@@ -283,6 +296,8 @@ Document::Document(const Parser& parser, const ImportSettings& settings)
     // though, since this may require valid connections.
     ReadObjects();
     ReadConnections();
+
+    SelectModels();
 }
 
 
@@ -293,8 +308,8 @@ Document::~Document()
         delete v.second;
     }
 
-    for(ConnectionMap::value_type& v : src_connections) {
-        delete v.second;
+    for(const Connection* c : src_connections.Connections()) {
+        delete c;
     }
     // |dest_connections| contain the same Connection objects as the |src_connections|
 }
@@ -384,13 +399,13 @@ void Document::ReadObjects()
 
     // add a dummy entry to represent the Model::RootNode object (id 0),
     // which is only indirectly defined in the input file
-    objects[0] = new LazyObject(0L, *eobjects, *this);
+    objects.push_back(ObjectMap::value_type(0L, new LazyObject(0L, *eobjects, *this)));
 
     const Scope& sobjects = *eobjects->Compound();
     for(const ElementMap::value_type& el : sobjects.Elements()) {
 
         // extract ID
-        const TokenList& tok = el.second->Tokens();
+        const ElementTokenList& tok = el.second->Tokens();
 
         if (tok.empty()) {
             DOMError("expected ID after object key",el.second);
@@ -408,17 +423,30 @@ void Document::ReadObjects()
             DOMError("encountered object with implicitly defined id 0",el.second);
         }
 
-        if(objects.find(id) != objects.end()) {
-            DOMWarning("encountered duplicate object id, ignoring first occurrence",el.second);
-        }
-
-        objects[id] = new LazyObject(id, *el.second, *this);
+        objects.push_back(ObjectMap::value_type(id, new LazyObject(id, *el.second, *this)));
 
         // grab all animation stacks upfront since there is no listing of them
-        if(!strcmp(el.first.c_str(),"AnimationStack")) {
+        if(el.first == "AnimationStack") {
             animationStacks.push_back(id);
         }
     }
+
+    // sort by id for GetObject(), the stable sort keeps duplicates in file order
+    std::stable_sort(objects.begin(), objects.end(),
+        [](const ObjectMap::value_type& a, const ObjectMap::value_type& b) {
+            return a.first < b.first;
+        });
+
+    ObjectMap::iterator out = objects.begin();
+    for(ObjectMap::iterator it = objects.begin(); it != objects.end(); ++it) {
+        if(it + 1 != objects.end() && (it + 1)->first == it->first) {
+            DOMWarning("encountered duplicate object id, ignoring first occurrence",&(it + 1)->second->GetElement());
+            delete it->second;
+            continue;
+        }
+        *out++ = *it;
+    }
+    objects.erase(out, objects.end());
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -442,7 +470,7 @@ void Document::ReadPropertyTemplates()
             continue;
         }
 
-        const TokenList& tok = el.Tokens();
+        const ElementTokenList& tok = el.Tokens();
         if(tok.empty()) {
             DOMWarning("expected name for ObjectType element, ignoring",&el);
             continue;
@@ -459,7 +487,7 @@ void Document::ReadPropertyTemplates()
                 continue;
             }
 
-            const TokenList& tok = el.Tokens();
+            const ElementTokenList& tok = el.Tokens();
             if(tok.empty()) {
                 DOMWarning("expected name for PropertyTemplate element, ignoring",&el);
                 continue;
@@ -492,6 +520,7 @@ void Document::ReadConnections()
     }
 
     uint64_t insertionOrder = 0l;
+    std::vector<const Connection*> connections;
 
     const Scope& sconns = *econns->Compound();
     const ElementCollection conns = sconns.GetCollection("C");
@@ -510,21 +539,93 @@ void Document::ReadConnections()
         // OP = object-property connection, in which case the destination property follows the object ID
         const std::string& prop = (type == "OP" ? ParseTokenAsString(GetRequiredToken(el,3)) : "");
 
-        if(objects.find(src) == objects.end()) {
+        if(!GetObject(src)) {
             DOMWarning("source object for connection does not exist",&el);
             continue;
         }
 
         // dest may be 0 (root node) but we added a dummy object before
-        if(objects.find(dest) == objects.end()) {
+        if(!GetObject(dest)) {
             DOMWarning("destination object for connection does not exist",&el);
             continue;
         }
 
         // add new connection
-        const Connection* const c = new Connection(insertionOrder++,src,dest,prop,*this);
-        src_connections.insert(ConnectionMap::value_type(src,c));
-        dest_connections.insert(ConnectionMap::value_type(dest,c));
+        connections.push_back(new Connection(insertionOrder++,src,dest,prop,*this));
+    }
+
+    src_connections.Build(connections, true);
+    dest_connections.Build(connections, false);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void Document::SelectModels()
+{
+    if(settings.selectedNodes.empty()) {
+        return;
+    }
+    selectAllModels = false;
+
+    const std::set<std::string> names(settings.selectedNodes.begin(), settings.selectedNodes.end());
+
+    // find the models by name, this only looks at their tokens
+    std::vector<uint64_t> pending;
+    for(const ObjectMap::value_type& v : objects) {
+        if(!v.first || v.second->GetElement().KeyToken().View() != "Model") {
+            continue;
+        }
+
+        std::string name = ParseObjectName(v.second->GetElement());
+        if (name.substr(0, 7) == "Model::") {
+            name = name.substr(7);
+        }
+
+        if(names.find(name) != names.end()) {
+            pending.push_back(v.first);
+        }
+    }
+
+    if(pending.empty()) {
+        DOMWarning("none of the nodes selected for import exist, importing nothing");
+        return;
+    }
+
+    // everything below a selected model is selected as well
+    while(!pending.empty()) {
+        const uint64_t id = pending.back();
+        pending.pop_back();
+
+        if(!selectedModels.insert(id).second) {
+            continue;
+        }
+
+        for(const Connection* con : ConnectionsByDestination().Get(id)) {
+            if(!con->PropertyName().length() && con->LazySourceObject().GetElement().KeyToken().View() == "Model") {
+                pending.push_back(con->src);
+            }
+        }
+    }
+
+    // and everything above is needed to place it in the scene
+    for(uint64_t selected : selectedModels) {
+        pending.push_back(selected);
+    }
+
+    while(!pending.empty()) {
+        const uint64_t id = pending.back();
+        pending.pop_back();
+
+        for(const Connection* con : ConnectionsBySource().Get(id)) {
+            if(con->PropertyName().length() || !con->dest || selectedModels.count(con->dest)) {
+                continue;
+            }
+
+            if(con->LazyDestinationObject().GetElement().KeyToken().View() == "Model" &&
+                requiredModels.insert(con->dest).second) {
+                pending.push_back(con->dest);
+            }
+        }
     }
 }
 
@@ -554,35 +655,51 @@ const std::vector<const AnimationStack*>& Document::AnimationStacks() const
 // ------------------------------------------------------------------------------------------------
 LazyObject* Document::GetObject(uint64_t id) const
 {
-    ObjectMap::const_iterator it = objects.find(id);
-    return it == objects.end() ? NULL : (*it).second;
+    ObjectMap::const_iterator it = std::lower_bound(objects.begin(), objects.end(), id,
+        [](const ObjectMap::value_type& v, uint64_t id) {
+            return v.first < id;
+        });
+    return it == objects.end() || (*it).first != id ? NULL : (*it).second;
 }
 
 #define MAX_CLASSNAMES 6
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsSequenced(uint64_t id,
-    const ConnectionMap& conns) const
+void ConnectionIndex::Build(const std::vector<const Connection*>& conns, bool by_source)
 {
-    std::vector<const Connection*> temp;
+    connections = conns;
 
-    const std::pair<ConnectionMap::const_iterator,ConnectionMap::const_iterator> range =
-        conns.equal_range(id);
+    // connections come in insertion order, so a stable sort by id is all it takes
+    std::stable_sort(connections.begin(), connections.end(),
+        [by_source](const Connection* a, const Connection* b) {
+            return by_source ? a->src < b->src : a->dest < b->dest;
+        });
 
-    temp.reserve(std::distance(range.first,range.second));
-    for (ConnectionMap::const_iterator it = range.first; it != range.second; ++it) {
-        temp.push_back((*it).second);
+    keys.resize(connections.size());
+    for (size_t i = 0; i < connections.size(); ++i) {
+        keys[i] = by_source ? connections[i]->src : connections[i]->dest;
     }
+}
 
-    std::sort(temp.begin(), temp.end(), std::mem_fun(&Connection::Compare));
 
-    return temp; // NRVO should handle this
+// ------------------------------------------------------------------------------------------------
+ConnectionList ConnectionIndex::Get(uint64_t id) const
+{
+    const std::pair<std::vector<uint64_t>::const_iterator, std::vector<uint64_t>::const_iterator> range =
+        std::equal_range(keys.begin(), keys.end(), id);
+
+    if (range.first == range.second) {
+        return ConnectionList();
+    }
+
+    const Connection* const* const base = &connections[0];
+    return ConnectionList(base + (range.first - keys.begin()), base + (range.second - keys.begin()));
 }
 
 
 // ------------------------------------------------------------------------------------------------
 std::vector<const Connection*> Document::GetConnectionsSequenced(uint64_t id, bool is_src,
-    const ConnectionMap& conns,
+    const ConnectionIndex& conns,
     const char* const* classnames,
     size_t count) const
 
@@ -599,14 +716,13 @@ std::vector<const Connection*> Document::GetConnectionsSequenced(uint64_t id, bo
 
     std::vector<const Connection*> temp;
 
-    const std::pair<ConnectionMap::const_iterator,ConnectionMap::const_iterator> range =
-        conns.equal_range(id);
+    const ConnectionList range = conns.Get(id);
 
-    temp.reserve(std::distance(range.first,range.second));
-    for (ConnectionMap::const_iterator it = range.first; it != range.second; ++it) {
+    temp.reserve(range.size());
+    for (const Connection* con : range) {
         const Token& key = (is_src
-            ? (*it).second->LazyDestinationObject()
-            : (*it).second->LazySourceObject()
+            ? con->LazyDestinationObject()
+            : con->LazySourceObject()
         ).GetElement().KeyToken();
 
         const char* obtype = key.begin();
@@ -623,18 +739,18 @@ std::vector<const Connection*> Document::GetConnectionsSequenced(uint64_t id, bo
             continue;
         }
 
-        temp.push_back((*it).second);
+        temp.push_back(con);
     }
 
-    std::sort(temp.begin(), temp.end(), std::mem_fun(&Connection::Compare));
+    // the range is already in insertion order
     return temp; // NRVO should handle this
 }
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsBySourceSequenced(uint64_t source) const
+ConnectionList Document::GetConnectionsBySourceSequenced(uint64_t source) const
 {
-    return GetConnectionsSequenced(source, ConnectionsBySource());
+    return ConnectionsBySource().Get(source);
 }
 
 
@@ -667,9 +783,9 @@ std::vector<const Connection*> Document::GetConnectionsByDestinationSequenced(ui
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsByDestinationSequenced(uint64_t dest) const
+ConnectionList Document::GetConnectionsByDestinationSequenced(uint64_t dest) const
 {
-    return GetConnectionsSequenced(dest, ConnectionsByDestination());
+    return ConnectionsByDestination().Get(dest);
 }
 
 
@@ -692,9 +808,9 @@ Connection::Connection(uint64_t insertionOrder,  uint64_t src, uint64_t dest, co
 , dest(dest)
 , doc(doc)
 {
-    ai_assert(doc.Objects().find(src) != doc.Objects().end());
+    ai_assert(doc.GetObject(src));
     // dest may be 0 (root node)
-    ai_assert(!dest || doc.Objects().find(dest) != doc.Objects().end());
+    ai_assert(!dest || doc.GetObject(dest));
 }
 
 
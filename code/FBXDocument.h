@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INCLUDED_AI_FBX_DOCUMENT_H
 
 #include <numeric>
+#include <set>
 #include <stdint.h>
 #include <assimp/mesh.h>
 #include "FBXProperties.h"
@@ -1001,11 +1002,76 @@ public:
 // during their entire lifetime (Document). FBX files have
 // up to many thousands of objects (most of which we never use),
 // so the memory overhead for them should be kept at a minimum.
-typedef std::map<uint64_t, LazyObject*> ObjectMap;
+// The list is sorted by id once all objects are read, use
+// Document::GetObject() to look up an id.
+typedef std::vector< std::pair<uint64_t, LazyObject*> > ObjectMap;
 typedef std::fbx_unordered_map<std::string, std::shared_ptr<const PropertyTable> > PropertyTemplateMap;
 
 
-typedef std::multimap<uint64_t, const Connection*> ConnectionMap;
+/** Non-owning view of a contiguous range of connections, ordered by
+ *  insertion order. Stays valid as long as the Document does. */
+class ConnectionList
+{
+public:
+    typedef const Connection* const* const_iterator;
+
+    ConnectionList()
+        : first()
+        , last()
+    {}
+
+    ConnectionList(const_iterator first, const_iterator last)
+        : first(first)
+        , last(last)
+    {}
+
+    const_iterator begin() const {
+        return first;
+    }
+
+    const_iterator end() const {
+        return last;
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(last - first);
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+
+    const Connection* operator[] (size_t index) const {
+        ai_assert(index < size());
+        return first[index];
+    }
+
+private:
+    const_iterator first, last;
+};
+
+
+/** All connections of a document keyed either by source or by destination
+ *  object id. Connections are kept sorted by id and, for the same id, by
+ *  insertion order, so the connections of one object are a contiguous,
+ *  already sequenced range that can be found by binary search. */
+class ConnectionIndex
+{
+public:
+    /** Take the given connections and sort them by source (by_source=true)
+     *  or destination id. Does not take ownership of the connections. */
+    void Build(const std::vector<const Connection*>& conns, bool by_source);
+
+    ConnectionList Get(uint64_t id) const;
+
+    const std::vector<const Connection*>& Connections() const {
+        return connections;
+    }
+
+private:
+    std::vector<uint64_t> keys;
+    std::vector<const Connection*> connections;
+};
 
 
 /** DOM class for global document settings, a single instance per document can
@@ -1115,11 +1181,11 @@ public:
         return settings;
     }
 
-    const ConnectionMap& ConnectionsBySource() const {
+    const ConnectionIndex& ConnectionsBySource() const {
         return src_connections;
     }
 
-    const ConnectionMap& ConnectionsByDestination() const {
+    const ConnectionIndex& ConnectionsByDestination() const {
         return dest_connections;
     }
 
@@ -1129,8 +1195,8 @@ public:
     // cases that may involve back-facing edges in the object graph,
     // use LazyObject::IsBeingConstructed() to check.
 
-    std::vector<const Connection*> GetConnectionsBySourceSequenced(uint64_t source) const;
-    std::vector<const Connection*> GetConnectionsByDestinationSequenced(uint64_t dest) const;
+    ConnectionList GetConnectionsBySourceSequenced(uint64_t source) const;
+    ConnectionList GetConnectionsByDestinationSequenced(uint64_t dest) const;
 
     std::vector<const Connection*> GetConnectionsBySourceSequenced(uint64_t source, const char* classname) const;
     std::vector<const Connection*> GetConnectionsByDestinationSequenced(uint64_t dest, const char* classname) const;
@@ -1143,10 +1209,22 @@ public:
 
     const std::vector<const AnimationStack*>& AnimationStacks() const;
 
+    /** Check whether a Model is part of one of the subtrees selected by
+     *  ImportSettings::selectedNodes, always true if there is no selection.
+     *  Only selected models have their geometry and materials read. */
+    bool IsModelSelected(uint64_t id) const {
+        return selectAllModels || selectedModels.find(id) != selectedModels.end();
+    }
+
+    /** Check whether a Model needs to be converted at all, that is if it
+     *  is selected or is a parent of a selected model. */
+    bool IsModelRequired(uint64_t id) const {
+        return IsModelSelected(id) || requiredModels.find(id) != requiredModels.end();
+    }
+
 private:
-    std::vector<const Connection*> GetConnectionsSequenced(uint64_t id, const ConnectionMap&) const;
     std::vector<const Connection*> GetConnectionsSequenced(uint64_t id, bool is_src,
-        const ConnectionMap&,
+        const ConnectionIndex&,
         const char* const* classnames,
         size_t count) const;
 
@@ -1156,6 +1234,7 @@ private:
     void ReadPropertyTemplates();
     void ReadConnections();
     void ReadGlobalSettings();
+    void SelectModels();
 
 private:
     const ImportSettings& settings;
@@ -1164,8 +1243,8 @@ private:
     const Parser& parser;
 
     PropertyTemplateMap templates;
-    ConnectionMap src_connections;
-    ConnectionMap dest_connections;
+    ConnectionIndex src_connections;
+    ConnectionIndex dest_connections;
 
     unsigned int fbxVersion;
     std::string creator;
@@ -1174,6 +1253,11 @@ private:
     std::vector<uint64_t> animationStacks;
     mutable std::vector<const AnimationStack*> animationStacksResolved;
 
+    // models in the selected subtrees, and the parents leading to them
+    bool selectAllModels;
+    std::set<uint64_t> selectedModels;
+    std::set<uint64_t> requiredModels;
+
     std::unique_ptr<FileGlobalSettings> globals;
 };
 
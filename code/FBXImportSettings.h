@@ -44,6 +44,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef INCLUDED_AI_FBX_IMPORTSETTINGS_H
 #define INCLUDED_AI_FBX_IMPORTSETTINGS_H
 
+#include <list>
+#include <string>
+
 namespace Assimp {
 namespace FBX {
 
@@ -62,6 +65,7 @@ struct ImportSettings
         , readWeights(true)
         , preservePivots(true)
         , optimizeEmptyAnimationCurves(true)
+        , numThreads(1)
     {}
 
 
@@ -136,6 +140,18 @@ struct ImportSettings
      *  values matching the corresponding node transformation.
      *  The default value is true. */
     bool optimizeEmptyAnimationCurves;
+
+    /** number of threads the compressed data arrays of binary files
+     *  are inflated on before the document is read. 1 inflates each
+     *  array on demand, as does a non-empty selectedNodes. The default
+     *  value is 1, the importer resolves #AI_CONFIG_IMPORT_FBX_THREADS
+     *  into this. */
+    unsigned int numThreads;
+
+    /** names of the nodes to import, along with their subtrees. Empty
+     *  to import the whole scene, which is the default. The importer
+     *  fills this from #AI_CONFIG_IMPORT_FBX_NODES. */
+    std::list<std::string> selectedNodes;
 };
 
 
@@ -44,9 +44,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef ASSIMP_BUILD_NO_FBX_IMPORTER
 
+#include <algorithm>
 #include <exception>
 #include <iterator>
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <thread>
+#endif
+
 #include "FBXImporter.h"
 
 #include "FBXTokenizer.h"
@@ -56,6 +61,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXConverter.h"
 
 #include "StreamReader.h"
+#include "ProcessHelper.h"
 #include "MemoryIOWrapper.h"
 #include <assimp/Importer.hpp>
 
@@ -133,6 +139,19 @@ void FBXImporter::SetupProperties(const Importer* pImp)
     settings.strictMode = pImp->GetPropertyBool(AI_CONFIG_IMPORT_FBX_STRICT_MODE, false);
     settings.preservePivots = pImp->GetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, true);
     settings.optimizeEmptyAnimationCurves = pImp->GetPropertyBool(AI_CONFIG_IMPORT_FBX_OPTIMIZE_EMPTY_ANIMATION_CURVES, true);
+
+    // AI_CONFIG_IMPORT_FBX_THREADS, inflate on demand unless asked otherwise, 0 is one per core
+    const int numThreads = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_FBX_THREADS, 1);
+    settings.numThreads = numThreads > 0 ? static_cast<unsigned int>(numThreads) : 1;
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    if (numThreads <= 0) {
+        settings.numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+#endif
+
+    // AI_CONFIG_IMPORT_FBX_NODES, empty is the whole scene
+    settings.selectedNodes.clear();
+    ConvertListToStrings(pImp->GetPropertyString(AI_CONFIG_IMPORT_FBX_NODES, ""), settings.selectedNodes);
 }
 
 
@@ -157,36 +176,38 @@ void FBXImporter::InternReadFile( const std::string& pFile,
     contents[ contents.size() - 1 ] = 0;
     const char* const begin = &*contents.begin();
 
+    // tokens and the parse-tree are allocated from this arena and
+    // released together when it goes out of scope
+    Arena arena;
+
     // broadphase tokenizing pass in which we identify the core
     // syntax elements of FBX (brackets, commas, key:value mappings)
     TokenList tokens;
-    try {
-
-        bool is_binary = false;
-        if (!strncmp(begin,"Kaydara FBX Binary",18)) {
-            is_binary = true;
-            TokenizeBinary(tokens,begin,contents.size());
-        }
-        else {
-            Tokenize(tokens,begin);
-        }
+    bool is_binary = false;
+    if (!strncmp(begin,"Kaydara FBX Binary",18)) {
+        is_binary = true;
+        TokenizeBinary(tokens,begin,contents.size(),arena);
+    }
+    else {
+        Tokenize(tokens,begin,arena);
+    }
 
-        // use this information to construct a very rudimentary
-        // parse-tree representing the FBX scope structure
-        Parser parser(tokens, is_binary);
+    // use this information to construct a very rudimentary
+    // parse-tree representing the FBX scope structure
+    Parser parser(tokens, is_binary, arena);
 
-        // take the raw parse-tree and convert it to a FBX DOM
-        Document doc(parser,settings);
+    // inflate all compressed data arrays at once so reading the
+    // geometry later on does not have to wait for zlib. Not with
+    // a node selection, which would never read most of them.
+    if (is_binary && settings.numThreads > 1 && settings.selectedNodes.empty()) {
+        parser.InflateBinaryDataArrays(settings.numThreads);
+    }
 
-        // convert the FBX DOM to aiScene
-        ConvertToAssimpScene(pScene,doc);
+    // take the raw parse-tree and convert it to a FBX DOM
+    Document doc(parser,settings);
 
-        std::for_each(tokens.begin(),tokens.end(),Util::delete_fun<Token>());
-    }
-    catch(std::exception&) {
-        std::for_each(tokens.begin(),tokens.end(),Util::delete_fun<Token>());
-        throw;
-    }
+    // convert the FBX DOM to aiScene
+    ConvertToAssimpScene(pScene,doc);
 }
 
 #endif // !ASSIMP_BUILD_NO_FBX_IMPORTER
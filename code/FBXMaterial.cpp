@@ -94,7 +94,7 @@ Material::Material(uint64_t id, const Element& element, const Document& doc, con
     props = GetPropertyTable(doc,templateName,element,sc);
 
     // resolve texture links
-    const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID());
+    const ConnectionList conns = doc.GetConnectionsByDestinationSequenced(ID());
     for(const Connection* con : conns) {
 
         // texture link to properties, not objects
@@ -203,7 +203,7 @@ Texture::Texture(uint64_t id, const Element& element, const Document& doc, const
 
     // resolve video links
     if(doc.Settings().readTextures) {
-        const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID());
+        const ConnectionList conns = doc.GetConnectionsByDestinationSequenced(ID());
         for(const Connection* con : conns) {
             const Object* const ob = con->SourceObject();
             if(!ob) {
@@ -254,10 +254,10 @@ LayeredTexture::~LayeredTexture()
 
 void LayeredTexture::fillTexture(const Document& doc)
 {
-    const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID());
+    const ConnectionList conns = doc.GetConnectionsByDestinationSequenced(ID());
     for(size_t i = 0; i < conns.size();++i)
     {
-        const Connection* con = conns.at(i);
+        const Connection* con = conns[i];
 
         const Object* const ob = con->SourceObject();
         if(!ob) {
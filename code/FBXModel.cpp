@@ -89,10 +89,12 @@ Model::~Model()
 // ------------------------------------------------------------------------------------------------
 void Model::ResolveLinks(const Element& element, const Document& doc)
 {
-    const char* const arr[] = {"Geometry","Material","NodeAttribute"};
+    const char* const arr[] = {"NodeAttribute","Geometry","Material"};
 
-    // resolve material
-    const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID(),arr, 3);
+    // resolve material. Models that are only kept as parents of the nodes
+    // selected for import don't need their geometry and materials read.
+    const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID(),arr,
+        doc.IsModelSelected(ID()) ? 3 : 1);
 
     materials.reserve(conns.size());
     geometry.reserve(conns.size());
@@ -59,8 +59,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ParsingUtils.h"
 #include "fast_atof.h"
 #include "ByteSwapper.h"
+#include "ParallelProcess.h"
 
 #include <iostream>
+#include <limits>
 
 using namespace Assimp;
 using namespace Assimp::FBX;
@@ -116,6 +118,9 @@ namespace FBX {
 // ------------------------------------------------------------------------------------------------
 Element::Element(const Token& key_token, Parser& parser)
 : key_token(key_token)
+, tokens(ElementTokenList::allocator_type(parser.arena))
+, compound()
+, inflated()
 {
     TokenPtr n = NULL;
     do {
@@ -146,7 +151,7 @@ Element::Element(const Token& key_token, Parser& parser)
         }
 
         if (n->Type() == TokenType_OPEN_BRACKET) {
-            compound.reset(new Scope(parser));
+            compound = parser.arena.New<Scope>(parser);
 
             // current token should be a TOK_CLOSE_BRACKET
             n = parser.CurrentToken();
@@ -166,11 +171,12 @@ Element::Element(const Token& key_token, Parser& parser)
 // ------------------------------------------------------------------------------------------------
 Element::~Element()
 {
-     // no need to delete tokens, they are owned by the parser
+     // no need to delete tokens or the compound scope, they are owned by the arena
 }
 
 // ------------------------------------------------------------------------------------------------
 Scope::Scope(Parser& parser,bool topLevel)
+: elements(ElementMapAllocator(parser.arena))
 {
     if(!topLevel) {
         TokenPtr t = parser.CurrentToken();
@@ -190,8 +196,7 @@ Scope::Scope(Parser& parser,bool topLevel)
             ParseError("unexpected token, expected TOK_KEY",n);
         }
 
-        const std::string& str = n->StringContents();
-        elements.insert(ElementMap::value_type(str,new_Element(*n,parser)));
+        elements.insert(ElementMap::value_type(n->View(),parser.arena.New<Element>(*n,parser)));
 
         // Element() should stop at the next Key token (or right after a Close token)
         n = parser.CurrentToken();
@@ -207,21 +212,21 @@ Scope::Scope(Parser& parser,bool topLevel)
 // ------------------------------------------------------------------------------------------------
 Scope::~Scope()
 {
-    for(ElementMap::value_type& v : elements) {
-        delete v.second;
-    }
+    // elements are owned by the arena
 }
 
 
 // ------------------------------------------------------------------------------------------------
-Parser::Parser (const TokenList& tokens, bool is_binary)
+Parser::Parser (const TokenList& tokens, bool is_binary, Arena& arena)
 : tokens(tokens)
+, arena(arena)
 , last()
 , current()
 , cursor(tokens.begin())
+, root()
 , is_binary(is_binary)
 {
-    root.reset(new Scope(*this,true));
+    root = arena.New<Scope>(*this,true);
 }
 
 
@@ -522,10 +527,61 @@ void ReadBinaryDataArrayHead(const char*& data, const char* end, char& type, uin
 
 
 // ------------------------------------------------------------------------------------------------
-// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header)
-void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end,
+// size of a single element of a binary data array, 0 for types that are not read as arrays here
+uint32_t BinaryDataArrayStride(char type)
+{
+    switch(type)
+    {
+    case 'f':
+    case 'i':
+        return 4;
+
+    case 'd':
+    case 'l':
+        return 8;
+    };
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// zlib/deflate, data starts with the ZIP head (0x78 0x01)
+// see http://www.ietf.org/rfc/rfc1950.txt
+bool InflateBinaryDataArray(const char* data, uint32_t comp_len, char* out, uint32_t full_length)
+{
+    z_stream zstream;
+    zstream.opaque = Z_NULL;
+    zstream.zalloc = Z_NULL;
+    zstream.zfree  = Z_NULL;
+    zstream.data_type = Z_BINARY;
+
+    // http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
+    if(Z_OK != inflateInit(&zstream)) {
+        return false;
+    }
+
+    zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
+    zstream.avail_in  = comp_len;
+
+    zstream.avail_out = full_length;
+    zstream.next_out = reinterpret_cast<Bytef*>(out);
+    const int ret = inflate(&zstream, Z_FINISH);
+
+    // a stream that ends early would leave the rest of out uninitialized
+    const bool complete = zstream.total_out == full_length;
+
+    // terminate zlib
+    inflateEnd(&zstream);
+    return (ret == Z_STREAM_END || ret == Z_OK) && complete;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header).
+// Returns the uncompressed data, which is either held by buff or was inflated in advance.
+const char* ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end,
     std::vector<char>& buff,
-    const Element& /*el*/)
+    const Element& el)
 {
     BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data, end);
     AI_SWAP4(encmode);
@@ -539,24 +595,16 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
     ai_assert(data + comp_len == end);
 
     // determine the length of the uncompressed data by looking at the type signature
-    uint32_t stride = 0;
-    switch(type)
-    {
-    case 'f':
-    case 'i':
-        stride = 4;
-        break;
+    const uint32_t stride = BinaryDataArrayStride(type);
+    ai_assert(stride);
 
-    case 'd':
-    case 'l':
-        stride = 8;
-        break;
+    const uint32_t full_length = stride * count;
 
-    default:
-        ai_assert(false);
-    };
+    if(el.InflatedData()) {
+        data += comp_len;
+        return el.InflatedData();
+    }
 
-    const uint32_t full_length = stride * count;
     buff.resize(full_length);
 
     if(encmode == 0) {
@@ -566,33 +614,9 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
         std::copy(data, end, buff.begin());
     }
     else if(encmode == 1) {
-        // zlib/deflate, next comes ZIP head (0x78 0x01)
-        // see http://www.ietf.org/rfc/rfc1950.txt
-
-        z_stream zstream;
-        zstream.opaque = Z_NULL;
-        zstream.zalloc = Z_NULL;
-        zstream.zfree  = Z_NULL;
-        zstream.data_type = Z_BINARY;
-
-        // http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
-        if(Z_OK != inflateInit(&zstream)) {
-            ParseError("failure initializing zlib");
-        }
-
-        zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
-        zstream.avail_in  = comp_len;
-
-        zstream.avail_out = buff.size();
-        zstream.next_out = reinterpret_cast<Bytef*>(&*buff.begin());
-        const int ret = inflate(&zstream, Z_FINISH);
-
-        if (ret != Z_STREAM_END && ret != Z_OK) {
+        if(!InflateBinaryDataArray(data, comp_len, &buff[0], full_length)) {
             ParseError("failure decompressing compressed data section");
         }
-
-        // terminate zlib
-        inflateEnd(&zstream);
     }
 #ifdef ASSIMP_BUILD_DEBUG
     else {
@@ -603,18 +627,96 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
 
     data += comp_len;
     ai_assert(data == end);
+    return &buff[0];
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// collect all elements whose first token is a zlib-compressed binary data array
+void CollectCompressedDataArrays(const Scope& scope, std::vector<Element*>& out)
+{
+    const ElementMap& elements = scope.Elements();
+    for(ElementMap::const_iterator it = elements.begin(); it != elements.end(); ++it) {
+        Element* const el = (*it).second;
+        if (el->Compound()) {
+            CollectCompressedDataArrays(*el->Compound(), out);
+        }
+
+        const ElementTokenList& tok = el->Tokens();
+        if (tok.empty() || !tok[0]->IsBinary() || !BinaryDataArrayStride(*tok[0]->begin())) {
+            continue;
+        }
+
+        // type, count, encoding and compressed length, the tokenizer checked the sizes already
+        const char* const data = tok[0]->begin();
+        if (static_cast<size_t>(tok[0]->end() - data) < 13) {
+            continue;
+        }
+
+        BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data + 5, tok[0]->end());
+        AI_SWAP4(encmode);
+        if (encmode == 1) {
+            out.push_back(el);
+        }
+    }
 }
 
 } // !anon
 
 
+// ------------------------------------------------------------------------------------------------
+void Parser::InflateBinaryDataArrays(unsigned int numThreads)
+{
+    std::vector<Element*> elements;
+    CollectCompressedDataArrays(*root, elements);
+
+    // the arena is not thread-safe, so allocate all output buffers up front
+    std::vector<char*> buffers(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const char* data = elements[i]->Tokens()[0]->begin();
+
+        BE_NCONST uint32_t count = SafeParse<uint32_t>(data + 1, data + 5);
+        AI_SWAP4(count);
+
+        const uint64_t full_length = static_cast<uint64_t>(count) * BinaryDataArrayStride(*data);
+        if (count && full_length <= std::numeric_limits<uint32_t>::max()) {
+            buffers[i] = static_cast<char*>(arena.Allocate(static_cast<size_t>(full_length)));
+        }
+    }
+
+    ParallelFor(static_cast<unsigned int>(elements.size()), numThreads, [&](unsigned int i) {
+        if (!buffers[i]) {
+            return;
+        }
+
+        const Token& t = *elements[i]->Tokens()[0];
+        const char* const data = t.begin();
+
+        BE_NCONST uint32_t count = SafeParse<uint32_t>(data + 1, t.end());
+        AI_SWAP4(count);
+
+        BE_NCONST uint32_t comp_len = SafeParse<uint32_t>(data + 9, t.end());
+        AI_SWAP4(comp_len);
+
+        if (data + 13 + comp_len != t.end()) {
+            return;
+        }
+
+        // on failure, ReadBinaryDataArray() tries again and reports the error if the array is ever read
+        if (InflateBinaryDataArray(data + 13, comp_len, buffers[i], count * BinaryDataArrayStride(*data))) {
+            elements[i]->inflated = buffers[i];
+        }
+    });
+}
+
+
 // ------------------------------------------------------------------------------------------------
 // read an array of float3 tuples
 void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
 {
     out.resize( 0 );
 
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if(tok.empty()) {
         ParseError("unexpected empty element",&el);
     }
@@ -639,16 +741,15 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
 
         const uint32_t count3 = count / 3;
         out.reserve(count3);
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(raw);
             for (unsigned int i = 0; i < count3; ++i, d += 3) {
                 out.push_back(aiVector3D(static_cast<float>(d[0]),
                     static_cast<float>(d[1]),
@@ -663,7 +764,7 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
             }*/
         }
         else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(raw);
             for (unsigned int i = 0; i < count3; ++i, f += 3) {
                 out.push_back(aiVector3D(f[0],f[1],f[2]));
             }
@@ -685,7 +786,7 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
     if (a.Tokens().size() % 3 != 0) {
         ParseError("number of floats is not a multiple of three (3)",&el);
     }
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
         aiVector3D v;
         v.x = ParseTokenAsFloat(**it++);
         v.y = ParseTokenAsFloat(**it++);
@@ -701,7 +802,7 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
 void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
 {
     out.resize( 0 );
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if(tok.empty()) {
         ParseError("unexpected empty element",&el);
     }
@@ -726,16 +827,15 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
 
         const uint32_t count4 = count / 4;
         out.reserve(count4);
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(raw);
             for (unsigned int i = 0; i < count4; ++i, d += 4) {
                 out.push_back(aiColor4D(static_cast<float>(d[0]),
                     static_cast<float>(d[1]),
@@ -744,7 +844,7 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
             }
         }
         else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(raw);
             for (unsigned int i = 0; i < count4; ++i, f += 4) {
                 out.push_back(aiColor4D(f[0],f[1],f[2],f[3]));
             }
@@ -763,7 +863,7 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
     if (a.Tokens().size() % 4 != 0) {
         ParseError("number of floats is not a multiple of four (4)",&el);
     }
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
         aiColor4D v;
         v.r = ParseTokenAsFloat(**it++);
         v.g = ParseTokenAsFloat(**it++);
@@ -780,7 +880,7 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
 void ParseVectorDataArray(std::vector<aiVector2D>& out, const Element& el)
 {
     out.resize( 0 );
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if(tok.empty()) {
         ParseError("unexpected empty element",&el);
     }
@@ -805,23 +905,22 @@ void ParseVectorDataArray(std::vector<aiVector2D>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
 
         const uint32_t count2 = count / 2;
         out.reserve(count2);
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(raw);
             for (unsigned int i = 0; i < count2; ++i, d += 2) {
                 out.push_back(aiVector2D(static_cast<float>(d[0]),
                     static_cast<float>(d[1])));
             }
         }
         else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(raw);
             for (unsigned int i = 0; i < count2; ++i, f += 2) {
                 out.push_back(aiVector2D(f[0],f[1]));
             }
@@ -841,7 +940,7 @@ void ParseVectorDataArray(std::vector<aiVector2D>& out, const Element& el)
     if (a.Tokens().size() % 2 != 0) {
         ParseError("number of floats is not a multiple of two (2)",&el);
     }
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
         aiVector2D v;
         v.x = ParseTokenAsFloat(**it++);
         v.y = ParseTokenAsFloat(**it++);
@@ -856,7 +955,7 @@ void ParseVectorDataArray(std::vector<aiVector2D>& out, const Element& el)
 void ParseVectorDataArray(std::vector<int>& out, const Element& el)
 {
     out.resize( 0 );
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if(tok.empty()) {
         ParseError("unexpected empty element",&el);
     }
@@ -877,14 +976,13 @@ void ParseVectorDataArray(std::vector<int>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * 4);
 
         out.reserve(count);
 
-        const int32_t* ip = reinterpret_cast<const int32_t*>(&buff[0]);
+        const int32_t* ip = reinterpret_cast<const int32_t*>(raw);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST int32_t val = *ip;
             AI_SWAP4(val);
@@ -902,7 +1000,7 @@ void ParseVectorDataArray(std::vector<int>& out, const Element& el)
     const Scope& scope = GetRequiredScope(el);
     const Element& a = GetRequiredElement(scope,"a",&el);
 
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
         const int ival = ParseTokenAsInt(**it++);
         out.push_back(ival);
     }
@@ -914,7 +1012,7 @@ void ParseVectorDataArray(std::vector<int>& out, const Element& el)
 void ParseVectorDataArray(std::vector<float>& out, const Element& el)
 {
     out.resize( 0 );
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if(tok.empty()) {
         ParseError("unexpected empty element",&el);
     }
@@ -935,19 +1033,18 @@ void ParseVectorDataArray(std::vector<float>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
 
         if (type == 'd') {
-            const double* d = reinterpret_cast<const double*>(&buff[0]);
+            const double* d = reinterpret_cast<const double*>(raw);
             for (unsigned int i = 0; i < count; ++i, ++d) {
                 out.push_back(static_cast<float>(*d));
             }
         }
         else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
+            const float* f = reinterpret_cast<const float*>(raw);
             for (unsigned int i = 0; i < count; ++i, ++f) {
                 out.push_back(*f);
             }
@@ -964,7 +1061,7 @@ void ParseVectorDataArray(std::vector<float>& out, const Element& el)
     const Scope& scope = GetRequiredScope(el);
     const Element& a = GetRequiredElement(scope,"a",&el);
 
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
         const float ival = ParseTokenAsFloat(**it++);
         out.push_back(ival);
     }
@@ -976,7 +1073,7 @@ void ParseVectorDataArray(std::vector<float>& out, const Element& el)
 void ParseVectorDataArray(std::vector<unsigned int>& out, const Element& el)
 {
     out.resize( 0 );
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if(tok.empty()) {
         ParseError("unexpected empty element",&el);
     }
@@ -997,14 +1094,13 @@ void ParseVectorDataArray(std::vector<unsigned int>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * 4);
 
         out.reserve(count);
 
-        const int32_t* ip = reinterpret_cast<const int32_t*>(&buff[0]);
+        const int32_t* ip = reinterpret_cast<const int32_t*>(raw);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST int32_t val = *ip;
             if(val < 0) {
@@ -1026,7 +1122,7 @@ void ParseVectorDataArray(std::vector<unsigned int>& out, const Element& el)
     const Scope& scope = GetRequiredScope(el);
     const Element& a = GetRequiredElement(scope,"a",&el);
 
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
         const int ival = ParseTokenAsInt(**it++);
         if(ival < 0) {
             ParseError("encountered negative integer index");
@@ -1041,7 +1137,7 @@ void ParseVectorDataArray(std::vector<unsigned int>& out, const Element& el)
 void ParseVectorDataArray(std::vector<uint64_t>& out, const Element& el)
 {
     out.resize( 0 );
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if(tok.empty()) {
         ParseError("unexpected empty element",&el);
     }
@@ -1062,14 +1158,13 @@ void ParseVectorDataArray(std::vector<uint64_t>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * 8);
 
         out.reserve(count);
 
-        const uint64_t* ip = reinterpret_cast<const uint64_t*>(&buff[0]);
+        const uint64_t* ip = reinterpret_cast<const uint64_t*>(raw);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST uint64_t val = *ip;
             AI_SWAP8(val);
@@ -1087,7 +1182,7 @@ void ParseVectorDataArray(std::vector<uint64_t>& out, const Element& el)
     const Scope& scope = GetRequiredScope(el);
     const Element& a = GetRequiredElement(scope,"a",&el);
 
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end; ) {
         const uint64_t ival = ParseTokenAsID(**it++);
 
         out.push_back(ival);
@@ -1099,7 +1194,7 @@ void ParseVectorDataArray(std::vector<uint64_t>& out, const Element& el)
 void ParseVectorDataArray(std::vector<int64_t>& out, const Element& el)
 {
     out.resize( 0 );
-    const TokenList& tok = el.Tokens();
+    const ElementTokenList& tok = el.Tokens();
     if (tok.empty()) {
         ParseError("unexpected empty element", &el);
     }
@@ -1120,14 +1215,13 @@ void ParseVectorDataArray(std::vector<int64_t>& out, const Element& el)
         }
 
         std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
+        const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
 
         ai_assert(data == end);
-        ai_assert(buff.size() == count * 8);
 
         out.reserve(count);
 
-        const int64_t* ip = reinterpret_cast<const int64_t*>(&buff[0]);
+        const int64_t* ip = reinterpret_cast<const int64_t*>(raw);
         for (unsigned int i = 0; i < count; ++i, ++ip) {
             BE_NCONST int64_t val = *ip;
             AI_SWAP8(val);
@@ -1145,7 +1239,7 @@ void ParseVectorDataArray(std::vector<int64_t>& out, const Element& el)
     const Scope& scope = GetRequiredScope(el);
     const Element& a = GetRequiredElement(scope, "a", &el);
 
-    for (TokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end;) {
+    for (ElementTokenList::const_iterator it = a.Tokens().begin(), end = a.Tokens().end(); it != end;) {
         const int64_t ival = ParseTokenAsInt64(**it++);
 
         out.push_back(ival);
@@ -1232,7 +1326,7 @@ const Scope& GetRequiredScope(const Element& el)
 // get token at a particular index
 const Token& GetRequiredToken(const Element& el, unsigned int index)
 {
-    const TokenList& t = el.Tokens();
+    const ElementTokenList& t = el.Tokens();
     if(index >= t.size()) {
         ParseError(Formatter::format( "missing token at index " ) << index,&el);
     }
@@ -59,14 +59,21 @@ class Scope;
 class Parser;
 class Element;
 
-// XXX should use C++11's unique_ptr - but assimp's need to keep working with 03
+// the DOM is owned by the #Arena passed to the #Parser. Keys point into the input buffer.
 typedef std::vector< Scope* > ScopeList;
-typedef std::fbx_unordered_multimap< std::string, Element* > ElementMap;
+typedef ArenaAllocator< std::pair<const StringView, Element*> > ElementMapAllocator;
+#ifdef ASSIMP_FBX_USE_UNORDERED_MULTIMAP
+typedef std::fbx_unordered_multimap< StringView, Element*, StringViewHash,
+    std::equal_to<StringView>, ElementMapAllocator > ElementMap;
+#else
+typedef std::fbx_unordered_multimap< StringView, Element*, std::less<StringView>,
+    ElementMapAllocator > ElementMap;
+#endif
 
 typedef std::pair<ElementMap::const_iterator,ElementMap::const_iterator> ElementCollection;
 
-#   define new_Scope new Scope
-#   define new_Element new Element
+// data tokens of an #Element
+typedef std::vector< TokenPtr, ArenaAllocator<TokenPtr> > ElementTokenList;
 
 
 /** FBX data entity that consists of a key:value tuple.
@@ -90,22 +97,31 @@ public:
 public:
 
     const Scope* Compound() const {
-        return compound.get();
+        return compound;
     }
 
     const Token& KeyToken() const {
         return key_token;
     }
 
-    const TokenList& Tokens() const {
+    const ElementTokenList& Tokens() const {
         return tokens;
     }
 
+    /** Decompressed contents of the binary data array held by the
+     *  first token, or NULL if it was not inflated in advance by
+     *  #Parser::InflateBinaryDataArrays(). */
+    const char* InflatedData() const {
+        return inflated;
+    }
+
 private:
+    friend class Parser;
 
     const Token& key_token;
-    TokenList tokens;
-    std::unique_ptr<Scope> compound;
+    ElementTokenList tokens;
+    const Scope* compound;
+    const char* inflated;
 };
 
 
@@ -157,13 +173,15 @@ class Parser
 public:
 
     /** Parse given a token list. Does not take ownership of the tokens -
-     *  the objects must persist during the entire parser lifetime */
-    Parser (const TokenList& tokens,bool is_binary);
+     *  the objects must persist during the entire parser lifetime.
+     *  All scopes and elements are created in the given arena, they
+     *  stay valid as long as the arena does. */
+    Parser (const TokenList& tokens,bool is_binary,Arena& arena);
     ~Parser();
 
 public:
     const Scope& GetRootScope() const {
-        return *root.get();
+        return *root;
     }
 
 
@@ -171,6 +189,12 @@ public:
         return is_binary;
     }
 
+    /** Inflate all zlib-compressed data arrays of a binary file on up
+     *  to numThreads threads. The results are allocated from the arena
+     *  and picked up by ParseVectorDataArray(), arrays that fail to
+     *  inflate are left alone and report their error when read. */
+    void InflateBinaryDataArrays(unsigned int numThreads);
+
 private:
     friend class Scope;
     friend class Element;
@@ -184,9 +208,11 @@ private:
 private:
     const TokenList& tokens;
 
+    Arena& arena;
+
     TokenPtr last, current;
     TokenList::const_iterator cursor;
-    std::unique_ptr<Scope> root;
+    const Scope* root;
 
     const bool is_binary;
 };
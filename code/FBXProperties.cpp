@@ -73,7 +73,7 @@ Property* ReadTypedProperty(const Element& element)
 {
     ai_assert(element.KeyToken().StringContents() == "P");
 
-    const TokenList& tok = element.Tokens();
+    const ElementTokenList& tok = element.Tokens();
     ai_assert(tok.size() >= 5);
 
     const std::string& s = ParseTokenAsString(*tok[1]);
@@ -119,7 +119,7 @@ Property* ReadTypedProperty(const Element& element)
 std::string PeekPropertyName(const Element& element)
 {
     ai_assert(element.KeyToken().StringContents() == "P");
-    const TokenList& tok = element.Tokens();
+    const ElementTokenList& tok = element.Tokens();
     if(tok.size() < 4) {
         return "";
     }
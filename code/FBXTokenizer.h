@@ -46,9 +46,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <memory>
 #include "FBXCompileConfig.h"
+#include "FBXArena.h"
 #include <assimp/ai_assert.h>
 #include <vector>
 #include <string>
+#include <string.h>
+#include <algorithm>
 
 namespace Assimp {
 namespace FBX {
@@ -78,6 +81,82 @@ enum TokenType
 };
 
 
+/** Non-owning reference to a range of characters, usually in the input
+ *  buffer. Used as key type for the DOM so keys don't have to be copied. */
+class StringView
+{
+public:
+
+    StringView()
+    : sbegin()
+    , send()
+    {}
+
+    StringView(const char* sbegin, const char* send)
+    : sbegin(sbegin)
+    , send(send)
+    {}
+
+    StringView(const char* s)
+    : sbegin(s)
+    , send(s + ::strlen(s))
+    {}
+
+    StringView(const std::string& s)
+    : sbegin(s.data())
+    , send(s.data() + s.length())
+    {}
+
+public:
+
+    const char* begin() const {
+        return sbegin;
+    }
+
+    const char* end() const {
+        return send;
+    }
+
+    size_t length() const {
+        return static_cast<size_t>(send - sbegin);
+    }
+
+    std::string str() const {
+        return std::string(sbegin, send);
+    }
+
+    bool operator == (const StringView& other) const {
+        return length() == other.length() && !::memcmp(sbegin, other.sbegin, length());
+    }
+
+    bool operator != (const StringView& other) const {
+        return !(*this == other);
+    }
+
+    bool operator < (const StringView& other) const {
+        const int cmp = ::memcmp(sbegin, other.sbegin, std::min(length(), other.length()));
+        return cmp ? cmp < 0 : length() < other.length();
+    }
+
+private:
+
+    const char* sbegin;
+    const char* send;
+};
+
+/** Hash functor for #StringView (FNV-1a) */
+struct StringViewHash
+{
+    size_t operator()(const StringView& s) const {
+        size_t h = static_cast<size_t>(2166136261u);
+        for (const char* c = s.begin(); c != s.end(); ++c) {
+            h = (h ^ static_cast<unsigned char>(*c)) * static_cast<size_t>(16777619u);
+        }
+        return h;
+    }
+};
+
+
 /** Represents a single token in a FBX file. Tokens are
  *  classified by the #TokenType enumerated types.
  *
@@ -97,14 +176,16 @@ public:
     /** construct a binary token */
     Token(const char* sbegin, const char* send, TokenType type, unsigned int offset);
 
-    ~Token();
-
 public:
 
     std::string StringContents() const {
         return std::string(begin(),end());
     }
 
+    StringView View() const {
+        return StringView(begin(),end());
+    }
+
 public:
 
     bool IsBinary() const {
@@ -158,12 +239,10 @@ private:
     const unsigned int column;
 };
 
-// XXX should use C++11's unique_ptr - but assimp's need to keep working with 03
+// tokens are owned by the #Arena they were created in
 typedef const Token* TokenPtr;
 typedef std::vector< TokenPtr > TokenList;
 
-#define new_Token new Token
-
 
 /** Main FBX tokenizer function. Transform input buffer into a list of preprocessed tokens.
  *
@@ -171,8 +250,9 @@ typedef std::vector< TokenPtr > TokenList;
  *
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Textual input buffer to be processed, 0-terminated.
+ * @param arena Arena the tokens are created in.
  * @throw DeadlyImportError if something goes wrong */
-void Tokenize(TokenList& output_tokens, const char* input);
+void Tokenize(TokenList& output_tokens, const char* input, Arena& arena);
 
 
 /** Tokenizer function for binary FBX files.
@@ -182,8 +262,9 @@ void Tokenize(TokenList& output_tokens, const char* input);
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Binary input buffer to be processed.
  * @param length Length of input buffer, in bytes. There is no 0-terminal.
+ * @param arena Arena the tokens are created in.
  * @throw DeadlyImportError if something goes wrong */
-void TokenizeBinary(TokenList& output_tokens, const char* input, unsigned int length);
+void TokenizeBinary(TokenList& output_tokens, const char* input, unsigned int length, Arena& arena);
 
 
 } // ! FBX
@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // internal headers
 #include "GenVertexNormalsProcess.h"
 #include "ProcessHelper.h"
+#include "ParallelProcess.h"
 #include "Exceptional.h"
 #include "qnan.h"
 
@@ -56,7 +57,8 @@ using namespace Assimp;
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 GenVertexNormalsProcess::GenVertexNormalsProcess()
-: configMaxAngle( AI_DEG_TO_RAD( 175.f ) ) {
+: configMaxAngle( AI_DEG_TO_RAD( 175.f ) )
+, configNumThreads( 1 ) {
     // empty
 }
 
@@ -80,6 +82,8 @@ void GenVertexNormalsProcess::SetupProperties(const Importer* pImp)
     // Get the current value of the AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE property
     configMaxAngle = pImp->GetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE,175.f);
     configMaxAngle = AI_DEG_TO_RAD(std::max(std::min(configMaxAngle,175.0f),0.0f));
+
+    configNumThreads = GetPostProcessThreadCount(pImp);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -91,12 +95,11 @@ void GenVertexNormalsProcess::Execute( aiScene* pScene)
     if (pScene->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT)
         throw DeadlyImportError("Post-processing order mismatch: expecting pseudo-indexed (\"verbose\") vertices here");
 
-    bool bHas = false;
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-    {
-        if(GenMeshVertexNormals( pScene->mMeshes[a],a))
-            bHas = true;
-    }
+    std::vector<char> computed(pScene->mNumMeshes,0);
+    ParallelForEachMesh(pScene,configNumThreads,[&](unsigned int a) {
+        computed[a] = GenMeshVertexNormals( pScene->mMeshes[a],a);
+    });
+    const bool bHas = std::find(computed.begin(),computed.end(),1) != computed.end();
 
     if (bHas)   {
         DefaultLogger::get()->info("GenVertexNormalsProcess finished. "
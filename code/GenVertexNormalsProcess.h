@@ -105,6 +105,9 @@ private:
 
     /** Configuration option: maximum smoothing angle, in radians*/
     float configMaxAngle;
+
+    /** Number of threads the meshes are distributed on */
+    unsigned int configNumThreads;
 };
 
 } // end of namespace Assimp
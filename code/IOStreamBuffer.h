@@ -0,0 +1,207 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file  IOStreamBuffer.h
+ *  @brief IOStreamBuffer, reads an IOStream through a fixed size block
+ *    so text formats can be parsed line by line without loading the
+ *    whole file first.
+ */
+#ifndef INCLUDED_IOSTREAM_BUFFER_H
+#define INCLUDED_IOSTREAM_BUFFER_H
+
+#include <assimp/IOStream.hpp>
+#include "Exceptional.h"
+
+#include <vector>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** Usage:
+@code
+IOStreamBuffer<char> streamBuffer(stream);
+std::vector<char> line;
+while (streamBuffer.getNextLine(line, '\\')) {
+    // line holds the characters of one line followed by '\n' and '\0'
+}
+@endcode
+
+Only one block of the file is held at a time. A line that crosses the end
+of a block is assembled in the caller's line buffer, so the memory used is
+one block plus the longest line, whatever the size of the file. */
+// ------------------------------------------------------------------------------------------------
+template<class T>
+class IOStreamBuffer
+{
+public:
+    static const size_t DefaultBlockSize = 1024 * 1024;
+
+public:
+
+    // -----------------------------------------
+    /** construct from an open stream, which stays owned by the caller.
+     *  Reading starts at offset, e.g. to skip a byte order mark. */
+    explicit IOStreamBuffer(IOStream* stream, size_t offset = 0, size_t blockSize = DefaultBlockSize)
+        : stream(stream)
+        , fileSize(stream->FileSize())
+        , startPos(offset)
+        , block(blockSize > 0 ? blockSize : DefaultBlockSize)
+        , blockPos(0)
+        , blockEnd(0)
+        , filePos(0)
+    {
+        rewind();
+    }
+
+public:
+
+    // -----------------------------------------
+    /** size of the whole stream in bytes */
+    size_t size() const {
+        return fileSize;
+    }
+
+    // -----------------------------------------
+    /** number of bytes handed out so far */
+    size_t getFilePos() const {
+        return filePos - (blockEnd - blockPos) * sizeof(T);
+    }
+
+    // -----------------------------------------
+    /** go back to the beginning of the stream */
+    void rewind() {
+        if (stream->Seek(startPos, aiOrigin_SET) != aiReturn_SUCCESS) {
+            throw DeadlyImportError("Unable to seek back to the start of the file");
+        }
+        blockPos = blockEnd = 0;
+        filePos = startPos;
+    }
+
+    // -----------------------------------------
+    /** hand out the rest of the current block, reading the next one when it
+     *  is used up. Returns false once the end of the stream is reached. */
+    bool getNextBlock(const T*& data, size_t& count) {
+        if (blockPos == blockEnd && !readNextBlock()) {
+            return false;
+        }
+        data = &block[blockPos];
+        count = blockEnd - blockPos;
+        blockPos = blockEnd;
+        return true;
+    }
+
+    // -----------------------------------------
+    /** fetch the next line that is not empty, without its line break and any
+     *  leading blanks. A continuation character followed by a line break
+     *  joins the next line on, any other continuation character is dropped.
+     *  The line is terminated by '\n' and '\0' so the usual parsing helpers
+     *  can run over it. Returns false once the end of the stream is reached. */
+    bool getNextLine(std::vector<T>& line, T continuation) {
+        line.clear();
+
+        bool joining = false;
+        for (;;) {
+            if (blockPos == blockEnd && !readNextBlock()) {
+                break;
+            }
+
+            const T c = block[blockPos];
+            if (c == continuation) {
+                joining = true;
+                ++blockPos;
+                continue;
+            }
+            if (c == '\n' || c == '\r') {
+                ++blockPos;
+                if (joining || line.empty()) {
+                    continue;
+                }
+                break;
+            }
+            joining = false;
+
+            if (line.empty() && (c == ' ' || c == '\t')) {
+                ++blockPos;
+                continue;
+            }
+
+            // copy the run up to the next character that needs a look
+            size_t end = blockPos + 1;
+            while (end < blockEnd && block[end] != '\n' && block[end] != '\r' && block[end] != continuation) {
+                ++end;
+            }
+            line.insert(line.end(), block.begin() + blockPos, block.begin() + end);
+            blockPos = end;
+        }
+
+        if (line.empty()) {
+            return false;
+        }
+
+        line.push_back('\n');
+        line.push_back('\0');
+        return true;
+    }
+
+private:
+
+    // -----------------------------------------
+    bool readNextBlock() {
+        const size_t read = stream->Read(&block[0], sizeof(T), block.size());
+        blockPos = 0;
+        blockEnd = read;
+        filePos += read * sizeof(T);
+        return read > 0;
+    }
+
+private:
+
+    IOStream* stream;
+    size_t fileSize;
+    size_t startPos;
+    std::vector<T> block;
+    size_t blockPos, blockEnd;
+    size_t filePos;
+};
+
+} // Namespace Assimp
+
+#endif // INCLUDED_IOSTREAM_BUFFER_H
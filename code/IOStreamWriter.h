@@ -0,0 +1,321 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  IOStreamWriter.h
+ *  @brief IOStreamWriter, writes text and binary output to an IOStream
+ *    through a fixed size block so exporters don't have to build the
+ *    whole file in memory first.
+ */
+#ifndef INCLUDED_IOSTREAM_WRITER_H
+#define INCLUDED_IOSTREAM_WRITER_H
+
+#include <assimp/IOStream.hpp>
+#include <assimp/Compiler/pstdint.h>
+#include "Exceptional.h"
+
+#include <rapidjson/internal/dtoa.h>
+
+#include <float.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** Write the shortest decimal representation of a float that reads back to
+ *  the same value. The digits come from Grisu2, run on the rounding interval
+ *  of the float rather than that of the double it widens to, so 0.1f is
+ *  written as "0.1" and not as "0.100000001490116".
+ *  The format never depends on the current locale. Up to 16 characters are
+ *  written, no terminating zero.
+ *  @return pointer behind the last character written */
+inline char* ai_ftoa_shortest(char* out, float value)
+{
+    union {
+        float f;
+        uint32_t u;
+    } bits;
+    bits.f = value;
+
+    const uint32_t mantissa = bits.u & 0x7FFFFFu;
+    const int biased = static_cast<int>((bits.u >> 23) & 0xFFu);
+    if (bits.u >> 31) {
+        *out++ = '-';
+    }
+    if (biased == 0xFF) {
+        const char* s = mantissa ? "nan" : "inf";
+        ::memcpy(out, s, 3);
+        return out + 3;
+    }
+    if (biased == 0 && mantissa == 0) {
+        *out++ = '0';
+        return out;
+    }
+
+    using namespace rapidjson::internal;
+
+    // boundaries halfway to the neighbouring floats, the lower one is closer
+    // if the value is a power of two
+    const uint64_t f = biased ? (mantissa | 0x800000u) : mantissa;
+    const int e = biased ? biased - 150 : -149;
+    const DiyFp v = DiyFp(f, e).Normalize();
+    const DiyFp w_p = DiyFp((f << 1) + 1, e - 1).Normalize();
+    DiyFp w_m = (mantissa == 0 && biased > 1) ? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+    w_m.f <<= w_m.e - w_p.e;
+    w_m.e = w_p.e;
+
+    int length, K;
+    const DiyFp c_mk = GetCachedPower(w_p.e, &K);
+    const DiyFp W = v * c_mk;
+    DiyFp Wp = w_p * c_mk;
+    DiyFp Wm = w_m * c_mk;
+    Wm.f++;
+    Wp.f--;
+    DigitGen(W, Wp, Wp.f - Wm.f, out, &length, &K);
+
+    // place the decimal point. Plain notation is used for anything from 1e-5
+    // to 1e9, everything else gets an exponent
+    const int kk = length + K; // 10^(kk-1) <= value < 10^kk
+    if (length <= kk && kk <= 9) {
+        // 123e2 -> 12300
+        for (int i = length; i < kk; ++i) {
+            out[i] = '0';
+        }
+        return out + kk;
+    }
+    if (0 < kk && kk <= 9) {
+        // 1234e-2 -> 12.34
+        ::memmove(out + kk + 1, out + kk, length - kk);
+        out[kk] = '.';
+        return out + length + 1;
+    }
+    if (-5 < kk && kk <= 0) {
+        // 1234e-6 -> 0.001234
+        const int offset = 2 - kk;
+        ::memmove(out + offset, out, length);
+        out[0] = '0';
+        out[1] = '.';
+        for (int i = 2; i < offset; ++i) {
+            out[i] = '0';
+        }
+        return out + length + offset;
+    }
+    if (length == 1) {
+        // 1e30
+        out[1] = 'e';
+        return WriteExponent(kk - 1, out + 2);
+    }
+    // 1234e30 -> 1.234e33
+    ::memmove(out + 2, out + 1, length - 1);
+    out[1] = '.';
+    out[length + 1] = 'e';
+    return WriteExponent(kk - 1, out + length + 2);
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Same as ai_ftoa_shortest() for doubles. Up to 25 characters are written.
+ *  @return pointer behind the last character written */
+inline char* ai_dtoa_shortest(char* out, double value)
+{
+    if (value - value != 0.0 || value == 0.0) {
+        // zero, nan or inf
+        return ai_ftoa_shortest(out, static_cast<float>(value));
+    }
+    const double a = value < 0.0 ? -value : value;
+    if (a >= FLT_MIN && a <= FLT_MAX && static_cast<double>(static_cast<float>(value)) == value) {
+        // exactly representable, keep the shorter float digits
+        return ai_ftoa_shortest(out, static_cast<float>(value));
+    }
+    char* end = rapidjson::internal::dtoa(value, out);
+    if (end[-1] == '0' && end[-2] == '.') {
+        end -= 2;
+    }
+    return end;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Usage:
+@code
+std::unique_ptr<IOStream> file(pIOSystem->Open(pFile, "wt"));
+IOStreamWriter out(file.get());
+out << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
+out.flush();
+@endcode
+
+A drop-in for the std::ostringstream the exporters used to collect their
+output in. Output goes to the stream whenever the block fills up, so the
+memory used is one block whatever the size of the file. Numbers are
+formatted without iostreams and without a locale: integers as plain
+decimals, floats with the shortest digits that read back to the same value
+(see ai_ftoa_shortest()).
+
+Call flush() once everything is written, it reports a failed write as a
+DeadlyExportError. The destructor drops whatever is still buffered, so an
+exporter that bails out with an exception doesn't end its file with a
+half-written block. */
+// ------------------------------------------------------------------------------------------------
+class IOStreamWriter
+{
+public:
+    static const size_t DefaultBlockSize = 64 * 1024;
+
+public:
+
+    // -----------------------------------------
+    /** construct from an open stream, which stays owned by the caller */
+    explicit IOStreamWriter(IOStream* stream, size_t blockSize = DefaultBlockSize)
+        : stream(stream)
+        , block(blockSize > 64 ? blockSize : 64)
+        , blockPos(0)
+    {
+    }
+
+public:
+
+    // -----------------------------------------
+    /** hand the buffered bytes to the stream */
+    void flush() {
+        if (!blockPos) {
+            return;
+        }
+        const size_t count = blockPos;
+        blockPos = 0;
+        if (stream->Write(&block[0], 1, count) != count) {
+            throw DeadlyExportError("Unable to write to the output file");
+        }
+    }
+
+    // -----------------------------------------
+    /** append raw bytes, e.g. for binary formats */
+    IOStreamWriter& write(const char* data, size_t size) {
+        if (size > block.size() - blockPos) {
+            flush();
+            if (size >= block.size()) {
+                // too large to be worth the copy
+                if (stream->Write(data, 1, size) != size) {
+                    throw DeadlyExportError("Unable to write to the output file");
+                }
+                return *this;
+            }
+        }
+        ::memcpy(&block[blockPos], data, size);
+        blockPos += size;
+        return *this;
+    }
+
+public:
+
+    IOStreamWriter& operator << (const char* s) {
+        return write(s, ::strlen(s));
+    }
+
+    IOStreamWriter& operator << (const std::string& s) {
+        return write(s.data(), s.length());
+    }
+
+    IOStreamWriter& operator << (char c) {
+        if (blockPos == block.size()) {
+            flush();
+        }
+        block[blockPos++] = c;
+        return *this;
+    }
+
+    IOStreamWriter& operator << (int v)                { return writeSigned(v); }
+    IOStreamWriter& operator << (long v)               { return writeSigned(v); }
+    IOStreamWriter& operator << (long long v)          { return writeSigned(v); }
+    IOStreamWriter& operator << (unsigned int v)       { return writeUnsigned(v); }
+    IOStreamWriter& operator << (unsigned long v)      { return writeUnsigned(v); }
+    IOStreamWriter& operator << (unsigned long long v) { return writeUnsigned(v); }
+
+    IOStreamWriter& operator << (float v) {
+        char* out = reserve(16);
+        blockPos = ai_ftoa_shortest(out, v) - &block[0];
+        return *this;
+    }
+
+    IOStreamWriter& operator << (double v) {
+        char* out = reserve(25);
+        blockPos = ai_dtoa_shortest(out, v) - &block[0];
+        return *this;
+    }
+
+private:
+
+    // -----------------------------------------
+    /** make room for at least count bytes at the end of the block */
+    char* reserve(size_t count) {
+        if (count > block.size() - blockPos) {
+            flush();
+        }
+        return &block[blockPos];
+    }
+
+    // -----------------------------------------
+    IOStreamWriter& writeSigned(long long v) {
+        if (v < 0) {
+            *this << '-';
+            return writeUnsigned(0ull - static_cast<unsigned long long>(v));
+        }
+        return writeUnsigned(static_cast<unsigned long long>(v));
+    }
+
+    // -----------------------------------------
+    IOStreamWriter& writeUnsigned(unsigned long long v) {
+        char digits[20];
+        char* p = digits + sizeof(digits);
+        do {
+            *--p = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v);
+        return write(p, digits + sizeof(digits) - p);
+    }
+
+private:
+
+    IOStream* stream;
+    std::vector<char> block;
+    size_t blockPos;
+};
+
+} // Namespace Assimp
+
+#endif // INCLUDED_IOSTREAM_WRITER_H
@@ -182,6 +182,9 @@ corresponding preprocessor flag to selectively disable formats.
 #ifndef ASSIMP_BUILD_NO_3MF_IMPORTER
 #   include "D3MFImporter.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_N3PMESH_IMPORTER
+#   include "N3PMeshLoader.h"
+#endif
 
 namespace Assimp {
 
@@ -325,6 +328,9 @@ void GetImporterInstanceList(std::vector< BaseImporter* >& out)
 #if ( !defined ASSIMP_BUILD_NO_3MF_IMPORTER )
     out.push_back(new D3MFImporter() );
 #endif
+#if ( !defined ASSIMP_BUILD_NO_N3PMESH_IMPORTER )
+    out.push_back( new N3PMeshImporter() );
+#endif
 }
 
 /** will delete all registered importers. */
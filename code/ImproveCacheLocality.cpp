@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // internal headers
 #include "ImproveCacheLocality.h"
 #include "VertexTriangleAdjacency.h"
+#include "ParallelProcess.h"
 #include "StringUtils.h"
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
@@ -64,6 +65,7 @@ using namespace Assimp;
 // Constructor to be privately used by Importer
 ImproveCacheLocalityProcess::ImproveCacheLocalityProcess() {
     configCacheDepth = PP_ICL_PTCACHE_SIZE;
+    configNumThreads = 1;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -86,6 +88,8 @@ void ImproveCacheLocalityProcess::SetupProperties(const Importer* pImp)
 {
     // AI_CONFIG_PP_ICL_PTCACHE_SIZE controls the target cache size for the optimizer
     configCacheDepth = pImp->GetPropertyInteger(AI_CONFIG_PP_ICL_PTCACHE_SIZE,PP_ICL_PTCACHE_SIZE);
+
+    configNumThreads = GetPostProcessThreadCount(pImp);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -99,10 +103,15 @@ void ImproveCacheLocalityProcess::Execute( aiScene* pScene)
 
     DefaultLogger::get()->debug("ImproveCacheLocalityProcess begin");
 
+    std::vector<float> results(pScene->mNumMeshes,0.f);
+    ParallelForEachMesh(pScene,configNumThreads,[&](unsigned int a) {
+        results[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
     float out = 0.f;
     unsigned int numf = 0, numm = 0;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++){
-        const float res = ProcessMesh( pScene->mMeshes[a],a);
+        const float res = results[a];
         if (res) {
             numf += pScene->mMeshes[a]->mNumFaces;
             out  += res;
@@ -91,6 +91,9 @@ private:
     //! Configuration parameter: specifies the size of the cache to
     //! optimize the vertex data for.
     unsigned int configCacheDepth;
+
+    //! Number of threads the meshes are distributed on
+    unsigned int configNumThreads;
 };
 
 } // end of namespace Assimp
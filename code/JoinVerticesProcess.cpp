@@ -48,14 +48,20 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "JoinVerticesProcess.h"
 #include "ProcessHelper.h"
+#include "ParallelProcess.h"
 #include "Vertex.h"
 #include "TinyFormatter.h"
+#include <assimp/Importer.hpp>
+#include <cmath>
 #include <stdio.h>
+#include <string.h>
 
 using namespace Assimp;
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 JoinVerticesProcess::JoinVerticesProcess()
+: configHashed( false )
+, configNumThreads( 1 )
 {
     // nothing to do here
 }
@@ -73,6 +79,14 @@ bool JoinVerticesProcess::IsActive( unsigned int pFlags) const
 {
     return (pFlags & aiProcess_JoinIdenticalVertices) != 0;
 }
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void JoinVerticesProcess::SetupProperties(const Importer* pImp)
+{
+    configHashed = pImp->GetPropertyInteger(AI_CONFIG_PP_JIV_HASHED,0) != 0;
+    configNumThreads = GetPostProcessThreadCount(pImp);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void JoinVerticesProcess::Execute( aiScene* pScene)
@@ -87,10 +101,14 @@ void JoinVerticesProcess::Execute( aiScene* pScene)
         }
     }
 
-    // execute the step
+    // execute the step, the meshes are independent of each other
+    std::vector<int> numVertices(pScene->mNumMeshes,0);
+    ParallelForEachMesh(pScene,configNumThreads,[&](unsigned int a) {
+        numVertices[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
     int iNumVertices = 0;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        iNumVertices += ProcessMesh( pScene->mMeshes[a],a);
+        iNumVertices += numVertices[a];
 
     // if logging is active, print detailed statistics
     if (!DefaultLogger::isNullLogger())
@@ -113,33 +131,54 @@ void JoinVerticesProcess::Execute( aiScene* pScene)
 }
 
 // ------------------------------------------------------------------------------------------------
-// Unites identical vertices in the given mesh
-int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
-{
-    static_assert( AI_MAX_NUMBER_OF_COLOR_SETS    == 8, "AI_MAX_NUMBER_OF_COLOR_SETS    == 8");
-	static_assert( AI_MAX_NUMBER_OF_TEXTURECOORDS == 8, "AI_MAX_NUMBER_OF_TEXTURECOORDS == 8");
+// Vertices closer than this in every attribute are considered identical
+static const float epsilon = 1e-5f;
 
-    // Return early if we don't have any positions
-    if (!pMesh->HasPositions() || !pMesh->HasFaces()) {
-        return 0;
-    }
-
-    // We'll never have more vertices afterwards.
-    std::vector<Vertex> uniqueVertices;
-    uniqueVertices.reserve( pMesh->mNumVertices);
+// Squared because we check against squared length of the vector difference
+static const float squareEpsilon = epsilon * epsilon;
 
-    // For each vertex the index of the vertex it was replaced by.
-    // Since the maximal number of vertices is 2^31-1, the most significand bit can be used to mark
-    //  whether a new vertex was created for the index (true) or if it was replaced by an existing
-    //  unique vertex (false). This saves an additional std::vector<bool> and greatly enhances
-    //  branching performance.
-    static_assert(AI_MAX_VERTICES == 0x7fffffff, "AI_MAX_VERTICES == 0x7fffffff");
-    std::vector<unsigned int> replaceIndex( pMesh->mNumVertices, 0xffffffff);
+// ------------------------------------------------------------------------------------------------
+// Compares all attributes of two vertices except for their positions
+static bool AreAttributesEqual( const Vertex& uv, const Vertex& v, bool complex)
+{
+    // We just test the other attributes even if they're not present in the mesh.
+    // In this case they're initialized to 0 so the comparison succeeds.
+    // By this method the non-present attributes are effectively ignored in the comparison.
+    if( (uv.normal - v.normal).SquareLength() > squareEpsilon)
+        return false;
+    if( (uv.texcoords[0] - v.texcoords[0]).SquareLength() > squareEpsilon)
+        return false;
+    if( (uv.tangent - v.tangent).SquareLength() > squareEpsilon)
+        return false;
+    if( (uv.bitangent - v.bitangent).SquareLength() > squareEpsilon)
+        return false;
+
+    // Usually we won't have vertex colors or multiple UVs, so we can skip from here
+    // Actually this increases runtime performance slightly, at least if branch
+    // prediction is on our side.
+    if (complex){
+        // Colors and UV coords are interleaved since the higher entries are most
+        // likely to be zero and thus useless. By interleaving the arrays, vertices
+        // are, on average, rejected earlier.
+        for (unsigned int i = 1; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+            if( (uv.texcoords[i] - v.texcoords[i]).SquareLength() > squareEpsilon)
+                return false;
+            if( GetColorDifference( uv.colors[i-1], v.colors[i-1]) > squareEpsilon)
+                return false;
+        }
+        if( GetColorDifference( uv.colors[7], v.colors[7]) > squareEpsilon)
+            return false;
+    }
+    return true;
+}
 
+// ------------------------------------------------------------------------------------------------
+// Fills uniqueVertices and replaceIndex using a SpatialSort to find vertices at the same position
+void JoinVerticesProcess::FindUniqueVerticesSorted( aiMesh* pMesh, unsigned int meshIndex, bool complex,
+    std::vector<Vertex>& uniqueVertices, std::vector<unsigned int>& replaceIndex)
+{
     // A little helper to find locally close vertices faster.
     // Try to reuse the lookup table from the last step.
-    const static float epsilon = 1e-5f;
-    // float posEpsilonSqr;
     SpatialSort* vertexFinder = NULL;
     SpatialSort _vertexFinder;
 
@@ -150,27 +189,18 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         if (avf)    {
             SpatPair& blubb = (*avf)[meshIndex];
             vertexFinder  = &blubb.first;
-            // posEpsilonSqr = blubb.second;
         }
     }
     if (!vertexFinder)  {
         // bad, need to compute it.
         _vertexFinder.Fill(pMesh->mVertices, pMesh->mNumVertices, sizeof( aiVector3D));
         vertexFinder = &_vertexFinder;
-        // posEpsilonSqr = ComputePositionEpsilon(pMesh);
     }
 
-    // Squared because we check against squared length of the vector difference
-    static const float squareEpsilon = epsilon * epsilon;
-
     // Again, better waste some bytes than a realloc ...
     std::vector<unsigned int> verticesFound;
     verticesFound.reserve(10);
 
-    // Run an optimized code path if we don't have multiple UVs or vertex colors.
-    // This should yield false in more than 99% of all imports ...
-    const bool complex = ( pMesh->GetNumColorChannels() > 0 || pMesh->GetNumUVChannels() > 1);
-
     // Now check each vertex if it brings something new to the table
     for( unsigned int a = 0; a < pMesh->mNumVertices; a++)  {
         // collect the vertex data
@@ -188,69 +218,9 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
             if( uidx & 0x80000000)
                 continue;
 
-            const Vertex& uv = uniqueVertices[ uidx];
             // Position mismatch is impossible - the vertex finder already discarded all non-matching positions
-
-            // We just test the other attributes even if they're not present in the mesh.
-            // In this case they're initialized to 0 so the comparison succeeds.
-            // By this method the non-present attributes are effectively ignored in the comparison.
-            if( (uv.normal - v.normal).SquareLength() > squareEpsilon)
+            if( !AreAttributesEqual( uniqueVertices[ uidx], v, complex))
                 continue;
-            if( (uv.texcoords[0] - v.texcoords[0]).SquareLength() > squareEpsilon)
-                continue;
-            if( (uv.tangent - v.tangent).SquareLength() > squareEpsilon)
-                continue;
-            if( (uv.bitangent - v.bitangent).SquareLength() > squareEpsilon)
-                continue;
-
-            // Usually we won't have vertex colors or multiple UVs, so we can skip from here
-            // Actually this increases runtime performance slightly, at least if branch
-            // prediction is on our side.
-            if (complex){
-                // manually unrolled because continue wouldn't work as desired in an inner loop,
-                // also because some compilers seem to fail the task. Colors and UV coords
-                // are interleaved since the higher entries are most likely to be
-                // zero and thus useless. By interleaving the arrays, vertices are,
-                // on average, rejected earlier.
-
-                if( (uv.texcoords[1] - v.texcoords[1]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[0], v.colors[0]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[2] - v.texcoords[2]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[1], v.colors[1]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[3] - v.texcoords[3]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[2], v.colors[2]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[4] - v.texcoords[4]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[3], v.colors[3]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[5] - v.texcoords[5]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[4], v.colors[4]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[6] - v.texcoords[6]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[5], v.colors[5]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[7] - v.texcoords[7]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[6], v.colors[6]) > squareEpsilon)
-                    continue;
-
-                if( GetColorDifference( uv.colors[7], v.colors[7]) > squareEpsilon)
-                    continue;
-            }
 
             // we're still here -> this vertex perfectly matches our given vertex
             matchIndex = uidx;
@@ -270,6 +240,177 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
             uniqueVertices.push_back( v);
         }
     }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Maps a vertex component to the integer index of its epsilon-sized grid cell
+static inline uint64_t QuantizeComponent( float f)
+{
+    const double q = std::floor( static_cast<double>( f) / epsilon);
+    if (q > -9.0e18 && q < 9.0e18) {
+        return static_cast<uint64_t>( static_cast<int64_t>( q));
+    }
+    // out of range, infinite or NaN - these only ever match bit-identical values
+    uint32_t bits;
+    ::memcpy( &bits, &f, sizeof( bits));
+    return 0xfff0000000000000ull | bits;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns the bits of a float with -0 folded into +0, for hashing values which must match exactly
+static inline uint64_t ExactComponent( float f)
+{
+    if (f == 0.f) {
+        return 0;
+    }
+    uint32_t bits;
+    ::memcpy( &bits, &f, sizeof( bits));
+    return bits;
+}
+
+// ------------------------------------------------------------------------------------------------
+static inline void HashCombine( uint64_t& seed, uint64_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+// ------------------------------------------------------------------------------------------------
+static inline void HashVector( uint64_t& seed, const aiVector3D& v)
+{
+    HashCombine( seed, QuantizeComponent( v.x));
+    HashCombine( seed, QuantizeComponent( v.y));
+    HashCombine( seed, QuantizeComponent( v.z));
+}
+
+// ------------------------------------------------------------------------------------------------
+static inline void HashColor( uint64_t& seed, const aiColor4D& c)
+{
+    HashCombine( seed, QuantizeComponent( c.r));
+    HashCombine( seed, QuantizeComponent( c.g));
+    HashCombine( seed, QuantizeComponent( c.b));
+    HashCombine( seed, QuantizeComponent( c.a));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Fills uniqueVertices and replaceIndex using an open addressing hash table. Every vertex is
+// hashed by its exact position and the grid cells its other quantized attributes fall into, and
+// only vertices with the same hash are compared. The SpatialSort search allows positions to be a
+// few ULPs apart and attributes to be closer than epsilon across cell boundaries, so this can
+// keep a few more vertices than the SpatialSort search does, but never less.
+void JoinVerticesProcess::FindUniqueVerticesHashed( aiMesh* pMesh, bool complex,
+    std::vector<Vertex>& uniqueVertices, std::vector<unsigned int>& replaceIndex)
+{
+    // Only the channels which are present take part in the hash, absent ones are zero anyway
+    unsigned int numUVs = 0, numColors = 0;
+    if (complex) {
+        numUVs    = pMesh->GetNumUVChannels();
+        numColors = pMesh->GetNumColorChannels();
+    }
+    else if (pMesh->HasTextureCoords(0)) {
+        numUVs = 1;
+    }
+
+    // Keep the table at most half full so probe sequences stay short
+    size_t tableSize = 16;
+    while (tableSize < static_cast<size_t>( pMesh->mNumVertices) * 2) {
+        tableSize <<= 1;
+    }
+    const size_t tableMask = tableSize - 1;
+    std::vector<unsigned int> table( tableSize, 0xffffffff);
+
+    // Hash of each unique vertex, checked before the attributes are compared
+    std::vector<uint64_t> uniqueHashes;
+    uniqueHashes.reserve( pMesh->mNumVertices);
+
+    for( unsigned int a = 0; a < pMesh->mNumVertices; a++)  {
+        Vertex v(pMesh,a);
+
+        uint64_t hash = 0;
+        HashCombine( hash, ExactComponent( v.position.x));
+        HashCombine( hash, ExactComponent( v.position.y));
+        HashCombine( hash, ExactComponent( v.position.z));
+        if (pMesh->mNormals) {
+            HashVector( hash, v.normal);
+        }
+        if (pMesh->mTangents) {
+            HashVector( hash, v.tangent);
+            HashVector( hash, v.bitangent);
+        }
+        for (unsigned int i = 0; i < numUVs; ++i) {
+            HashVector( hash, v.texcoords[i]);
+        }
+        for (unsigned int i = 0; i < numColors; ++i) {
+            HashColor( hash, v.colors[i]);
+        }
+
+        // final avalanche so the low bits used for the table index depend on all input bits
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+
+        unsigned int matchIndex = 0xffffffff;
+        size_t slot = static_cast<size_t>( hash) & tableMask;
+        for (; table[slot] != 0xffffffff; slot = (slot + 1) & tableMask) {
+            const unsigned int uidx = table[slot];
+            if (uniqueHashes[uidx] != hash) {
+                continue;
+            }
+            const Vertex& uv = uniqueVertices[uidx];
+            if (uv.position != v.position) {
+                continue;
+            }
+            if (AreAttributesEqual( uv, v, complex)) {
+                matchIndex = uidx;
+                break;
+            }
+        }
+
+        if( matchIndex != 0xffffffff) {
+            replaceIndex[a] = matchIndex | 0x80000000;
+        }
+        else {
+            // slot is the empty entry that ended the probe sequence
+            replaceIndex[a] = (unsigned int)uniqueVertices.size();
+            table[slot] = replaceIndex[a];
+            uniqueHashes.push_back( hash);
+            uniqueVertices.push_back( v);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Unites identical vertices in the given mesh
+int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
+{
+    static_assert( AI_MAX_NUMBER_OF_COLOR_SETS    == 8, "AI_MAX_NUMBER_OF_COLOR_SETS    == 8");
+	static_assert( AI_MAX_NUMBER_OF_TEXTURECOORDS == 8, "AI_MAX_NUMBER_OF_TEXTURECOORDS == 8");
+
+    // Return early if we don't have any positions
+    if (!pMesh->HasPositions() || !pMesh->HasFaces()) {
+        return 0;
+    }
+
+    // We'll never have more vertices afterwards.
+    std::vector<Vertex> uniqueVertices;
+    uniqueVertices.reserve( pMesh->mNumVertices);
+
+    // For each vertex the index of the vertex it was replaced by.
+    // Since the maximal number of vertices is 2^31-1, the most significand bit can be used to mark
+    //  whether a new vertex was created for the index (true) or if it was replaced by an existing
+    //  unique vertex (false). This saves an additional std::vector<bool> and greatly enhances
+    //  branching performance.
+    static_assert(AI_MAX_VERTICES == 0x7fffffff, "AI_MAX_VERTICES == 0x7fffffff");
+    std::vector<unsigned int> replaceIndex( pMesh->mNumVertices, 0xffffffff);
+
+    // Run an optimized code path if we don't have multiple UVs or vertex colors.
+    // This should yield false in more than 99% of all imports ...
+    const bool complex = ( pMesh->GetNumColorChannels() > 0 || pMesh->GetNumUVChannels() > 1);
+
+    if (configHashed) {
+        FindUniqueVerticesHashed( pMesh, complex, uniqueVertices, replaceIndex);
+    } else {
+        FindUniqueVerticesSorted( pMesh, meshIndex, complex, uniqueVertices, replaceIndex);
+    }
 
     if (!DefaultLogger::isNullLogger() && DefaultLogger::get()->getLogSeverity() == Logger::VERBOSE)    {
         DefaultLogger::get()->debug((Formatter::format(),
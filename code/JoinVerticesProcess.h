@@ -45,11 +45,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BaseProcess.h"
 #include <assimp/types.h>
+#include <vector>
 
 struct aiMesh;
 
 namespace Assimp
 {
+class Vertex;
 
 // ---------------------------------------------------------------------------
 /** The JoinVerticesProcess unites identical vertices in all imported meshes.
@@ -75,6 +77,13 @@ public:
     */
     bool IsActive( unsigned int pFlags) const;
 
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
     // -------------------------------------------------------------------
     /** Executes the post processing step on the given imported data.
     * At the moment a process is not supposed to fail.
@@ -91,6 +100,25 @@ public:
     int ProcessMesh( aiMesh* pMesh, unsigned int meshIndex);
 
 private:
+    // -------------------------------------------------------------------
+    /** Finds the unique vertices of a mesh with a SpatialSort, the
+     *  default search.
+     */
+    void FindUniqueVerticesSorted( aiMesh* pMesh, unsigned int meshIndex, bool complex,
+        std::vector<Vertex>& uniqueVertices, std::vector<unsigned int>& replaceIndex);
+
+    // -------------------------------------------------------------------
+    /** Finds the unique vertices of a mesh with a hash table of
+     *  quantized vertex attributes, see #AI_CONFIG_PP_JIV_HASHED.
+     */
+    void FindUniqueVerticesHashed( aiMesh* pMesh, bool complex,
+        std::vector<Vertex>& uniqueVertices, std::vector<unsigned int>& replaceIndex);
+
+    /** Configuration option: use the hash table search */
+    bool configHashed;
+
+    /** Number of threads the meshes are distributed on */
+    unsigned int configNumThreads;
 };
 
 } // end of namespace Assimp
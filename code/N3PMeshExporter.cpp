@@ -0,0 +1,201 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+#ifndef ASSIMP_BUILD_NO_EXPORT
+#ifndef ASSIMP_BUILD_NO_N3PMESH_EXPORTER
+
+#include "N3PMeshExporter.h"
+#include "N3PMeshLoader.h"
+#include "Exceptional.h"
+#include <assimp/IOSystem.hpp>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/Exporter.hpp>
+#include <assimp/scene.h>
+#include <memory>
+
+using namespace Assimp;
+namespace Assimp    {
+
+namespace {
+
+    // Faces the format can take, everything else is left out
+    bool IsTriangle(const aiFace& face) {
+        return face.mNumIndices == 3;
+    }
+
+    unsigned int CountTriangles(const aiMesh& mesh) {
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < mesh.mNumFaces; ++i) {
+            count += IsTriangle(mesh.mFaces[i]) ? 1 : 0;
+        }
+        return count;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Worker function for exporting a scene to N3PMesh. Prototyped and registered in Exporter.cpp
+void ExportSceneN3PMesh(const char* pFile, IOSystem* pIOSystem, const aiScene* pScene, const ExportProperties* pProperties)
+{
+    std::shared_ptr<IOStream> outfile (pIOSystem->Open(pFile, "wb"));
+    if(!outfile) {
+        throw DeadlyExportError("Could not open output .n3pmesh file: " + std::string(pFile));
+    }
+
+    // Invoke the actual exporter
+    N3PMeshExporter exporter(outfile, pScene);
+}
+
+} // end of namespace Assimp
+
+// ------------------------------------------------------------------------------------------------
+N3PMeshExporter::N3PMeshExporter(std::shared_ptr<IOStream> outfile, const aiScene* scene)
+: scene(scene)
+, writer(outfile)
+{
+    // A mesh can hang off several nodes, each placement becomes its own copy
+    CollectInstances(scene->mRootNode, aiMatrix4x4());
+
+    uint64_t numVertices = 0, numIndices = 0;
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const aiMesh& mesh = *scene->mMeshes[instances[i].first];
+        numVertices += mesh.mNumVertices;
+        numIndices += 3 * CountTriangles(mesh);
+    }
+
+    if (!numIndices) {
+        throw DeadlyExportError("N3PMesh: The scene has no triangles to export");
+    }
+    if (numVertices > AI_N3PMESH_MAX_VERTICES) {
+        throw DeadlyExportError("N3PMesh: The scene has more vertices than 16 bit indices can address");
+    }
+
+    const std::string name = scene->mRootNode->mName.C_Str();
+    writer.PutI4(static_cast<int32_t>(name.length()));
+    for (std::string::const_iterator it = name.begin(); it != name.end(); ++it) {
+        writer.PutI1(*it);
+    }
+
+    // numCollapses, totalIndexChanges, then the vertex and index counts at
+    // their max and min, which are the same without collapses
+    writer.PutI4(0);
+    writer.PutI4(0);
+    writer.PutI4(static_cast<int32_t>(numVertices));
+    writer.PutI4(static_cast<int32_t>(numIndices));
+    writer.PutI4(static_cast<int32_t>(numVertices));
+    writer.PutI4(static_cast<int32_t>(numIndices));
+
+    for (size_t i = 0; i < instances.size(); ++i) {
+        WriteVertices(*scene->mMeshes[instances[i].first], instances[i].second);
+    }
+
+    unsigned int baseVertex = 0;
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const aiMesh& mesh = *scene->mMeshes[instances[i].first];
+        WriteIndices(mesh, baseVertex);
+        baseVertex += mesh.mNumVertices;
+    }
+
+    // LOD control value count
+    writer.PutI4(0);
+}
+
+// ------------------------------------------------------------------------------------------------
+void N3PMeshExporter::CollectInstances(const aiNode* node, const aiMatrix4x4& parentTransform)
+{
+    const aiMatrix4x4 transform = parentTransform * node->mTransformation;
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+        if (CountTriangles(*scene->mMeshes[node->mMeshes[i]])) {
+            instances.push_back(std::make_pair(node->mMeshes[i], transform));
+        }
+    }
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        CollectInstances(node->mChildren[i], transform);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void N3PMeshExporter::WriteVertices(const aiMesh& mesh, const aiMatrix4x4& transform)
+{
+    // normals go through the inverse transpose so non-uniform scales keep them
+    // perpendicular, untransformed ones are passed through as they are
+    const bool identity = transform.IsIdentity();
+    aiMatrix3x3 normalTransform = aiMatrix3x3(transform);
+    normalTransform.Inverse().Transpose();
+
+    const aiVector3D zero;
+    for (unsigned int i = 0; i < mesh.mNumVertices; ++i) {
+        aiVector3D pos = mesh.mVertices[i];
+        aiVector3D nor = mesh.mNormals ? mesh.mNormals[i] : zero;
+        if (!identity) {
+            pos = transform * pos;
+            nor = (normalTransform * nor).NormalizeSafe();
+        }
+        const aiVector3D& uv = mesh.mTextureCoords[0] ? mesh.mTextureCoords[0][i] : zero;
+
+        writer.PutF4(pos.x);
+        writer.PutF4(pos.y);
+        writer.PutF4(pos.z);
+        writer.PutF4(nor.x);
+        writer.PutF4(nor.y);
+        writer.PutF4(nor.z);
+
+        // the client samples its textures top-down
+        writer.PutF4(uv.x);
+        writer.PutF4(1.f - uv.y);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void N3PMeshExporter::WriteIndices(const aiMesh& mesh, unsigned int baseVertex)
+{
+    for (unsigned int i = 0; i < mesh.mNumFaces; ++i) {
+        const aiFace& face = mesh.mFaces[i];
+        if (!IsTriangle(face)) {
+            continue;
+        }
+        for (unsigned int k = 0; k < 3; ++k) {
+            writer.PutU2(static_cast<uint16_t>(baseVertex + face.mIndices[k]));
+        }
+    }
+}
+
+#endif // ASSIMP_BUILD_NO_N3PMESH_EXPORTER
+#endif // ASSIMP_BUILD_NO_EXPORT
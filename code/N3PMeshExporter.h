@@ -0,0 +1,91 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file N3PMeshExporter.h
+ * Knight Online N3PMesh Exporter Main Header
+ */
+#ifndef AI_N3PMESHEXPORTER_H_INC
+#define AI_N3PMESHEXPORTER_H_INC
+
+#include <memory>
+#include <vector>
+#include <utility>
+
+#include <assimp/matrix4x4.h>
+#include "StreamWriter.h"
+
+struct aiScene;
+struct aiMesh;
+struct aiNode;
+
+namespace Assimp
+{
+
+// ------------------------------------------------------------------------------------------------
+/** Helper class to export a given scene to a N3PMesh file.
+ *
+ *  Every triangle of the scene goes into the one mesh the format holds. The
+ *  mesh is written without edge collapses, so the client always draws it at
+ *  full detail; N3PMeshConverter's -import is what builds progressive ones. */
+// ------------------------------------------------------------------------------------------------
+class N3PMeshExporter
+{
+public:
+    N3PMeshExporter(std::shared_ptr<IOStream> outfile, const aiScene* pScene);
+
+private:
+
+    void CollectInstances(const aiNode* node, const aiMatrix4x4& parentTransform);
+    void WriteVertices(const aiMesh& mesh, const aiMatrix4x4& transform);
+    void WriteIndices(const aiMesh& mesh, unsigned int baseVertex);
+
+private:
+
+    const aiScene* const scene;
+    StreamWriterLE writer;
+
+    // every mesh reference in the node graph with its world transform
+    std::vector< std::pair<unsigned int, aiMatrix4x4> > instances;
+};
+
+}
+
+#endif
@@ -0,0 +1,333 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file  N3PMeshLoader.cpp
+ *  @brief Implementation of the N3PMesh importer class.
+ *  Written against CN3PMesh::Load() of the Knight Online client.
+ */
+
+
+#ifndef ASSIMP_BUILD_NO_N3PMESH_IMPORTER
+
+// internal headers
+#include "N3PMeshLoader.h"
+#include "StreamReader.h"
+#include "ByteSwapper.h"
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/scene.h>
+#include <assimp/IOSystem.hpp>
+#include <memory>
+
+
+using namespace Assimp;
+
+static const aiImporterDesc desc = {
+    "Knight Online N3PMesh Importer",
+    "",
+    "",
+    "",
+    aiImporterFlags_SupportBinaryFlavour,
+    0,
+    0,
+    0,
+    0,
+    "n3pmesh"
+};
+
+namespace {
+
+    // Bytes per record in the file
+    enum {
+        SIZE_VERTEX     = 32, // position, normal, uv
+        SIZE_INDEX      = 2,
+        SIZE_COLLAPSE   = 24, // five ints and a padded bool
+        SIZE_CHANGE     = 4,
+        SIZE_LODCTRL    = 8,  // distance and vertex count
+        SIZE_HEADER     = 24  // the six counts after the name
+    };
+
+    struct EdgeCollapse {
+        int32_t numIndicesToLose;
+        int32_t numIndicesToChange;
+        int32_t numVerticesToLose;
+        int32_t indexChanges;
+        int32_t collapseTo;
+        bool shouldCollapse;
+    };
+
+    // Size of a file whose counts are these, up to its LOD control values
+    uint64_t GetSizeWithoutLODs(int32_t nameLength, const int32_t* counts) {
+        return 4 + (uint64_t)nameLength + SIZE_HEADER
+            + (uint64_t)counts[2] * SIZE_VERTEX
+            + (uint64_t)counts[3] * SIZE_INDEX
+            + (uint64_t)counts[0] * SIZE_COLLAPSE
+            + (uint64_t)counts[1] * SIZE_CHANGE
+            + 4;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+N3PMeshImporter::N3PMeshImporter()
+{}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+N3PMeshImporter::~N3PMeshImporter()
+{}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the class can handle the format of the given file.
+bool N3PMeshImporter::CanRead( const std::string& pFile, IOSystem* pIOHandler, bool checkSig) const
+{
+    // first call - simple extension check
+    const std::string extension = GetExtension(pFile);
+    if (extension == "n3pmesh") {
+        return true;
+    }
+
+    // second call - there is no magic, but the counts in the header have
+    // to add up to the size of the file exactly
+    else if (!extension.length() || checkSig)   {
+        if (!pIOHandler) {
+            return true;
+        }
+
+        std::unique_ptr<IOStream> file(pIOHandler->Open(pFile, "rb"));
+        if (!file) {
+            return false;
+        }
+        const size_t fileSize = file->FileSize();
+
+        int32_t nameLength;
+        if (file->Read(&nameLength, 4, 1) != 1) {
+            return false;
+        }
+        AI_SWAP4(nameLength);
+        if (nameLength < 0 || (size_t)nameLength > fileSize) {
+            return false;
+        }
+
+        int32_t counts[6];
+        if (file->Seek(nameLength, aiOrigin_CUR) != aiReturn_SUCCESS || file->Read(counts, 4, 6) != 6) {
+            return false;
+        }
+        for (unsigned int i = 0; i < 6; ++i) {
+            AI_SWAP4(counts[i]);
+            if (counts[i] < 0) {
+                return false;
+            }
+        }
+        if (counts[2] == 0) {
+            return false;
+        }
+
+        const uint64_t size = GetSizeWithoutLODs(nameLength, counts);
+        if (size > fileSize) {
+            return false;
+        }
+
+        int32_t numLODs;
+        if (file->Seek((size_t)size - 4, aiOrigin_SET) != aiReturn_SUCCESS || file->Read(&numLODs, 4, 1) != 1) {
+            return false;
+        }
+        AI_SWAP4(numLODs);
+        return numLODs >= 0 && size + (uint64_t)numLODs * SIZE_LODCTRL == fileSize;
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+const aiImporterDesc* N3PMeshImporter::GetInfo () const
+{
+    return &desc;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Imports the given file into the given scene structure.
+void N3PMeshImporter::InternReadFile( const std::string& pFile,
+    aiScene* pScene, IOSystem* pIOHandler)
+{
+    StreamReaderLE stream(pIOHandler->Open(pFile,"rb"));
+
+    const int32_t nameLength = stream.GetI4();
+    if (nameLength < 0 || (unsigned int)nameLength > stream.GetRemainingSize()) {
+        throw DeadlyImportError("N3PMesh: Mesh name length is out of range");
+    }
+    std::string name(reinterpret_cast<const char*>(stream.GetPtr()), nameLength);
+    stream.IncPtr(nameLength);
+
+    // numCollapses, totalIndexChanges, maxNumVertices, maxNumIndices,
+    // minNumVertices, minNumIndices
+    int32_t counts[6];
+    for (unsigned int i = 0; i < 6; ++i) {
+        counts[i] = stream.GetI4();
+        if (counts[i] < 0) {
+            throw DeadlyImportError("N3PMesh: Negative element count in header of " + pFile);
+        }
+    }
+    const int32_t numCollapses = counts[0], totalIndexChanges = counts[1];
+    const int32_t numVertices = counts[2], numIndices = counts[3];
+    const int32_t minNumVertices = counts[4];
+
+    if (numVertices == 0 || numIndices == 0) {
+        throw DeadlyImportError("N3PMesh: No geometry in " + pFile);
+    }
+    if (numVertices > AI_N3PMESH_MAX_VERTICES) {
+        throw DeadlyImportError("N3PMesh: More vertices than 16 bit indices can address");
+    }
+    if (numIndices % 3) {
+        throw DeadlyImportError("N3PMesh: Index count is not a multiple of three");
+    }
+    if (GetSizeWithoutLODs(nameLength, counts) > (uint64_t)stream.GetCurrentPos() + stream.GetRemainingSize()) {
+        throw DeadlyImportError("N3PMesh: File is too small for the counts in its header");
+    }
+
+    // vertices go straight into the mesh, uvs are stored top-down
+    aiMesh* mesh = new aiMesh();
+    pScene->mMeshes = new aiMesh*[pScene->mNumMeshes = 1];
+    pScene->mMeshes[0] = mesh;
+
+    mesh->mName = name;
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mNumVertices = numVertices;
+    mesh->mVertices = new aiVector3D[numVertices];
+    mesh->mNormals = new aiVector3D[numVertices];
+    mesh->mTextureCoords[0] = new aiVector3D[numVertices];
+    mesh->mNumUVComponents[0] = 2;
+
+    for (int32_t i = 0; i < numVertices; ++i) {
+        aiVector3D& pos = mesh->mVertices[i];
+        aiVector3D& nor = mesh->mNormals[i];
+        aiVector3D& uv = mesh->mTextureCoords[0][i];
+
+        pos.x = stream.GetF4();
+        pos.y = stream.GetF4();
+        pos.z = stream.GetF4();
+        nor.x = stream.GetF4();
+        nor.y = stream.GetF4();
+        nor.z = stream.GetF4();
+        uv.x = stream.GetF4();
+        uv.y = 1.f - stream.GetF4();
+    }
+
+    std::vector<uint16_t> indices(numIndices);
+    for (int32_t i = 0; i < numIndices; ++i) {
+        indices[i] = stream.GetU2();
+    }
+
+    std::vector<EdgeCollapse> collapses(numCollapses);
+    for (int32_t i = 0; i < numCollapses; ++i) {
+        EdgeCollapse& c = collapses[i];
+        stream >> c.numIndicesToLose >> c.numIndicesToChange >> c.numVerticesToLose
+            >> c.indexChanges >> c.collapseTo;
+        c.shouldCollapse = stream.GetU1() != 0;
+        stream.IncPtr(3);
+    }
+
+    std::vector<int32_t> changes(totalIndexChanges);
+    for (int32_t i = 0; i < totalIndexChanges; ++i) {
+        changes[i] = stream.GetI4();
+        if (changes[i] < 0 || changes[i] >= numIndices) {
+            throw DeadlyImportError("N3PMesh: Index change points outside of the index buffer");
+        }
+    }
+
+    const int32_t numLODs = stream.GetI4();
+    if (numLODs < 0 || (uint64_t)numLODs * SIZE_LODCTRL > stream.GetRemainingSize()) {
+        throw DeadlyImportError("N3PMesh: LOD control value count is out of range");
+    }
+    if (numLODs * SIZE_LODCTRL != (int32_t)stream.GetRemainingSize()) {
+        DefaultLogger::get()->warn("N3PMesh: Ignoring trailing bytes at the end of the file");
+    }
+
+    // the file holds the indices in their simplest state, split every
+    // collapse again to get back to the full detail mesh
+    int32_t splitVertices = minNumVertices;
+    for (int32_t c = 0; c < numCollapses; ++c) {
+        const EdgeCollapse& collapse = collapses[c];
+
+        if (collapse.numIndicesToChange < 0 || collapse.indexChanges < 0 ||
+            collapse.indexChanges > totalIndexChanges - collapse.numIndicesToChange) {
+            throw DeadlyImportError("N3PMesh: Collapse refers to index changes that do not exist");
+        }
+
+        splitVertices += collapse.numVerticesToLose;
+        if (splitVertices < 1 || splitVertices > numVertices) {
+            throw DeadlyImportError("N3PMesh: Splitting the collapses runs past the vertex count");
+        }
+
+        for (int32_t i = 0; i < collapse.numIndicesToChange; ++i) {
+            indices[changes[collapse.indexChanges + i]] = (uint16_t)(splitVertices - 1);
+        }
+    }
+
+    mesh->mNumFaces = numIndices / 3;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+
+    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+        aiFace& face = mesh->mFaces[i];
+        face.mIndices = new unsigned int[face.mNumIndices = 3];
+
+        for (unsigned int k = 0; k < 3; ++k) {
+            const uint16_t index = indices[3 * i + k];
+            if (index >= numVertices) {
+                throw DeadlyImportError("N3PMesh: Vertex index out of range");
+            }
+            face.mIndices[k] = index;
+        }
+    }
+
+    // the format has no materials, the texture is picked by the .n3cplug
+    // or .n3cpart pointing at the mesh
+    aiMaterial* mat = new aiMaterial();
+    aiString matName(AI_DEFAULT_MATERIAL_NAME);
+    mat->AddProperty(&matName, AI_MATKEY_NAME);
+
+    pScene->mMaterials = new aiMaterial*[pScene->mNumMaterials = 1];
+    pScene->mMaterials[0] = mat;
+
+    pScene->mRootNode = new aiNode(name.length() ? name : "<N3PMesh>");
+    pScene->mRootNode->mMeshes = new unsigned int[pScene->mRootNode->mNumMeshes = 1];
+    pScene->mRootNode->mMeshes[0] = 0;
+}
+
+#endif
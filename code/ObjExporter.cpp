@@ -55,49 +55,46 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 using namespace Assimp;
+
+static const std::string MaterialExt = ".mtl";
+
 namespace Assimp    {
 
 // ------------------------------------------------------------------------------------------------
 // Worker function for exporting a scene to Wavefront OBJ. Prototyped and registered in Exporter.cpp
 void ExportSceneObj(const char* pFile,IOSystem* pIOSystem, const aiScene* pScene, const ExportProperties* pProperties)
 {
-    // invoke the exporter
-    ObjExporter exporter(pFile, pScene);
-
-    // we're still here - export successfully completed. Write both the main OBJ file and the material script
-    {
-        std::unique_ptr<IOStream> outfile (pIOSystem->Open(pFile,"wt"));
-        if(outfile == NULL) {
-            throw DeadlyExportError("could not open output .obj file: " + std::string(pFile));
-        }
-        outfile->Write( exporter.mOutput.str().c_str(), static_cast<size_t>(exporter.mOutput.tellp()),1);
+    // open both the main OBJ file and the material script, the exporter writes to them as it goes
+    std::unique_ptr<IOStream> outfile (pIOSystem->Open(pFile,"wt"));
+    if(outfile == NULL) {
+        throw DeadlyExportError("could not open output .obj file: " + std::string(pFile));
     }
-    {
-        std::unique_ptr<IOStream> outfile (pIOSystem->Open(exporter.GetMaterialLibFileName(),"wt"));
-        if(outfile == NULL) {
-            throw DeadlyExportError("could not open output .mtl file: " + std::string(exporter.GetMaterialLibFileName()));
-        }
-        outfile->Write( exporter.mOutputMat.str().c_str(), static_cast<size_t>(exporter.mOutputMat.tellp()),1);
+    const std::string matFile = std::string(pFile) + MaterialExt;
+    std::unique_ptr<IOStream> outfileMat (pIOSystem->Open(matFile,"wt"));
+    if(outfileMat == NULL) {
+        throw DeadlyExportError("could not open output .mtl file: " + matFile);
     }
+
+    IOStreamWriter out(outfile.get()), outMat(outfileMat.get());
+
+    // invoke the exporter
+    ObjExporter exporter(pFile, pScene, out, outMat);
+
+    // we're still here - export successfully completed
+    out.flush();
+    outMat.flush();
 }
 
 } // end of namespace Assimp
 
-static const std::string MaterialExt = ".mtl";
-
 // ------------------------------------------------------------------------------------------------
-ObjExporter :: ObjExporter(const char* _filename, const aiScene* pScene)
-: filename(_filename)
+ObjExporter :: ObjExporter(const char* _filename, const aiScene* pScene, IOStreamWriter& out, IOStreamWriter& outMat)
+: mOutput(out)
+, mOutputMat(outMat)
+, filename(_filename)
 , pScene(pScene)
 , endl("\n")
 {
-    // make sure that all formatting happens using the standard, C locale and not the user's current locale
-    const std::locale& l = std::locale("C");
-    mOutput.imbue(l);
-    mOutput.precision(16);
-    mOutputMat.imbue(l);
-    mOutputMat.precision(16);
-
     WriteGeometryFile();
     WriteMaterialFile();
 }
@@ -122,7 +119,7 @@ std::string ObjExporter :: GetMaterialLibFileName()
 }
 
 // ------------------------------------------------------------------------------------------------
-void ObjExporter :: WriteHeader(std::ostringstream& out)
+void ObjExporter :: WriteHeader(IOStreamWriter& out)
 {
     out << "# File produced by Open Asset Import Library (http://www.assimp.sf.net)" << endl;
     out << "# (assimp v" << aiGetVersionMajor() << '.' << aiGetVersionMinor() << '.' << aiGetVersionRevision() << ")" << endl  << endl;
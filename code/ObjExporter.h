@@ -45,7 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_OBJEXPORTER_H_INC
 
 #include <assimp/types.h>
-#include <sstream>
+#include "IOStreamWriter.h"
 #include <vector>
 #include <map>
 
@@ -62,8 +62,9 @@ namespace Assimp
 class ObjExporter
 {
 public:
-    /// Constructor for a specific scene to export
-    ObjExporter(const char* filename, const aiScene* pScene);
+    /// Constructor for a specific scene to export, the .obj and the .mtl
+    /// file are written to out and outMat while the scene is processed
+    ObjExporter(const char* filename, const aiScene* pScene, IOStreamWriter& out, IOStreamWriter& outMat);
 
 public:
 
@@ -72,8 +73,9 @@ public:
 
 public:
 
-    /// public stringstreams to write all output into
-    std::ostringstream mOutput, mOutputMat;
+    /// public writers to write all output into
+    IOStreamWriter& mOutput;
+    IOStreamWriter& mOutputMat;
 
 private:
 
@@ -100,7 +102,7 @@ private:
         std::vector<Face> faces;
     };
 
-    void WriteHeader(std::ostringstream& out);
+    void WriteHeader(IOStreamWriter& out);
 
     void WriteMaterialFile();
     void WriteGeometryFile();
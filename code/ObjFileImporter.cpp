@@ -46,8 +46,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ObjFileImporter.h"
 #include "ObjFileParser.h"
 #include "ObjFileData.h"
+#include "IOStreamBuffer.h"
+#include "MemoryIOWrapper.h"
 #include <memory>
+#include <algorithm>
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <thread>
+#endif
 #include <assimp/Importer.hpp>
+#include <assimp/config.h>
 #include <assimp/scene.h>
 #include <assimp/ai_assert.h>
 #include <assimp/DefaultLogger.hpp>
@@ -77,7 +84,8 @@ using namespace std;
 ObjFileImporter::ObjFileImporter() :
     m_Buffer(),
     m_pRootObject( NULL ),
-    m_strAbsPath( "" )
+    m_strAbsPath( "" ),
+    m_numThreads( 1 )
 {
     DefaultIOSystem io;
     m_strAbsPath = io.getOsSeparator();
@@ -112,6 +120,20 @@ const aiImporterDesc* ObjFileImporter::GetInfo () const
     return &desc;
 }
 
+// ------------------------------------------------------------------------------------------------
+//  Setup configuration properties for the loader
+void ObjFileImporter::SetupProperties(const Importer* pImp)
+{
+    // AI_CONFIG_IMPORT_OBJ_THREADS, serial unless asked otherwise, 0 is one per core
+    const int numThreads = pImp->GetPropertyInteger( AI_CONFIG_IMPORT_OBJ_THREADS, 1 );
+    m_numThreads = numThreads > 0 ? static_cast<unsigned int>( numThreads ) : 1;
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    if ( numThreads <= 0 ) {
+        m_numThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+#endif
+}
+
 // ------------------------------------------------------------------------------------------------
 //  Obj-file import implementation
 void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene, IOSystem* pIOHandler) {
@@ -128,8 +150,25 @@ void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene,
         throw DeadlyImportError( "OBJ-file is too small.");
     }
 
-    // Allocate buffer and read file into it
-    TextFileToBuffer( fileStream.get(),m_Buffer);
+    // The file is parsed straight from the stream, one block at a time. Only
+    // files in UTF-16 or UTF-32 have to be converted in memory first, a
+    // UTF-8 byte order mark is just skipped.
+    uint8_t bom[4] = { 0, 0, 0, 0 };
+    fileStream->Read( bom, 1, 4 );
+
+    std::unique_ptr<IOStream> convertedStream;
+    IOStream *stream = fileStream.get();
+    size_t offset = 0;
+    if ( bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF ) {
+        offset = 3;
+    } else if ( ( bom[0] == 0xFF && bom[1] == 0xFE ) || ( bom[0] == 0xFE && bom[1] == 0xFF ) ||
+            ( bom[0] == 0x00 && bom[1] == 0x00 && bom[2] == 0xFE && bom[3] == 0xFF ) ) {
+        fileStream->Seek( 0, aiOrigin_SET );
+        TextFileToBuffer( fileStream.get(), m_Buffer );
+        convertedStream.reset( new MemoryIOStream( reinterpret_cast<const uint8_t*>( &m_Buffer[ 0 ] ), m_Buffer.size() - 1 ) );
+        stream = convertedStream.get();
+    }
+    IOStreamBuffer<char> streamBuffer( stream, offset );
 
     // Get the model name
     std::string  modelName, folderName;
@@ -144,40 +183,8 @@ void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene,
         modelName = file;
     }
 
-    // This next stage takes ~ 1/3th of the total readFile task
-    // so should amount for 1/3th of the progress
-    // only update every 100KB or it'll be too slow
-    unsigned int progress = 0;
-    unsigned int progressCounter = 0;
-    const unsigned int updateProgressEveryBytes = 100 * 1024;
-    const unsigned int progressTotal = (3*m_Buffer.size()/updateProgressEveryBytes);
-    // process all '\'
-    std::vector<char> ::iterator iter = m_Buffer.begin();
-    while (iter != m_Buffer.end())
-    {
-        if (*iter == '\\')
-        {
-            // remove '\'
-            iter = m_Buffer.erase(iter);
-            // remove next character
-            while (*iter == '\r' || *iter == '\n')
-                iter = m_Buffer.erase(iter);
-        }
-        else
-            ++iter;
-
-        if (++progressCounter >= updateProgressEveryBytes)
-        {
-            m_progress->UpdateFileRead(++progress, progressTotal);
-            progressCounter = 0;
-        }
-    }
-
-    // 1/3rd progress
-    m_progress->UpdateFileRead(1, 3);
-
     // parse the file into a temporary representation
-    ObjFileParser parser(m_Buffer, modelName, pIOHandler, m_progress, file);
+    ObjFileParser parser(streamBuffer, modelName, pIOHandler, m_progress, file, m_numThreads);
 
     // And create the proper return structures out of it
     CreateDataFromImport(parser.GetModel(), pScene);
@@ -81,6 +81,9 @@ private:
     //! \brief  Appends the supported extension.
     const aiImporterDesc* GetInfo () const;
 
+    //! \brief  Reads the number of threads to parse on.
+    void SetupProperties(const Importer* pImp);
+
     //! \brief  File import implementation.
     void InternReadFile(const std::string& pFile, aiScene* pScene, IOSystem* pIOHandler);
 
@@ -112,12 +115,14 @@ private:
     void appendChildToParentNode(aiNode *pParent, aiNode *pChild);
 
 private:
-    //! Data buffer
+    //! Buffer for a file that must be converted to UTF-8 before parsing
     std::vector<char> m_Buffer;
     //! Pointer to root object instance
     ObjFile::Object *m_pRootObject;
     //! Absolute pathname of model in file system
     std::string m_strAbsPath;
+    //! Number of threads the parser runs on
+    unsigned int m_numThreads;
 };
 
 // ------------------------------------------------------------------------------------------------
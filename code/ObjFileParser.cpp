@@ -47,23 +47,279 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ObjTools.h"
 #include "ObjFileData.h"
 #include "ParsingUtils.h"
+#include "IOStreamBuffer.h"
 #include "DefaultIOSystem.h"
 #include "BaseImporter.h"
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/material.h>
 #include <assimp/Importer.hpp>
 #include <cstdlib>
+#include <algorithm>
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <exception>
+#   include <thread>
+#endif
 
 
 namespace Assimp {
 
 const std::string ObjFileParser::DEFAULT_MATERIAL = AI_DEFAULT_MATERIAL_NAME;
 
+namespace {
+
+// -------------------------------------------------------------------
+//  Copies the next word into a buffer and returns the position after it.
+template<class char_t>
+char_t copyWord( char_t it, char_t end, char *pBuffer, size_t length )
+{
+    size_t index = 0;
+    it = getNextWord<char_t>(it, end);
+    while( it != end && !IsSpaceOrNewLine( *it ) ) {
+        pBuffer[index] = *it;
+        index++;
+        if( index == length - 1 ) {
+            break;
+        }
+        ++it;
+    }
+
+    ai_assert(index < length);
+    pBuffer[index] = '\0';
+    return it;
+}
+
+// -------------------------------------------------------------------
+//  Counts the space separated components up to the end of the line.
+size_t countComponents( const char *tmp )
+{
+    size_t numComponents( 0 );
+    while( !IsLineEnd( *tmp ) ) {
+        if ( !SkipSpaces( &tmp ) ) {
+            break;
+        }
+        SkipToken( tmp );
+        ++numComponents;
+    }
+    return numComponents;
+}
+
 // -------------------------------------------------------------------
-//  Constructor with loaded data and directories.
-ObjFileParser::ObjFileParser(std::vector<char> &data, const std::string &modelName, IOSystem *io, ProgressHandler* progress, const std::string &originalObjFileName) :
-    m_DataIt(data.begin()),
-    m_DataItEnd(data.end()),
+//  Reads the next numComponents words as floats. The numbers are parsed in
+//  one batch, words the batch stops at (like numbers with trailing garbage)
+//  are converted one at a time as before. The line must end in a binary zero,
+//  end may lie behind it to give the batch room for its eight byte reads.
+const char *readFloats( const char *it, const char *end, float *values, unsigned int numComponents )
+{
+    unsigned int numParsed = numComponents;
+    it = fast_atoreal_array<float>( it, end, values, numParsed );
+
+    char word[ ObjFileParser::Buffersize ];
+    for ( unsigned int i = numParsed; i < numComponents; ++i ) {
+        it = copyWord<const char*>( it, end, word, ObjFileParser::Buffersize );
+        values[ i ] = fast_atof( word );
+    }
+    return it;
+}
+
+// -------------------------------------------------------------------
+//  Breaks a face, line or point statement into pairs of the slot each index
+//  was found in (0 vertex, 1 texture coordinate, 2 normal, anything higher
+//  is an error) and the index as written, so resolving relative indices can
+//  wait until the statement is stored. Returns false if the statement is
+//  empty.
+bool parseFaceTokens( const char *pPtr, const char *pEnd, aiPrimitiveType type, bool noTexCoords,
+        std::vector<int> &tokens, unsigned int &numSeparatorErrors )
+{
+    pPtr = getNextToken<const char*>(pPtr, pEnd);
+    if ( pPtr == pEnd || *pPtr == '\0' ) {
+        return false;
+    }
+
+    int iStep = 0, iPos = 0;
+    while (pPtr != pEnd) {
+        iStep = 1;
+
+        if ( IsLineEnd( *pPtr ) ) {
+            break;
+        }
+
+        if (*pPtr=='/' ) {
+            if (type == aiPrimitiveType_POINT) {
+                ++numSeparatorErrors;
+            }
+            if (iPos == 0) {
+                //if there are no texture coordinates in the file, but normals
+                if (noTexCoords) {
+                    iPos = 1;
+                    iStep++;
+                }
+            }
+            iPos++;
+        } else if( IsSpaceOrNewLine( *pPtr ) ) {
+            iPos = 0;
+        } else {
+            const int iVal( ::atoi( pPtr ) );
+
+            // increment iStep position based off of the sign and # of digits
+            int tmp = iVal;
+            if ( iVal < 0 ) {
+                ++iStep;
+            }
+            while ( ( tmp = tmp / 10 ) != 0 ) {
+                ++iStep;
+            }
+
+            if ( iVal != 0 ) {
+                tokens.push_back( iPos );
+                tokens.push_back( iVal );
+            }
+        }
+        pPtr += iStep;
+    }
+
+    return true;
+}
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+
+// Bytes of whole lines taken per batch, and the least number of lines a
+// worker thread is given
+const size_t ParallelBatchSize = 16 * 1024 * 1024;
+const size_t MinLinesPerThread = 4096;
+
+// What a worker thread made of a line
+enum LineKind {
+    LineOther,          // left to ObjFileParser::parseLine
+    LineVertex,
+    LineVertexColor,
+    LineTexCoord,
+    LineNormal,
+    LineFace
+};
+
+struct ParsedLine {
+    LineKind kind;
+    aiPrimitiveType type;
+    // the vector or the face tokens in the chunk, faces are tokenized both
+    // with ([1]) and without ([0]) the rule for files without texture
+    // coordinates since that depends on what comes before them
+    size_t first[2];
+    size_t count[2];
+    unsigned int numSeparatorErrors[2];
+};
+
+struct ParsedChunk {
+    std::vector<aiVector3D> vectors;
+    std::vector<int> tokens;
+    std::exception_ptr error;
+};
+
+// -------------------------------------------------------------------
+//  Reads the components of a vertex line the way ObjFileParser does.
+void readVectors( const char *it, const char *end, size_t numComponents, std::vector<aiVector3D> &vectors )
+{
+    float v[ 6 ] = { 0, 0, 0, 0, 0, 0 };
+    readFloats( it, end, v, static_cast<unsigned int>( numComponents ) );
+    vectors.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+    if ( numComponents == 6 ) {
+        vectors.push_back( aiVector3D( v[ 3 ], v[ 4 ], v[ 5 ] ) );
+    }
+}
+
+// -------------------------------------------------------------------
+//  Worker thread body, parses the vertex data and faces of the lines
+//  [begin, end) of a batch. Lines are stored one after another, each ending
+//  in a line end and a binary zero.
+void parseChunk( const std::vector<char> *batch, const std::vector<size_t> *lineStarts, size_t begin, size_t end,
+        ParsedLine *lines, ParsedChunk *chunk )
+{
+    try {
+        char buffer[ ObjFileParser::Buffersize ];
+        const char *pBatchEnd = &(*batch)[ 0 ] + batch->size();
+        for ( size_t l = begin; l < end; ++l ) {
+            const char *pLine = &(*batch)[ (*lineStarts)[ l ] ];
+            const char *pLineEnd = &(*batch)[ 0 ] + ( l + 1 < lineStarts->size() ? (*lineStarts)[ l + 1 ] : batch->size() );
+
+            ParsedLine &parsed = lines[ l ];
+            parsed.kind = LineOther;
+            parsed.first[ 0 ] = parsed.first[ 1 ] = 0;
+            parsed.count[ 0 ] = parsed.count[ 1 ] = 0;
+            parsed.numSeparatorErrors[ 0 ] = parsed.numSeparatorErrors[ 1 ] = 0;
+
+            if ( pLine[ 0 ] == 'v' ) {
+                const char *it = pLine + 1;
+                size_t numComponents = 0;
+                if ( *it == ' ' || *it == '\t' ) {
+                    numComponents = countComponents( it );
+                    if ( numComponents == 3 ) {
+                        parsed.kind = LineVertex;
+                    } else if ( numComponents == 6 ) {
+                        parsed.kind = LineVertexColor;
+                    }
+                } else if ( *it == 't' ) {
+                    numComponents = countComponents( ++it );
+                    if ( numComponents == 2 || numComponents == 3 ) {
+                        parsed.kind = LineTexCoord;
+                    }
+                } else if ( *it == 'n' ) {
+                    numComponents = countComponents( ++it );
+                    if ( numComponents == 3 ) {
+                        parsed.kind = LineNormal;
+                    }
+                }
+
+                if ( parsed.kind != LineOther ) {
+                    // the components are all on this line, reading ahead into
+                    // the next lines of the batch is fine
+                    parsed.first[ 0 ] = chunk->vectors.size();
+                    readVectors( it, pBatchEnd, numComponents, chunk->vectors );
+                }
+            } else if ( pLine[ 0 ] == 'f' || pLine[ 0 ] == 'l' || pLine[ 0 ] == 'p' ) {
+                // the same cut off line ObjFileParser::copyNextLine makes
+                size_t index = 0;
+                for ( const char *it = pLine; it != pLineEnd && index < ObjFileParser::Buffersize - 1; ++it ) {
+                    if ( *it == '\n' || *it == '\r' ) {
+                        break;
+                    }
+                    buffer[ index++ ] = *it;
+                }
+                buffer[ index ] = '\0';
+
+                parsed.type = pLine[ 0 ] == 'f' ? aiPrimitiveType_POLYGON : ( pLine[ 0 ] == 'l'
+                    ? aiPrimitiveType_LINE : aiPrimitiveType_POINT );
+
+                const bool hasSeparator = ( ::strchr( buffer, '/' ) != NULL );
+                for ( int rule = 0; rule < ( hasSeparator ? 2 : 1 ); ++rule ) {
+                    parsed.first[ rule ] = chunk->tokens.size();
+                    if ( !parseFaceTokens( buffer, &buffer[ ObjFileParser::Buffersize ], parsed.type, rule == 1,
+                            chunk->tokens, parsed.numSeparatorErrors[ rule ] ) ) {
+                        break;
+                    }
+                    parsed.count[ rule ] = chunk->tokens.size() - parsed.first[ rule ];
+                    parsed.kind = LineFace;
+                }
+                if ( !hasSeparator ) {
+                    parsed.first[ 1 ] = parsed.first[ 0 ];
+                    parsed.count[ 1 ] = parsed.count[ 0 ];
+                    parsed.numSeparatorErrors[ 1 ] = parsed.numSeparatorErrors[ 0 ];
+                }
+            }
+        }
+    } catch ( ... ) {
+        chunk->error = std::current_exception();
+    }
+}
+
+#endif // ASSIMP_BUILD_SINGLETHREADED
+
+}
+
+// -------------------------------------------------------------------
+//  Constructor with the stream to parse and directories.
+ObjFileParser::ObjFileParser(IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem *io, ProgressHandler* progress, const std::string &originalObjFileName, unsigned int numThreads) :
+    m_Line(),
+    m_DataIt(),
+    m_DataItEnd(),
     m_pModel(NULL),
     m_uiLine(0),
     m_pIO( io ),
@@ -83,7 +339,16 @@ ObjFileParser::ObjFileParser(std::vector<char> &data, const std::string &modelNa
     m_pModel->m_MaterialMap[ DEFAULT_MATERIAL ] = m_pModel->m_pDefaultMaterial;
 
     // Start parsing the file
-    parseFile();
+    reserveVertexArrays(streamBuffer);
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    if (numThreads > 1) {
+        parseFileParallel(streamBuffer, numThreads);
+        return;
+    }
+#else
+    (void)numThreads;
+#endif
+    parseFile(streamBuffer);
 }
 
 // -------------------------------------------------------------------
@@ -102,134 +367,287 @@ ObjFile::Model *ObjFileParser::GetModel() const
 }
 
 // -------------------------------------------------------------------
-//  File parsing method.
-void ObjFileParser::parseFile()
+//  Counts the vertex, texture coordinate and normal lines in one quick pass
+//  over the stream, so their arrays are allocated once at the right size
+//  instead of growing while the file is parsed.
+void ObjFileParser::reserveVertexArrays(IOStreamBuffer<char> &streamBuffer)
 {
-    if (m_DataIt == m_DataItEnd)
-        return;
+    enum { LineStart, AfterV, InLine } state = LineStart;
+    size_t numVertices = 0, numTextureCoords = 0, numNormals = 0;
 
-    // only update every 100KB or it'll be too slow
-    const unsigned int updateProgressEveryBytes = 100 * 1024;
-    unsigned int progressCounter = 0;
-    const unsigned int bytesToProcess = std::distance(m_DataIt, m_DataItEnd);
-    const unsigned int progressTotal = 3 * bytesToProcess;
-    const unsigned int progressOffset = bytesToProcess;
-    unsigned int processed = 0;
+    const char *data = NULL;
+    size_t count = 0;
+    while (streamBuffer.getNextBlock(data, count))
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const char c = data[i];
+            if (c == '\n' || c == '\r') {
+                state = LineStart;
+            } else if (state == LineStart) {
+                if (c != ' ' && c != '\t') {
+                    state = (c == 'v') ? AfterV : InLine;
+                }
+            } else if (state == AfterV) {
+                if (c == ' ' || c == '\t') {
+                    ++numVertices;
+                } else if (c == 't') {
+                    ++numTextureCoords;
+                } else if (c == 'n') {
+                    ++numNormals;
+                }
+                state = InLine;
+            }
+        }
+    }
+    streamBuffer.rewind();
 
-    DataArrayIt lastDataIt = m_DataIt;
+    m_pModel->m_Vertices.reserve(numVertices);
+    m_pModel->m_TextureCoord.reserve(numTextureCoords);
+    m_pModel->m_Normals.reserve(numNormals);
+}
 
-    while (m_DataIt != m_DataItEnd)
+// -------------------------------------------------------------------
+//  File parsing method.
+void ObjFileParser::parseFile(IOStreamBuffer<char> &streamBuffer)
+{
+    // only update every 100KB or it'll be too slow, progress is counted in
+    // KB so files beyond 4GB still fit the progress handler
+    const size_t updateProgressEveryBytes = 100 * 1024;
+    size_t progressCounter = 0;
+    const unsigned int kbToProcess = static_cast<unsigned int>(streamBuffer.size() / 1024 + 1);
+    const unsigned int progressTotal = 3 * kbToProcess;
+    const unsigned int progressOffset = kbToProcess;
+
+    while (streamBuffer.getNextLine(m_Line, '\\'))
     {
+        m_DataIt = m_Line.begin();
+        m_DataItEnd = m_Line.end();
+
         // Handle progress reporting
-        processed += std::distance(lastDataIt, m_DataIt);
-        lastDataIt = m_DataIt;
+        const size_t processed = streamBuffer.getFilePos();
         if (processed > (progressCounter * updateProgressEveryBytes))
         {
             progressCounter++;
-            m_progress->UpdateFileRead(progressOffset + processed*2, progressTotal);
+            m_progress->UpdateFileRead(progressOffset + static_cast<unsigned int>(processed / 1024) * 2, progressTotal);
         }
 
-        // parse line
-        switch (*m_DataIt)
-        {
-        case 'v': // Parse a vertex texture coordinate
-            {
-                ++m_DataIt;
-                if (*m_DataIt == ' ' || *m_DataIt == '\t') {
-                    size_t numComponents = getNumComponentsInLine();
-                    if (numComponents == 3) {
-                        // read in vertex definition
-                        getVector3(m_pModel->m_Vertices);
-                    } else if (numComponents == 6) {
-                        // read vertex and vertex-color
-                        getTwoVectors3(m_pModel->m_Vertices, m_pModel->m_VertexColors);
-                    }
-                } else if (*m_DataIt == 't') {
-                    // read in texture coordinate ( 2D or 3D )
-                                        ++m_DataIt;
-                                        getVector( m_pModel->m_TextureCoord );
-                } else if (*m_DataIt == 'n') {
-                    // Read in normal vector definition
-                    ++m_DataIt;
-                    getVector3( m_pModel->m_Normals );
-                }
-            }
-            break;
+        parseLine();
+    }
+}
 
-        case 'p': // Parse a face, line or point statement
-        case 'l':
-        case 'f':
-            {
-                getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
-                    ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
-            }
-            break;
+#ifndef ASSIMP_BUILD_SINGLETHREADED
 
-        case '#': // Parse a comment
-            {
-                getComment();
+// -------------------------------------------------------------------
+//  Parallel file parsing method. The file is read in batches of lines. The
+//  vertex data and faces of a batch are parsed on worker threads, each
+//  taking a run of lines, and then stored in file order on this thread,
+//  where relative indices are resolved and every other statement is handled
+//  by parseLine as usual.
+void ObjFileParser::parseFileParallel(IOStreamBuffer<char> &streamBuffer, unsigned int numThreads)
+{
+    // progress is reported once per batch, counted in KB as in parseFile
+    const unsigned int kbToProcess = static_cast<unsigned int>(streamBuffer.size() / 1024 + 1);
+    const unsigned int progressTotal = 3 * kbToProcess;
+    const unsigned int progressOffset = kbToProcess;
+
+    DataArray batch;
+    std::vector<size_t> lineStarts;
+    std::vector<ParsedLine> lines;
+    std::vector<ParsedChunk> chunks(numThreads);
+    std::vector<size_t> chunkStarts;
+
+    bool endOfFile = false;
+    while (!endOfFile)
+    {
+        batch.clear();
+        lineStarts.clear();
+        while (batch.size() < ParallelBatchSize) {
+            if (!streamBuffer.getNextLine(m_Line, '\\')) {
+                endOfFile = true;
+                break;
             }
+            lineStarts.push_back(batch.size());
+            batch.insert(batch.end(), m_Line.begin(), m_Line.end());
+        }
+        if (lineStarts.empty()) {
             break;
+        }
 
-        case 'u': // Parse a material desc. setter
-            {
-                getMaterialDesc();
-            }
-            break;
+        const size_t processed = streamBuffer.getFilePos();
+        m_progress->UpdateFileRead(progressOffset + static_cast<unsigned int>(processed / 1024) * 2, progressTotal);
 
-        case 'm': // Parse a material library or merging group ('mg')
-            {
-                if (*(m_DataIt + 1) == 'g')
-                    getGroupNumberAndResolution();
-                else
-                    getMaterialLib();
-            }
-            break;
+        // split the lines evenly, but don't bother threads with a handful
+        const size_t numLines = lineStarts.size();
+        const size_t numChunks = std::max<size_t>(1, std::min<size_t>(numThreads, numLines / MinLinesPerThread));
+        chunkStarts.resize(numChunks + 1);
+        for (size_t c = 0; c <= numChunks; ++c) {
+            chunkStarts[c] = numLines * c / numChunks;
+        }
 
-        case 'g': // Parse group name
-            {
-                getGroupName();
+        lines.resize(numLines);
+        std::vector<std::thread> workers;
+        for (size_t c = 0; c < numChunks; ++c) {
+            chunks[c].vectors.clear();
+            chunks[c].tokens.clear();
+            chunks[c].error = std::exception_ptr();
+            if (c > 0) {
+                workers.push_back(std::thread(parseChunk, &batch, &lineStarts, chunkStarts[c], chunkStarts[c + 1], &lines[0], &chunks[c]));
             }
-            break;
-
-        case 's': // Parse group number
-            {
-                getGroupNumber();
+        }
+        parseChunk(&batch, &lineStarts, chunkStarts[0], chunkStarts[1], &lines[0], &chunks[0]);
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+        for (size_t c = 0; c < numChunks; ++c) {
+            if (chunks[c].error) {
+                std::rethrow_exception(chunks[c].error);
             }
-            break;
+        }
 
-        case 'o': // Parse object name
+        // store everything in file order
+        for (size_t c = 0; c < numChunks; ++c)
+        {
+            const ParsedChunk &chunk = chunks[c];
+            for (size_t l = chunkStarts[c]; l < chunkStarts[c + 1]; ++l)
             {
-                getObjectName();
-            }
-            break;
+                const ParsedLine &parsed = lines[l];
+                m_DataIt = batch.begin() + lineStarts[l];
+                m_DataItEnd = (l + 1 < numLines) ? batch.begin() + lineStarts[l + 1] : batch.end();
 
-        default:
-            {
-                m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+                switch (parsed.kind)
+                {
+                case LineVertex:
+                    m_pModel->m_Vertices.push_back(chunk.vectors[parsed.first[0]]);
+                    ++m_uiLine;
+                    break;
+
+                case LineVertexColor:
+                    m_pModel->m_Vertices.push_back(chunk.vectors[parsed.first[0]]);
+                    m_pModel->m_VertexColors.push_back(chunk.vectors[parsed.first[0] + 1]);
+                    ++m_uiLine;
+                    break;
+
+                case LineTexCoord:
+                    m_pModel->m_TextureCoord.push_back(chunk.vectors[parsed.first[0]]);
+                    ++m_uiLine;
+                    break;
+
+                case LineNormal:
+                    m_pModel->m_Normals.push_back(chunk.vectors[parsed.first[0]]);
+                    ++m_uiLine;
+                    break;
+
+                case LineFace:
+                    {
+                        const int rule = (m_pModel->m_TextureCoord.empty() && !m_pModel->m_Normals.empty()) ? 1 : 0;
+                        storeFace(parsed.type, parsed.count[rule] ? &chunk.tokens[parsed.first[rule]] : NULL,
+                            parsed.count[rule], parsed.numSeparatorErrors[rule]);
+                    }
+                    break;
+
+                default:
+                    parseLine();
+                    break;
+                }
             }
-            break;
         }
     }
 }
 
+#endif // ASSIMP_BUILD_SINGLETHREADED
+
 // -------------------------------------------------------------------
-//  Copy the next word in a temporary buffer
-void ObjFileParser::copyNextWord(char *pBuffer, size_t length)
+//  Parses the statement on the current line.
+void ObjFileParser::parseLine()
 {
-    size_t index = 0;
-    m_DataIt = getNextWord<DataArrayIt>(m_DataIt, m_DataItEnd);
-    while( m_DataIt != m_DataItEnd && !IsSpaceOrNewLine( *m_DataIt ) ) {
-        pBuffer[index] = *m_DataIt;
-        index++;
-        if( index == length - 1 ) {
-            break;
+    switch (*m_DataIt)
+    {
+    case 'v': // Parse a vertex texture coordinate
+        {
+            ++m_DataIt;
+            if (*m_DataIt == ' ' || *m_DataIt == '\t') {
+                size_t numComponents = getNumComponentsInLine();
+                if (numComponents == 3) {
+                    // read in vertex definition
+                    getVector3(m_pModel->m_Vertices);
+                } else if (numComponents == 6) {
+                    // read vertex and vertex-color
+                    getTwoVectors3(m_pModel->m_Vertices, m_pModel->m_VertexColors);
+                }
+            } else if (*m_DataIt == 't') {
+                // read in texture coordinate ( 2D or 3D )
+                                    ++m_DataIt;
+                                    getVector( m_pModel->m_TextureCoord );
+            } else if (*m_DataIt == 'n') {
+                // Read in normal vector definition
+                ++m_DataIt;
+                getVector3( m_pModel->m_Normals );
+            }
         }
-        ++m_DataIt;
+        break;
+
+    case 'p': // Parse a face, line or point statement
+    case 'l':
+    case 'f':
+        {
+            getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
+                ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+        }
+        break;
+
+    case '#': // Parse a comment
+        {
+            getComment();
+        }
+        break;
+
+    case 'u': // Parse a material desc. setter
+        {
+            getMaterialDesc();
+        }
+        break;
+
+    case 'm': // Parse a material library or merging group ('mg')
+        {
+            if (*(m_DataIt + 1) == 'g')
+                getGroupNumberAndResolution();
+            else
+                getMaterialLib();
+        }
+        break;
+
+    case 'g': // Parse group name
+        {
+            getGroupName();
+        }
+        break;
+
+    case 's': // Parse group number
+        {
+            getGroupNumber();
+        }
+        break;
+
+    case 'o': // Parse object name
+        {
+            getObjectName();
+        }
+        break;
+
+    default:
+        {
+            m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+        }
+        break;
     }
+}
 
-    ai_assert(index < length);
-    pBuffer[index] = '\0';
+// -------------------------------------------------------------------
+//  Copy the next word in a temporary buffer
+void ObjFileParser::copyNextWord(char *pBuffer, size_t length)
+{
+    m_DataIt = copyWord<DataArrayIt>(m_DataIt, m_DataItEnd, pBuffer, length);
 }
 
 // -------------------------------------------------------------------
@@ -264,87 +682,40 @@ void ObjFileParser::copyNextLine(char *pBuffer, size_t length)
 }
 
 size_t ObjFileParser::getNumComponentsInLine() {
-    size_t numComponents( 0 );
-    const char* tmp( &m_DataIt[0] );
-    while( !IsLineEnd( *tmp ) ) {
-        if ( !SkipSpaces( &tmp ) ) {
-            break;
-        }
-        SkipToken( tmp );
-        ++numComponents;
-    }
-    return numComponents;
+    return countComponents( &m_DataIt[0] );
 }
 
 // -------------------------------------------------------------------
 void ObjFileParser::getVector( std::vector<aiVector3D> &point3d_array ) {
     size_t numComponents = getNumComponentsInLine();
-    float x, y, z;
-    if( 2 == numComponents ) {
-        copyNextWord( m_buffer, Buffersize );
-        x = ( float ) fast_atof( m_buffer );
-
-        copyNextWord( m_buffer, Buffersize );
-        y = ( float ) fast_atof( m_buffer );
-        z = 0.0;
-    } else if( 3 == numComponents ) {
-        copyNextWord( m_buffer, Buffersize );
-        x = ( float ) fast_atof( m_buffer );
-
-        copyNextWord( m_buffer, Buffersize );
-        y = ( float ) fast_atof( m_buffer );
-
-        copyNextWord( m_buffer, Buffersize );
-        z = ( float ) fast_atof( m_buffer );
+    float v[ 3 ] = { 0, 0, 0 };
+    if( 2 == numComponents || 3 == numComponents ) {
+        readComponents( v, static_cast<unsigned int>( numComponents ) );
     } else {
         throw DeadlyImportError( "OBJ: Invalid number of components" );
     }
-    point3d_array.push_back( aiVector3D( x, y, z ) );
+    point3d_array.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
     m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
 }
 
 // -------------------------------------------------------------------
 //  Get values for a new 3D vector instance
 void ObjFileParser::getVector3( std::vector<aiVector3D> &point3d_array ) {
-    float x, y, z;
-    copyNextWord(m_buffer, Buffersize);
-    x = (float) fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (float) fast_atof(m_buffer);
+    float v[ 3 ];
+    readComponents( v, 3 );
 
-    copyNextWord( m_buffer, Buffersize );
-    z = ( float ) fast_atof( m_buffer );
-
-    point3d_array.push_back( aiVector3D( x, y, z ) );
+    point3d_array.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
     m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
 }
 
 // -------------------------------------------------------------------
 //  Get values for two 3D vectors on the same line
 void ObjFileParser::getTwoVectors3( std::vector<aiVector3D> &point3d_array_a, std::vector<aiVector3D> &point3d_array_b ) {
-    float x, y, z;
-    copyNextWord(m_buffer, Buffersize);
-    x = (float) fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (float) fast_atof(m_buffer);
-
-    copyNextWord( m_buffer, Buffersize );
-    z = ( float ) fast_atof( m_buffer );
-
-    point3d_array_a.push_back( aiVector3D( x, y, z ) );
-
-    copyNextWord(m_buffer, Buffersize);
-    x = (float) fast_atof(m_buffer);
+    float v[ 6 ];
+    readComponents( v, 6 );
 
-    copyNextWord(m_buffer, Buffersize);
-    y = (float) fast_atof(m_buffer);
-
-    copyNextWord( m_buffer, Buffersize );
-    z = ( float ) fast_atof( m_buffer );
-
-    point3d_array_b.push_back( aiVector3D( x, y, z ) );
+    point3d_array_a.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+    point3d_array_b.push_back( aiVector3D( v[ 3 ], v[ 4 ], v[ 5 ] ) );
 
     m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
 }
@@ -352,31 +723,48 @@ void ObjFileParser::getTwoVectors3( std::vector<aiVector3D> &point3d_array_a, st
 // -------------------------------------------------------------------
 //  Get values for a new 2D vector instance
 void ObjFileParser::getVector2( std::vector<aiVector2D> &point2d_array ) {
-    float x, y;
-    copyNextWord(m_buffer, Buffersize);
-    x = (float) fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (float) fast_atof(m_buffer);
+    float v[ 2 ];
+    readComponents( v, 2 );
 
-    point2d_array.push_back(aiVector2D(x, y));
+    point2d_array.push_back( aiVector2D( v[ 0 ], v[ 1 ] ) );
 
     m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
 }
 
+// -------------------------------------------------------------------
+//  Reads the next numComponents numbers of the current line
+void ObjFileParser::readComponents( float *values, unsigned int numComponents ) {
+    const char *pStart = &( *m_DataIt );
+    const char *it = readFloats( pStart, pStart + ( m_DataItEnd - m_DataIt ), values, numComponents );
+    m_DataIt += it - pStart;
+}
+
 static const std::string DefaultObjName = "defaultobject";
 
 // -------------------------------------------------------------------
 //  Get values for a new face instance
 void ObjFileParser::getFace(aiPrimitiveType type) {
     copyNextLine(m_buffer, Buffersize);
-    char *pPtr = m_buffer;
-    char *pEnd = &pPtr[Buffersize];
-    pPtr = getNextToken<char*>(pPtr, pEnd);
-    if ( pPtr == pEnd || *pPtr == '\0' ) {
+
+    // without texture coordinates "1/2" names a normal
+    const bool noTexCoords = m_pModel->m_TextureCoord.empty() && !m_pModel->m_Normals.empty();
+    unsigned int numSeparatorErrors = 0;
+    m_FaceTokens.clear();
+    if ( !parseFaceTokens( m_buffer, &m_buffer[Buffersize], type, noTexCoords, m_FaceTokens, numSeparatorErrors ) ) {
         return;
     }
 
+    storeFace( type, m_FaceTokens.empty() ? NULL : &m_FaceTokens[0], m_FaceTokens.size(), numSeparatorErrors );
+}
+
+// -------------------------------------------------------------------
+//  Resolves the tokens of a face statement against the data read so far and
+//  stores the face in the current mesh.
+void ObjFileParser::storeFace(aiPrimitiveType type, const int *tokens, size_t numTokens, unsigned int numSeparatorErrors) {
+    for ( unsigned int i = 0; i < numSeparatorErrors; ++i ) {
+        DefaultLogger::get()->error("Obj: Separator unexpected in point statement");
+    }
+
     std::vector<unsigned int> *pIndices = new std::vector<unsigned int>;
     std::vector<unsigned int> *pTexID = new std::vector<unsigned int>;
     std::vector<unsigned int> *pNormalID = new std::vector<unsigned int>;
@@ -386,87 +774,53 @@ void ObjFileParser::getFace(aiPrimitiveType type) {
     const int vtSize = m_pModel->m_TextureCoord.size();
     const int vnSize = m_pModel->m_Normals.size();
 
-    const bool vt = (!m_pModel->m_TextureCoord.empty());
-    const bool vn = (!m_pModel->m_Normals.empty());
-    int iStep = 0, iPos = 0;
-    while (pPtr != pEnd) {
-        iStep = 1;
+    for ( size_t i = 0; i + 1 < numTokens; i += 2 ) {
+        const int iPos = tokens[ i ];
+        const int iVal = tokens[ i + 1 ];
 
-        if ( IsLineEnd( *pPtr ) ) {
-            break;
-        }
-
-        if (*pPtr=='/' ) {
-            if (type == aiPrimitiveType_POINT) {
-                DefaultLogger::get()->error("Obj: Separator unexpected in point statement");
+        //OBJ USES 1 Base ARRAYS!!!!
+        if ( iVal > 0 )
+        {
+            // Store parsed index
+            if ( 0 == iPos )
+            {
+                pIndices->push_back( iVal-1 );
             }
-            if (iPos == 0) {
-                //if there are no texture coordinates in the file, but normals
-                if (!vt && vn) {
-                    iPos = 1;
-                    iStep++;
-                }
+            else if ( 1 == iPos )
+            {
+                pTexID->push_back( iVal-1 );
             }
-            iPos++;
-        } else if( IsSpaceOrNewLine( *pPtr ) ) {
-            iPos = 0;
-        } else {
-            //OBJ USES 1 Base ARRAYS!!!!
-            const int iVal( ::atoi( pPtr ) );
-
-            // increment iStep position based off of the sign and # of digits
-            int tmp = iVal;
-            if ( iVal < 0 ) {
-                ++iStep;
+            else if ( 2 == iPos )
+            {
+                pNormalID->push_back( iVal-1 );
+                hasNormal = true;
             }
-            while ( ( tmp = tmp / 10 ) != 0 ) {
-                ++iStep;
+            else
+            {
+                reportErrorTokenInFace();
             }
-
-            if ( iVal > 0 )
+        }
+        else
+        {
+            // Store relatively index
+            if ( 0 == iPos )
             {
-                // Store parsed index
-                if ( 0 == iPos )
-                {
-                    pIndices->push_back( iVal-1 );
-                }
-                else if ( 1 == iPos )
-                {
-                    pTexID->push_back( iVal-1 );
-                }
-                else if ( 2 == iPos )
-                {
-                    pNormalID->push_back( iVal-1 );
-                    hasNormal = true;
-                }
-                else
-                {
-                    reportErrorTokenInFace();
-                }
+                pIndices->push_back( vSize + iVal );
             }
-            else if ( iVal < 0 )
+            else if ( 1 == iPos )
             {
-                // Store relatively index
-                if ( 0 == iPos )
-                {
-                    pIndices->push_back( vSize + iVal );
-                }
-                else if ( 1 == iPos )
-                {
-                    pTexID->push_back( vtSize + iVal );
-                }
-                else if ( 2 == iPos )
-                {
-                    pNormalID->push_back( vnSize + iVal );
-                    hasNormal = true;
-                }
-                else
-                {
-                    reportErrorTokenInFace();
-                }
+                pTexID->push_back( vtSize + iVal );
+            }
+            else if ( 2 == iPos )
+            {
+                pNormalID->push_back( vnSize + iVal );
+                hasNormal = true;
+            }
+            else
+            {
+                reportErrorTokenInFace();
             }
         }
-        pPtr += iStep;
     }
 
     if ( pIndices->empty() ) {
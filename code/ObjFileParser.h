@@ -61,6 +61,9 @@ class ObjFileImporter;
 class IOSystem;
 class ProgressHandler;
 
+template<class T>
+class IOStreamBuffer;
+
 /// \class  ObjFileParser
 /// \brief  Parser for a obj waveform file
 class ObjFileParser {
@@ -71,16 +74,23 @@ public:
     typedef std::vector<char>::const_iterator ConstDataArrayIt;
 
 public:
-    /// \brief  Constructor with data array.
-    ObjFileParser(std::vector<char> &Data, const std::string &strModelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName);
+    /// \brief  Constructor with the stream to parse, which is read line by line.
+    /// More than one thread parses the vertex data and faces in parallel.
+    ObjFileParser(IOStreamBuffer<char> &streamBuffer, const std::string &strModelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName, unsigned int numThreads = 1);
     /// \brief  Destructor
     ~ObjFileParser();
     /// \brief  Model getter.
     ObjFile::Model *GetModel() const;
 
 private:
-    /// Parse the loaded file
-    void parseFile();
+    /// Parse the file from the stream
+    void parseFile(IOStreamBuffer<char> &streamBuffer);
+    /// Parse the file from the stream on several threads
+    void parseFileParallel(IOStreamBuffer<char> &streamBuffer, unsigned int numThreads);
+    /// Pre-sizes the vertex arrays from a quick count of their lines
+    void reserveVertexArrays(IOStreamBuffer<char> &streamBuffer);
+    /// Parse the statement on the current line
+    void parseLine();
     /// Method to copy the new delimited word in the current line.
     void copyNextWord(char *pBuffer, size_t length);
     /// Method to copy the new line.
@@ -93,8 +103,12 @@ private:
     void getTwoVectors3( std::vector<aiVector3D> &point3d_array_a, std::vector<aiVector3D> &point3d_array_b );
     /// Stores the following 3d vector.
     void getVector2(std::vector<aiVector2D> &point2d_array);
+    /// Reads the following numbers on the line.
+    void readComponents( float *values, unsigned int numComponents );
     /// Stores the following face.
     void getFace(aiPrimitiveType type);
+    /// Stores a face from its tokenized indices.
+    void storeFace(aiPrimitiveType type, const int *tokens, size_t numTokens, unsigned int numSeparatorErrors);
     /// Reads the material description.
     void getMaterialDesc();
     /// Gets a comment.
@@ -132,6 +146,8 @@ private:
 
     /// Default material name
     static const std::string DEFAULT_MATERIAL;
+    //! The line being parsed, terminated by a line end and a binary zero
+    DataArray m_Line;
     //! Iterator to current position in buffer
     DataArrayIt m_DataIt;
     //! Iterator to end position of buffer
@@ -142,6 +158,8 @@ private:
     unsigned int m_uiLine;
     //! Helper buffer
     char m_buffer[Buffersize];
+    //! Tokens of the face being read
+    std::vector<int> m_FaceTokens;
     /// Pointer to IO system instance.
     IOSystem *m_pIO;
     //! Pointer to progress handler
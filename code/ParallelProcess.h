@@ -0,0 +1,154 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  ParallelProcess.h
+ *  @brief Helpers to run the per-mesh part of a post processing step (or
+ *    any other set of independent work items) on several threads.
+ */
+#ifndef AI_PARALLEL_PROCESS_H_INCLUDED
+#define AI_PARALLEL_PROCESS_H_INCLUDED
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <atomic>
+#   include <exception>
+#   include <thread>
+#   include <vector>
+#endif
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** Read #AI_CONFIG_PP_THREADS and resolve it to the number of threads a
+ *  step may use. 1 unless the caller asks for more, and always 1 in
+ *  single-threaded builds. */
+inline unsigned int GetPostProcessThreadCount(const Importer* pImp)
+{
+    const int numThreads = pImp->GetPropertyInteger(AI_CONFIG_PP_THREADS, 1);
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    if (numThreads <= 0) {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+    return static_cast<unsigned int>(numThreads);
+#else
+    (void)numThreads;
+    return 1;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Call func(index) once for every index in [0,count), distributed on up to
+ *  numThreads threads, the calling thread included. Indices are handed out
+ *  one at a time so a few expensive items don't leave the other threads idle.
+ *
+ *  func must only touch data private to the index it is given. If a call
+ *  throws, indices not yet started are skipped and the exception is
+ *  rethrown on the calling thread once all threads stopped. Threads that
+ *  fail to start just leave more work to the others. */
+template <typename Func>
+void ParallelFor(unsigned int count, unsigned int numThreads, Func func)
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    numThreads = std::min(numThreads, count);
+    if (numThreads > 1) {
+        std::atomic<unsigned int> next(0);
+        std::atomic<bool> failed(false);
+        std::vector<std::exception_ptr> errors(numThreads);
+
+        auto worker = [&](unsigned int t) {
+            try {
+                for (unsigned int a = next++; a < count && !failed; a = next++) {
+                    func(a);
+                }
+            }
+            catch (...) {
+                errors[t] = std::current_exception();
+                failed = true;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (unsigned int t = 1; t < numThreads; ++t) {
+            // out of threads, the ones running and the calling thread take the rest
+            try {
+                threads.push_back(std::thread(worker, t));
+            }
+            catch (...) {
+                break;
+            }
+        }
+        worker(0);
+        for (size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+        for (unsigned int t = 0; t < numThreads; ++t) {
+            if (errors[t]) {
+                std::rethrow_exception(errors[t]);
+            }
+        }
+        return;
+    }
+#else
+    (void)numThreads;
+#endif
+    for (unsigned int a = 0; a < count; ++a) {
+        func(a);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Call func(index) once for every mesh of the scene, see #ParallelFor.
+ *  func must only touch the mesh it is given and data private to that
+ *  index. */
+template <typename Func>
+void ParallelForEachMesh(const aiScene* pScene, unsigned int numThreads, Func func)
+{
+    ParallelFor(pScene->mNumMeshes, numThreads, func);
+}
+
+} // ! namespace Assimp
+
+#endif // !! AI_PARALLEL_PROCESS_H_INCLUDED
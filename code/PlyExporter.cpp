@@ -60,30 +60,32 @@ namespace Assimp    {
 // Worker function for exporting a scene to PLY. Prototyped and registered in Exporter.cpp
 void ExportScenePly(const char* pFile,IOSystem* pIOSystem, const aiScene* pScene, const ExportProperties* pProperties)
 {
-    // invoke the exporter
-    PlyExporter exporter(pFile, pScene);
-
-    // we're still here - export successfully completed. Write the file.
     std::unique_ptr<IOStream> outfile (pIOSystem->Open(pFile,"wt"));
     if(outfile == NULL) {
         throw DeadlyExportError("could not open output .ply file: " + std::string(pFile));
     }
+    IOStreamWriter out(outfile.get());
 
-    outfile->Write( exporter.mOutput.str().c_str(), static_cast<size_t>(exporter.mOutput.tellp()),1);
+    // invoke the exporter
+    PlyExporter exporter(pFile, pScene, out);
+
+    // we're still here - export successfully completed
+    out.flush();
 }
 
 void ExportScenePlyBinary(const char* pFile, IOSystem* pIOSystem, const aiScene* pScene, const ExportProperties* pProperties)
 {
-    // invoke the exporter
-    PlyExporter exporter(pFile, pScene, true);
-
-    // we're still here - export successfully completed. Write the file.
     std::unique_ptr<IOStream> outfile(pIOSystem->Open(pFile, "wb"));
     if (outfile == NULL) {
         throw DeadlyExportError("could not open output .ply file: " + std::string(pFile));
     }
+    IOStreamWriter out(outfile.get());
+
+    // invoke the exporter
+    PlyExporter exporter(pFile, pScene, out, true);
 
-    outfile->Write(exporter.mOutput.str().c_str(), static_cast<size_t>(exporter.mOutput.tellp()), 1);
+    // we're still here - export successfully completed
+    out.flush();
 }
 
 #define PLY_EXPORT_HAS_NORMALS 0x1
@@ -92,15 +94,11 @@ void ExportScenePlyBinary(const char* pFile, IOSystem* pIOSystem, const aiScene*
 #define PLY_EXPORT_HAS_COLORS (PLY_EXPORT_HAS_TEXCOORDS << AI_MAX_NUMBER_OF_TEXTURECOORDS)
 
 // ------------------------------------------------------------------------------------------------
-PlyExporter::PlyExporter(const char* _filename, const aiScene* pScene, bool binary)
-: filename(_filename)
+PlyExporter::PlyExporter(const char* _filename, const aiScene* pScene, IOStreamWriter& out, bool binary)
+: mOutput(out)
+, filename(_filename)
 , endl("\n")
 {
-    // make sure that all formatting happens using the standard, C locale and not the user's current locale
-    const std::locale& l = std::locale("C");
-    mOutput.imbue(l);
-    mOutput.precision(16);
-
     unsigned int faces = 0u, vertices = 0u, components = 0u;
     for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
         const aiMesh& m = *pScene->mMeshes[i];
@@ -353,7 +351,7 @@ void PlyExporter::WriteMeshIndices(const aiMesh* m, unsigned int offset)
 
 // Generic method in case we want to use different data types for the indices or make this configurable.
 template<typename NumIndicesType, typename IndexType>
-void WriteMeshIndicesBinary_Generic(const aiMesh* m, unsigned int offset, std::ostringstream& output)
+void WriteMeshIndicesBinary_Generic(const aiMesh* m, unsigned int offset, IOStreamWriter& output)
 {
     for (unsigned int i = 0; i < m->mNumFaces; ++i) {
         const aiFace& f = m->mFaces[i];
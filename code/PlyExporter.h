@@ -44,7 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef AI_PLYEXPORTER_H_INC
 #define AI_PLYEXPORTER_H_INC
 
-#include <sstream>
+#include "IOStreamWriter.h"
 
 struct aiScene;
 struct aiNode;
@@ -59,14 +59,14 @@ namespace Assimp
 class PlyExporter
 {
 public:
-    /// The class constructor for a specific scene to export
-    PlyExporter(const char* filename, const aiScene* pScene, bool binary = false);
+    /// The class constructor for a specific scene to export, the file is written to out
+    PlyExporter(const char* filename, const aiScene* pScene, IOStreamWriter& out, bool binary = false);
     /// The class destructor, empty.
     ~PlyExporter();
 
 public:
-    /// public string-streams to write all output into:
-    std::ostringstream mOutput;
+    /// public writer to write all output into:
+    IOStreamWriter& mOutput;
 
 private:
     void WriteMeshVerts(const aiMesh* m, unsigned int components);
@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SpatialSort.h"
 #include "BaseProcess.h"
 #include "ParsingUtils.h"
+#include "ParallelProcess.h"
 
 #include <list>
 
@@ -335,31 +336,59 @@ aiMesh* MakeSubmesh(const aiMesh *superMesh, const std::vector<unsigned int> &su
 // -------------------------------------------------------------------------------
 // Utility postprocess step to share the spatial sort tree between
 // all steps which use it to speedup its computations.
+// The list holds one entry per mesh and is complete before it is shared, so
+// the steps running on several threads only ever read the entry of their own
+// mesh from it.
 class ComputeSpatialSortProcess : public BaseProcess
 {
+public:
+    ComputeSpatialSortProcess()
+    : configNumThreads(1)
+    , configJoinHashed(false)
+    , requestingSteps(0)
+    {}
+
+private:
     bool IsActive( unsigned int pFlags) const
     {
-        return NULL != shared && 0 != (pFlags & (aiProcess_CalcTangentSpace |
-            aiProcess_GenNormals | aiProcess_JoinIdenticalVertices));
+        // remember who asked, JoinIdenticalVertices may not need it after all
+        requestingSteps = pFlags & (aiProcess_CalcTangentSpace |
+            aiProcess_GenNormals | aiProcess_JoinIdenticalVertices);
+        return NULL != shared && 0 != requestingSteps;
+    }
+
+    void SetupProperties(const Importer* pImp)
+    {
+        configNumThreads = GetPostProcessThreadCount(pImp);
+        configJoinHashed = pImp->GetPropertyInteger(AI_CONFIG_PP_JIV_HASHED,0) != 0;
     }
 
     void Execute( aiScene* pScene)
     {
         typedef std::pair<SpatialSort, float> _Type;
+
+        // the hashed JoinIdenticalVertices never looks at the sorted vertices
+        if (configJoinHashed && requestingSteps == aiProcess_JoinIdenticalVertices) {
+            DefaultLogger::get()->debug("Skipping spatially-sorted vertex cache, nothing needs it");
+            return;
+        }
         DefaultLogger::get()->debug("Generate spatially-sorted vertex cache");
 
         std::vector<_Type>* p = new std::vector<_Type>(pScene->mNumMeshes);
-        std::vector<_Type>::iterator it = p->begin();
 
-        for (unsigned int i = 0; i < pScene->mNumMeshes; ++i, ++it) {
+        ParallelForEachMesh(pScene,configNumThreads,[&](unsigned int i) {
             aiMesh* mesh = pScene->mMeshes[i];
-            _Type& blubb = *it;
+            _Type& blubb = (*p)[i];
             blubb.first.Fill(mesh->mVertices,mesh->mNumVertices,sizeof(aiVector3D));
             blubb.second = ComputePositionEpsilon(mesh);
-        }
+        });
 
         shared->AddProperty(AI_SPP_SPATIAL_SORT,p);
     }
+
+    unsigned int configNumThreads;
+    bool configJoinHashed;
+    mutable unsigned int requestingSteps;
 };
 
 // -------------------------------------------------------------------------------
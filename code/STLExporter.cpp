@@ -58,43 +58,42 @@ namespace Assimp    {
 // Worker function for exporting a scene to Stereolithograpy. Prototyped and registered in Exporter.cpp
 void ExportSceneSTL(const char* pFile,IOSystem* pIOSystem, const aiScene* pScene, const ExportProperties* pProperties)
 {
-    // invoke the exporter
-    STLExporter exporter(pFile, pScene);
-
-    // we're still here - export successfully completed. Write the file.
     std::unique_ptr<IOStream> outfile (pIOSystem->Open(pFile,"wt"));
     if(outfile == NULL) {
         throw DeadlyExportError("could not open output .stl file: " + std::string(pFile));
     }
+    IOStreamWriter out(outfile.get());
+
+    // invoke the exporter
+    STLExporter exporter(pFile, pScene, out);
 
-    outfile->Write( exporter.mOutput.str().c_str(), static_cast<size_t>(exporter.mOutput.tellp()),1);
+    // we're still here - export successfully completed
+    out.flush();
 }
 void ExportSceneSTLBinary(const char* pFile,IOSystem* pIOSystem, const aiScene* pScene, const ExportProperties* pProperties)
 {
-    // invoke the exporter
-    STLExporter exporter(pFile, pScene, true);
-
-    // we're still here - export successfully completed. Write the file.
     std::unique_ptr<IOStream> outfile (pIOSystem->Open(pFile,"wb"));
     if(outfile == NULL) {
         throw DeadlyExportError("could not open output .stl file: " + std::string(pFile));
     }
+    IOStreamWriter out(outfile.get());
+
+    // invoke the exporter
+    STLExporter exporter(pFile, pScene, out, true);
 
-    outfile->Write( exporter.mOutput.str().c_str(), static_cast<size_t>(exporter.mOutput.tellp()),1);
+    // we're still here - export successfully completed
+    out.flush();
 }
 
 } // end of namespace Assimp
 
 
 // ------------------------------------------------------------------------------------------------
-STLExporter :: STLExporter(const char* _filename, const aiScene* pScene, bool binary)
-: filename(_filename)
+STLExporter :: STLExporter(const char* _filename, const aiScene* pScene, IOStreamWriter& out, bool binary)
+: mOutput(out)
+, filename(_filename)
 , endl("\n")
 {
-    // make sure that all formatting happens using the standard, C locale and not the user's current locale
-    const std::locale& l = std::locale("C");
-    mOutput.imbue(l);
-    mOutput.precision(16);
     if (binary) {
         char buf[80] = {0} ;
         buf[0] = 'A'; buf[1] = 's'; buf[2] = 's'; buf[3] = 'i'; buf[4] = 'm'; buf[5] = 'p';
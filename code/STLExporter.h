@@ -44,7 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef AI_STLEXPORTER_H_INC
 #define AI_STLEXPORTER_H_INC
 
-#include <sstream>
+#include "IOStreamWriter.h"
 
 struct aiScene;
 struct aiNode;
@@ -59,13 +59,13 @@ namespace Assimp
 class STLExporter
 {
 public:
-    /// Constructor for a specific scene to export
-    STLExporter(const char* filename, const aiScene* pScene, bool binary = false);
+    /// Constructor for a specific scene to export, the file is written to out
+    STLExporter(const char* filename, const aiScene* pScene, IOStreamWriter& out, bool binary = false);
 
 public:
 
-    /// public stringstreams to write all output into
-    std::ostringstream mOutput;
+    /// public writer to write all output into
+    IOStreamWriter& mOutput;
 
 private:
 
@@ -1032,6 +1032,95 @@ void SceneCombiner::CopyScene(aiScene** _dest,const aiScene* src,bool allocate)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::CopySceneParts(aiScene** _dest,const aiScene* src,unsigned int parts)
+{
+    ai_assert(NULL != _dest && NULL != src);
+
+    aiScene* dest = *_dest = new aiScene();
+
+    // start with a flat copy, then replace the parts that are copied
+    dest->mNumAnimations = src->mNumAnimations;
+    dest->mNumTextures = src->mNumTextures;
+    dest->mNumMaterials = src->mNumMaterials;
+    dest->mNumLights = src->mNumLights;
+    dest->mNumCameras = src->mNumCameras;
+    dest->mNumMeshes = src->mNumMeshes;
+
+    if (parts & AI_INT_SCENE_PART_ANIMATIONS) {
+        CopyPtrArray(dest->mAnimations,src->mAnimations,dest->mNumAnimations);
+    }
+    else dest->mAnimations = src->mAnimations;
+
+    if (parts & AI_INT_SCENE_PART_TEXTURES) {
+        CopyPtrArray(dest->mTextures,src->mTextures,dest->mNumTextures);
+    }
+    else dest->mTextures = src->mTextures;
+
+    if (parts & AI_INT_SCENE_PART_MATERIALS) {
+        CopyPtrArray(dest->mMaterials,src->mMaterials,dest->mNumMaterials);
+    }
+    else dest->mMaterials = src->mMaterials;
+
+    if (parts & AI_INT_SCENE_PART_LIGHTS_CAMERAS) {
+        CopyPtrArray(dest->mLights,src->mLights,dest->mNumLights);
+        CopyPtrArray(dest->mCameras,src->mCameras,dest->mNumCameras);
+    }
+    else {
+        dest->mLights = src->mLights;
+        dest->mCameras = src->mCameras;
+    }
+
+    if (parts & AI_INT_SCENE_PART_MESHES) {
+        CopyPtrArray(dest->mMeshes,src->mMeshes,dest->mNumMeshes);
+    }
+    else dest->mMeshes = src->mMeshes;
+
+    if (parts & AI_INT_SCENE_PART_NODES) {
+        Copy( &dest->mRootNode, src->mRootNode);
+    }
+    else dest->mRootNode = src->mRootNode;
+
+    dest->mFlags = src->mFlags;
+    ScenePriv(dest)->mPPStepsApplied = ScenePriv(src) ? ScenePriv(src)->mPPStepsApplied : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::FreeSceneParts(aiScene* scene,unsigned int parts)
+{
+    if (!scene) {
+        return;
+    }
+
+    // detach everything that belongs to the source scene
+    if (!(parts & AI_INT_SCENE_PART_ANIMATIONS)) {
+        scene->mAnimations = NULL;
+        scene->mNumAnimations = 0;
+    }
+    if (!(parts & AI_INT_SCENE_PART_TEXTURES)) {
+        scene->mTextures = NULL;
+        scene->mNumTextures = 0;
+    }
+    if (!(parts & AI_INT_SCENE_PART_MATERIALS)) {
+        scene->mMaterials = NULL;
+        scene->mNumMaterials = 0;
+    }
+    if (!(parts & AI_INT_SCENE_PART_LIGHTS_CAMERAS)) {
+        scene->mLights = NULL;
+        scene->mNumLights = 0;
+        scene->mCameras = NULL;
+        scene->mNumCameras = 0;
+    }
+    if (!(parts & AI_INT_SCENE_PART_MESHES)) {
+        scene->mMeshes = NULL;
+        scene->mNumMeshes = 0;
+    }
+    if (!(parts & AI_INT_SCENE_PART_NODES)) {
+        scene->mRootNode = NULL;
+    }
+    delete scene;
+}
+
 // ------------------------------------------------------------------------------------------------
 void SceneCombiner::Copy     (aiMesh** _dest, const aiMesh* src)
 {
@@ -142,6 +142,43 @@ struct NodeAttachmentInfo
  */
 #define AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES_IF_NECESSARY 0x10
 
+// ---------------------------------------------------------------------------
+/** @def AI_INT_SCENE_PART_MESHES
+ *  Parts of a scene for SceneCombiner::CopySceneParts(). Meshes,
+ *  including their bones.
+ */
+#define AI_INT_SCENE_PART_MESHES        0x1
+
+/** @def AI_INT_SCENE_PART_NODES
+ *  The node hierarchy.
+ */
+#define AI_INT_SCENE_PART_NODES         0x2
+
+/** @def AI_INT_SCENE_PART_MATERIALS
+ *  Materials.
+ */
+#define AI_INT_SCENE_PART_MATERIALS     0x4
+
+/** @def AI_INT_SCENE_PART_ANIMATIONS
+ *  Animations.
+ */
+#define AI_INT_SCENE_PART_ANIMATIONS    0x8
+
+/** @def AI_INT_SCENE_PART_TEXTURES
+ *  Embedded textures.
+ */
+#define AI_INT_SCENE_PART_TEXTURES      0x10
+
+/** @def AI_INT_SCENE_PART_LIGHTS_CAMERAS
+ *  Lights and cameras.
+ */
+#define AI_INT_SCENE_PART_LIGHTS_CAMERAS 0x20
+
+/** @def AI_INT_SCENE_PART_ALL
+ *  Everything, the same as a full CopyScene().
+ */
+#define AI_INT_SCENE_PART_ALL           0x3f
+
 
 typedef std::pair<aiBone*,unsigned int> BoneSrcIndex;
 
@@ -353,6 +390,30 @@ public:
     static void CopySceneFlat(aiScene** dest,const aiScene* source);
 
 
+    // -------------------------------------------------------------------
+    /** Get a copy of a scene that only deep-copies some of its parts
+     *
+     *  Meant for scenes which are about to be modified in known places,
+     *  e.g. by post processing steps. The parts that are not copied are
+     *  shared by source and destination scene, as with CopySceneFlat().
+     *  Use FreeSceneParts() to delete the copy again.
+     *  @param dest Receives a pointer to the destination scene
+     *  @param src Source scene - remains unmodified.
+     *  @param parts Combination of the AI_INT_SCENE_PART flags defined above
+     */
+    static void CopySceneParts(aiScene** dest,const aiScene* source,unsigned int parts);
+
+
+    // -------------------------------------------------------------------
+    /** Delete a scene obtained from CopySceneParts(), leaving the parts
+     *  it shares with its source alone.
+     *
+     *  @param scene Scene to be deleted
+     *  @param parts The parts that were passed to CopySceneParts()
+     */
+    static void FreeSceneParts(aiScene* scene,unsigned int parts);
+
+
     // -------------------------------------------------------------------
     /** Get a deep copy of a mesh
      *
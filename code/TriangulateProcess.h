@@ -73,6 +73,13 @@ public:
     */
     bool IsActive( unsigned int pFlags) const;
 
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
     // -------------------------------------------------------------------
     /** Executes the post processing step on the given imported data.
     * At the moment a process is not supposed to fail.
@@ -86,6 +93,10 @@ public:
      * @param pMesh The mesh to triangulate.
      */
     bool TriangulateMesh( aiMesh* pMesh);
+
+private:
+    /** Number of threads the meshes are distributed on */
+    unsigned int configNumThreads;
 };
 
 } // end of namespace Assimp
@@ -294,13 +294,15 @@ void XFileExporter::WriteFrameTransform(aiMatrix4x4& m)
 // Recursively writes the given node
 void XFileExporter::WriteNode( aiNode* pNode)
 {
-    if (pNode->mName.length==0)
+    // make up a name for unnamed nodes without touching the scene, which may be the caller's
+    aiString nodeName = pNode->mName;
+    if (nodeName.length==0)
     {
         std::stringstream ss;
         ss << "Node_" << pNode;
-        pNode->mName.Set(ss.str());
+        nodeName.Set(ss.str());
     }
-    mOutput << startstr << "Frame " << toXFileString(pNode->mName) << " {" << endstr;
+    mOutput << startstr << "Frame " << toXFileString(nodeName) << " {" << endstr;
 
     PushTag();
 
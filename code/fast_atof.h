@@ -19,6 +19,7 @@
 #include <limits>
 #include <stdint.h>
 #include <stdexcept>
+#include <string.h>
 
 #include "StringComparison.h"
 
@@ -399,6 +400,156 @@ inline double fast_atod( const char** inout)
     return ret;
 }
 
+// ------------------------------------------------------------------------------------
+// Batched parsing of whitespace-separated real numbers.
+// The scalar functions above take one digit per step, which adds up for the 16 and
+// more digits exporters tend to write. The batched parser checks eight bytes at once
+// and converts eight digits with three multiplications (SWAR, SIMD within a 64 bit
+// register), shorter runs still go digit by digit. Exponents, nan, inf and overlong
+// numbers are left to the scalar functions. The very same integers go through the very
+// same floating-point operations, so the results are bit-exact with fast_atoreal_move.
+// Integers are not batched: indices are mostly a few digits long, and strtoul10 is
+// faster on those than the setup of a batch.
+// ------------------------------------------------------------------------------------
+
+// True for the characters separating the numbers of a batch
+inline bool IsNumberSeparator(char in)
+{
+    return in == ' ' || in == '\t' || in == '\r' || in == '\n' || in == '\f';
+}
+
+// True for the characters a number of a batch may end with
+inline bool IsNumberTerminator(char in)
+{
+    return in == '\0' || IsNumberSeparator(in);
+}
+
+// ------------------------------------------------------------------------------------
+// Read up to max decimal digits at in, eight at a time while they last and there is
+// room for them before end. Returns the number of digits read, in is moved behind them.
+// ------------------------------------------------------------------------------------
+inline unsigned int ReadDigits(const char*& in, const char* end, unsigned int max, uint64_t& value)
+{
+    unsigned int num = 0;
+    value = 0;
+
+#ifndef AI_BUILD_BIG_ENDIAN
+    // the first character is the lowest byte of chunk
+    for (; max - num >= 8 && end - in >= 8; num += 8, in += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, in, 8);
+
+        // all eight bytes within '0'..'9'?
+        if (((chunk & 0xf0f0f0f0f0f0f0f0ULL) |
+            (((chunk + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) >> 4)) != 0x3333333333333333ULL) {
+            break;
+        }
+
+        // combine neighbouring digits to pairs, pairs to groups of 4 and those to 8
+        chunk -= 0x3030303030303030ULL;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32))) +
+            (((chunk >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32)))) >> 32;
+        value = value * 100000000ULL + static_cast<uint32_t>(chunk);
+    }
+#endif
+
+    for (; num < max && *in >= '0' && *in <= '9'; ++num, ++in) {
+        value = value * 10 + (*in - '0');
+    }
+    return num;
+}
+
+// ------------------------------------------------------------------------------------
+// Parse a number the way fast_atoreal_move does if it has at most 15 digits before and
+// no exponent after the decimal point. Returns NULL if it needs fast_atoreal_move.
+// ------------------------------------------------------------------------------------
+template <typename Real>
+inline const char* fast_atoreal_move_batch(const char* c, const char* end, Real& out, bool check_comma)
+{
+    const char* in = (c[0] == '-' || c[0] == '+') ? c + 1 : c;
+
+    uint64_t value;
+    const unsigned int numInt = ReadDigits(in, end, 15, value);
+    if (*in >= '0' && *in <= '9') {
+        return NULL;
+    }
+
+    // the values stay below 2^53, converting them as signed is the same and cheaper
+    Real f = static_cast<Real>(static_cast<int64_t>(value));
+
+    if ((*in == '.' || (check_comma && *in == ',')) && in[1] >= '0' && in[1] <= '9') {
+        ++in;
+        const unsigned int diff = ReadDigits(in, end, AI_FAST_ATOF_RELAVANT_DECIMALS, value);
+        while (*in >= '0' && *in <= '9') {
+            ++in;
+        }
+
+        double pl = static_cast<double>(static_cast<int64_t>(value));
+        pl *= fast_atof_table[diff];
+        f += static_cast<Real>(pl);
+    }
+    else if (!numInt) {
+        return NULL;
+    }
+    // eat trailing dots, but not trailing commas
+    else if (*in == '.') {
+        ++in;
+    }
+
+    if (*in == 'e' || *in == 'E') {
+        return NULL;
+    }
+
+    if (c[0] == '-') {
+        f = -f;
+    }
+    out = f;
+    return in;
+}
+
+// ------------------------------------------------------------------------------------
+// Parse up to max_inout whitespace-separated real numbers in [c, end) into out. Stops
+// early at the end of the range or at anything that is no number terminated by
+// whitespace, a binary zero or end; max_inout receives the number of values parsed and
+// the return value points behind the last of them. Like fast_atoreal_move this expects
+// [c, end) to be followed by a terminator and throws on malformed numbers.
+// ------------------------------------------------------------------------------------
+template <typename Real>
+inline const char* fast_atoreal_array(const char* c, const char* end, Real* out, unsigned int& max_inout,
+    bool check_comma = true)
+{
+    unsigned int cur = 0;
+    for (const char* in = c; cur < max_inout; ++cur) {
+        while (in != end && IsNumberSeparator(*in)) {
+            ++in;
+        }
+        if (in == end) {
+            break;
+        }
+
+        const char ch = (*in == '-' || *in == '+') ? in[1] : in[0];
+        if (!(ch >= '0' && ch <= '9') && ch != '.' && !(check_comma && ch == ',') &&
+            ch != 'n' && ch != 'N' && ch != 'i' && ch != 'I') {
+            break;
+        }
+
+        Real f;
+        const char* next = fast_atoreal_move_batch<Real>(in, end, f, check_comma);
+        if (!next) {
+            next = fast_atoreal_move<Real>(in, f, check_comma);
+        }
+        if (next != end && !IsNumberTerminator(*next)) {
+            break;
+        }
+
+        out[cur] = f;
+        c = in = next;
+    }
+    max_inout = cur;
+    return c;
+}
+
 } // end of namespace Assimp
 
 #endif
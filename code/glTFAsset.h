@@ -208,6 +208,7 @@ namespace glTF
         ComponentType_UNSIGNED_BYTE = 5121,
         ComponentType_SHORT = 5122,
         ComponentType_UNSIGNED_SHORT = 5123,
+        ComponentType_UNSIGNED_INT = 5125,
         ComponentType_FLOAT = 5126
     };
 
@@ -218,6 +219,7 @@ namespace glTF
             case ComponentType_UNSIGNED_SHORT:
                 return 2;
 
+            case ComponentType_UNSIGNED_INT:
             case ComponentType_FLOAT:
                 return 4;
 
@@ -468,6 +470,7 @@ namespace glTF
 
     private:
         shared_ptr<uint8_t> mData; //!< Pointer to the data
+        size_t mCapacity; //!< Number of bytes allocated for mData by Grow() and Reserve()
         bool mIsSpecial; //!< Set to true for special cases (e.g. the body buffer)
 
     public:
@@ -480,6 +483,9 @@ namespace glTF
         size_t AppendData(uint8_t* data, size_t length);
         void Grow(size_t amount);
 
+        //! Preallocates storage so the buffer can grow to the given size without reallocating
+        void Reserve(size_t capacity);
+
         uint8_t* GetPointer()
             { return mData.get(); }
 
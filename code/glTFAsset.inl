@@ -241,7 +241,7 @@ Ref<T> LazyDict<T>::Create(const char* id)
 
 
 inline Buffer::Buffer()
-: byteLength(0), type(Type_arraybuffer), mIsSpecial(false)
+: byteLength(0), type(Type_arraybuffer), mCapacity(0), mIsSpecial(false)
 { }
 
 inline const char* Buffer::TranslateId(Asset& r, const char* id)
@@ -317,6 +317,7 @@ inline bool Buffer::LoadFromStream(IOStream& stream, size_t length, size_t baseO
     }
 
     mData.reset(new uint8_t[byteLength]);
+    mCapacity = byteLength;
 
     if (stream.Read(mData.get(), byteLength, 1) != 1) {
         return false;
@@ -335,10 +336,20 @@ inline size_t Buffer::AppendData(uint8_t* data, size_t length)
 inline void Buffer::Grow(size_t amount)
 {
     if (amount <= 0) return;
-    uint8_t* b = new uint8_t[byteLength + amount];
+    if (byteLength + amount > mCapacity) {
+        // grow geometrically, appending many small chunks must not copy the whole buffer each time
+        Reserve(std::max(byteLength + amount, mCapacity * 2));
+    }
+    byteLength += amount;
+}
+
+inline void Buffer::Reserve(size_t capacity)
+{
+    if (capacity <= mCapacity || capacity <= byteLength) return;
+    uint8_t* b = new uint8_t[capacity];
     if (mData) memcpy(b, mData.get(), byteLength);
     mData.reset(b);
-    byteLength += amount;
+    mCapacity = capacity;
 }
 
 
@@ -399,17 +410,18 @@ inline uint8_t* Accessor::GetPointer()
 namespace {
     inline void CopyData(size_t count,
             const uint8_t* src, size_t src_stride,
-                  uint8_t* dst, size_t dst_stride)
+                  uint8_t* dst, size_t dst_size, size_t dst_stride)
     {
-        if (src_stride == dst_stride) {
+        if (src_stride == dst_size && dst_size == dst_stride) {
             memcpy(dst, src, count * src_stride);
         }
         else {
-            size_t sz = std::min(src_stride, dst_stride);
+            // dst_stride > dst_size for interleaved views, leave the other attributes alone
+            size_t sz = std::min(src_stride, dst_size);
             for (size_t i = 0; i < count; ++i) {
                 memcpy(dst, src, sz);
-                if (sz < dst_stride) {
-                    memset(dst + sz, 0, dst_stride - sz);
+                if (sz < dst_size) {
+                    memset(dst + sz, 0, dst_size - sz);
                 }
                 src += src_stride;
                 dst += dst_stride;
@@ -452,13 +464,14 @@ inline void Accessor::WriteData(size_t count, const void* src_buffer, size_t src
     uint8_t* buffer_ptr = bufferView->buffer->GetPointer();
     size_t offset = byteOffset + bufferView->byteOffset;
 
-    size_t dst_stride = GetNumComponents() * GetBytesPerComponent();
+    size_t dst_size = GetNumComponents() * GetBytesPerComponent();
+    size_t dst_stride = byteStride ? byteStride : dst_size;
 
     const uint8_t* src = reinterpret_cast<const uint8_t*>(src_buffer);
     uint8_t*       dst = reinterpret_cast<      uint8_t*>(buffer_ptr + offset);
 
-    ai_assert(dst + count*dst_stride <= buffer_ptr + bufferView->buffer->byteLength);
-    CopyData(count, src, src_stride, dst, dst_stride);
+    ai_assert(!count || dst + (count - 1)*dst_stride + dst_size <= buffer_ptr + bufferView->buffer->byteLength);
+    CopyData(count, src, src_stride, dst, dst_size, dst_stride);
 }
 
 
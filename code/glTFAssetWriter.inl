@@ -359,7 +359,14 @@ namespace glTF {
         }
 
         if (isBinary) {
-            WriteBinaryData(outfile.get(), docBuffer.GetSize());
+            // pad the scene with spaces, the body has to start at a 4-byte boundary
+            size_t sceneLength = docBuffer.GetSize();
+            size_t padding = (4 - (sizeof(GLB_Header) + sceneLength) % 4) % 4;
+            if (padding && outfile->Write("   ", 1, padding) != padding) {
+                throw DeadlyExportError("Failed to write scene data!");
+            }
+
+            WriteBinaryData(outfile.get(), sceneLength + padding);
         }
     }
 
@@ -369,14 +376,14 @@ namespace glTF {
         // write the body data
         //
 
+        size_t bodyOffset = sizeof(GLB_Header) + sceneLength;
+        bodyOffset = (bodyOffset + 3) & ~3; // Round up to next multiple of 4
+
         size_t bodyLength = 0;
         if (Ref<Buffer> b = mAsset.GetBodyBuffer()) {
             bodyLength = b->byteLength;
 
             if (bodyLength > 0) {
-                size_t bodyOffset = sizeof(GLB_Header) + sceneLength;
-                bodyOffset = (bodyOffset + 3) & ~3; // Round up to next multiple of 4
-
                 outfile->Seek(bodyOffset, aiOrigin_SET);
 
                 if (outfile->Write(b->GetPointer(), b->byteLength, 1) != 1) {
@@ -396,7 +403,7 @@ namespace glTF {
         header.version = 1;
         AI_SWAP4(header.version);
 
-        header.length = uint32_t(sizeof(header) + sceneLength + bodyLength);
+        header.length = uint32_t(bodyOffset + bodyLength);
         AI_SWAP4(header.length);
 
         header.sceneLength = uint32_t(sceneLength);
@@ -430,7 +437,7 @@ namespace glTF {
         Value exts;
         exts.SetArray();
         {
-            if (false)
+            if (mAsset.extensionsUsed.KHR_binary_glTF)
                 exts.PushBack(StringRef("KHR_binary_glTF"), mAl);
 
             if (false)
@@ -54,6 +54,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/Exporter.hpp>
 #include <assimp/material.h>
 #include <assimp/scene.h>
+#include <assimp/config.h>
 
 #include <memory>
 
@@ -136,34 +137,54 @@ static void CopyValue(const aiMatrix4x4& v, glTF::mat4& o)
     o[12] = v.a4; o[13] = v.b4; o[14] = v.c4; o[15] = v.d4;
 }
 
-inline Ref<Accessor> ExportData(Asset& a, std::string& meshName, Ref<Buffer>& buffer,
-    unsigned int count, void* data, AttribType::Value typeIn, AttribType::Value typeOut, ComponentType compType, bool isIndices = false)
+// Appends a view of the given length to the buffer. Views start at a 4-byte boundary,
+// so the accessors into them are aligned to their component size.
+inline Ref<BufferView> ExportBufferView(Asset& a, std::string& meshName, Ref<Buffer>& buffer, size_t length, bool isIndices)
 {
-    if (!count || !data) return Ref<Accessor>();
-
-    unsigned int numCompsIn = AttribType::GetNumComponents(typeIn);
-    unsigned int numCompsOut = AttribType::GetNumComponents(typeOut);
-    unsigned int bytesPerComp = ComponentTypeSize(compType);
+    size_t padding = (4 - buffer->byteLength % 4) % 4;
+    if (padding) {
+        buffer->Grow(padding);
+        memset(buffer->GetPointer() + buffer->byteLength - padding, 0, padding);
+    }
 
     size_t offset = buffer->byteLength;
-    size_t length = count * numCompsOut * bytesPerComp;
     buffer->Grow(length);
 
-    // bufferView
     Ref<BufferView> bv = a.bufferViews.Create(a.FindUniqueID(meshName, "view"));
     bv->buffer = buffer;
     bv->byteOffset = unsigned(offset);
     bv->byteLength = length; //! The target that the WebGL buffer should be bound to.
     bv->target = isIndices ? BufferViewTarget_ELEMENT_ARRAY_BUFFER : BufferViewTarget_ARRAY_BUFFER;
 
-    // accessor
+    return bv;
+}
+
+inline Ref<Accessor> ExportAccessor(Asset& a, std::string& meshName, Ref<BufferView>& bv, unsigned int byteOffset,
+    unsigned int byteStride, unsigned int count, AttribType::Value type, ComponentType compType)
+{
     Ref<Accessor> acc = a.accessors.Create(a.FindUniqueID(meshName, "accessor"));
     acc->bufferView = bv;
-    acc->byteOffset = 0;
-    acc->byteStride = 0;
+    acc->byteOffset = byteOffset;
+    acc->byteStride = byteStride;
     acc->componentType = compType;
     acc->count = count;
-    acc->type = typeOut;
+    acc->type = type;
+
+    return acc;
+}
+
+inline Ref<Accessor> ExportData(Asset& a, std::string& meshName, Ref<Buffer>& buffer,
+    unsigned int count, void* data, AttribType::Value typeIn, AttribType::Value typeOut, ComponentType compType, bool isIndices = false)
+{
+    if (!count || !data) return Ref<Accessor>();
+
+    unsigned int numCompsIn = AttribType::GetNumComponents(typeIn);
+    unsigned int numCompsOut = AttribType::GetNumComponents(typeOut);
+    unsigned int bytesPerComp = ComponentTypeSize(compType);
+
+    size_t length = count * numCompsOut * bytesPerComp;
+    Ref<BufferView> bv = ExportBufferView(a, meshName, buffer, length, isIndices);
+    Ref<Accessor> acc = ExportAccessor(a, meshName, bv, 0, 0, count, typeOut, compType);
 
     // copy the data
     acc->WriteData(count, data, numCompsIn*bytesPerComp);
@@ -171,6 +192,84 @@ inline Ref<Accessor> ExportData(Asset& a, std::string& meshName, Ref<Buffer>& bu
     return acc;
 }
 
+// Writes positions, normals and texture coordinates of the mesh into a single view,
+// one vertex after the other, and returns one strided accessor per attribute.
+static void ExportInterleavedData(Asset& a, std::string& meshName, Ref<Buffer>& buffer, const aiMesh* aim, Mesh::Primitive& p)
+{
+    if (!aim->mNumVertices || !aim->mVertices) return;
+
+    unsigned int stride = sizeof(aiVector3D);
+    if (aim->mNormals) {
+        stride += sizeof(aiVector3D);
+    }
+    for (int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (aim->mNumUVComponents[i] > 0 && aim->mTextureCoords[i]) {
+            stride += (aim->mNumUVComponents[i] == 2 ? 2 : 3) * sizeof(float);
+        }
+    }
+
+    Ref<BufferView> bv = ExportBufferView(a, meshName, buffer, size_t(aim->mNumVertices) * stride, false);
+
+    unsigned int offset = 0;
+    Ref<Accessor> v = ExportAccessor(a, meshName, bv, offset, stride, aim->mNumVertices, AttribType::VEC3, ComponentType_FLOAT);
+    v->WriteData(aim->mNumVertices, aim->mVertices, sizeof(aiVector3D));
+    p.attributes.position.push_back(v);
+    offset += sizeof(aiVector3D);
+
+    if (aim->mNormals) {
+        Ref<Accessor> n = ExportAccessor(a, meshName, bv, offset, stride, aim->mNumVertices, AttribType::VEC3, ComponentType_FLOAT);
+        n->WriteData(aim->mNumVertices, aim->mNormals, sizeof(aiVector3D));
+        p.attributes.normal.push_back(n);
+        offset += sizeof(aiVector3D);
+    }
+
+    for (int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (aim->mNumUVComponents[i] > 0 && aim->mTextureCoords[i]) {
+            AttribType::Value type = (aim->mNumUVComponents[i] == 2) ? AttribType::VEC2 : AttribType::VEC3;
+            Ref<Accessor> tc = ExportAccessor(a, meshName, bv, offset, stride, aim->mNumVertices, type, ComponentType_FLOAT);
+            tc->WriteData(aim->mNumVertices, aim->mTextureCoords[i], sizeof(aiVector3D));
+            p.attributes.texcoord.push_back(tc);
+            offset += AttribType::GetNumComponents(type) * sizeof(float);
+        }
+    }
+}
+
+template<typename T>
+static void WriteIndices(const aiMesh* aim, unsigned int nIndicesPerFace, uint8_t* dst)
+{
+    T* indices = reinterpret_cast<T*>(dst);
+    for (size_t i = 0; i < aim->mNumFaces; ++i) {
+        for (size_t j = 0; j < nIndicesPerFace; ++j) {
+            indices[i*nIndicesPerFace + j] = T(aim->mFaces[i].mIndices[j]);
+        }
+    }
+}
+
+// Upper bound of the number of bytes ExportMeshes() appends to the buffer for the given mesh
+static size_t GetMeshDataSize(const aiMesh* aim)
+{
+    size_t vertexSize = sizeof(aiVector3D);
+    size_t numViews = 2;
+    if (aim->mNormals) {
+        vertexSize += sizeof(aiVector3D);
+        ++numViews;
+    }
+    for (int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (aim->mNumUVComponents[i] > 0 && aim->mTextureCoords[i]) {
+            vertexSize += (aim->mNumUVComponents[i] == 2 ? 2 : 3) * sizeof(float);
+            ++numViews;
+        }
+    }
+
+    size_t indexSize = 0;
+    if (aim->mNumFaces > 0) {
+        indexSize = size_t(aim->mNumFaces) * aim->mFaces[0].mNumIndices * (aim->mNumVertices <= 0xffff ? 2 : 4);
+    }
+
+    // each view may be preceded by up to 3 bytes of alignment padding
+    return size_t(aim->mNumVertices) * vertexSize + indexSize + numViews * 3;
+}
+
 namespace {
     void GetMatScalar(const aiMaterial* mat, float& val, const char* propName, int type, int idx) {
         if (mat->Get(propName, type, idx, val) == AI_SUCCESS) {}
@@ -252,6 +351,17 @@ void glTFExporter::ExportMaterials()
 
 void glTFExporter::ExportMeshes()
 {
+    const bool interleaved = mProperties->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_INTERLEAVED);
+
+    // all meshes share the binary body, size it once instead of growing it per accessor
+    if (Ref<Buffer> body = mAsset->GetBodyBuffer()) {
+        size_t bodyLength = body->byteLength;
+        for (unsigned int i = 0; i < mScene->mNumMeshes; ++i) {
+            bodyLength += GetMeshDataSize(mScene->mMeshes[i]);
+        }
+        body->Reserve(bodyLength);
+    }
+
     for (unsigned int i = 0; i < mScene->mNumMeshes; ++i) {
         const aiMesh* aim = mScene->mMeshes[i];
 
@@ -267,32 +377,45 @@ void glTFExporter::ExportMeshes()
         Ref<Buffer> b = mAsset->GetBodyBuffer();
         if (!b) {
             b = mAsset->buffers.Create(bufferId);
+            b->Reserve(GetMeshDataSize(aim));
         }
 
-        Ref<Accessor> v = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mVertices, AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
-        if (v) p.attributes.position.push_back(v);
-
-        Ref<Accessor> n = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mNormals, AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
-        if (n) p.attributes.normal.push_back(n);
-
-        for (int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
-            if (aim->mNumUVComponents[i] > 0) {
-                AttribType::Value type = (aim->mNumUVComponents[i] == 2) ? AttribType::VEC2 : AttribType::VEC3;
-                Ref<Accessor> tc = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mTextureCoords[i], AttribType::VEC3, type, ComponentType_FLOAT, true);
-                if (tc) p.attributes.texcoord.push_back(tc);
+        if (interleaved) {
+            ExportInterleavedData(*mAsset, meshId, b, aim, p);
+        }
+        else {
+            Ref<Accessor> v = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mVertices, AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
+            if (v) p.attributes.position.push_back(v);
+
+            Ref<Accessor> n = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mNormals, AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
+            if (n) p.attributes.normal.push_back(n);
+
+            for (int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+                if (aim->mNumUVComponents[i] > 0) {
+                    AttribType::Value type = (aim->mNumUVComponents[i] == 2) ? AttribType::VEC2 : AttribType::VEC3;
+                    Ref<Accessor> tc = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mTextureCoords[i], AttribType::VEC3, type, ComponentType_FLOAT);
+                    if (tc) p.attributes.texcoord.push_back(tc);
+                }
             }
         }
 
         if (aim->mNumFaces > 0) {
             unsigned int nIndicesPerFace = aim->mFaces[0].mNumIndices;
-            std::vector<uint16_t> indices;
-            indices.resize(aim->mNumFaces * nIndicesPerFace);
-            for (size_t i = 0; i < aim->mNumFaces; ++i) {
-                for (size_t j = 0; j < nIndicesPerFace; ++j) {
-                    indices[i*nIndicesPerFace + j] = uint16_t(aim->mFaces[i].mIndices[j]);
-                }
+            unsigned int count = aim->mNumFaces * nIndicesPerFace;
+
+            // 16 bit indices whenever the mesh is small enough, 32 bit otherwise
+            ComponentType compType = aim->mNumVertices <= 0xffff ? ComponentType_UNSIGNED_SHORT : ComponentType_UNSIGNED_INT;
+
+            // the faces are written straight into the view, without an intermediate index array
+            Ref<BufferView> bv = ExportBufferView(*mAsset, meshId, b, size_t(count) * ComponentTypeSize(compType), true);
+            p.indices = ExportAccessor(*mAsset, meshId, bv, 0, 0, count, AttribType::SCALAR, compType);
+
+            if (compType == ComponentType_UNSIGNED_SHORT) {
+                WriteIndices<uint16_t>(aim, nIndicesPerFace, p.indices->GetPointer());
+            }
+            else {
+                WriteIndices<uint32_t>(aim, nIndicesPerFace, p.indices->GetPointer());
             }
-            p.indices = ExportData(*mAsset, meshId, b, unsigned(indices.size()), &indices[0], AttribType::SCALAR, AttribType::SCALAR, ComponentType_UNSIGNED_SHORT, true);
         }
 
         switch (aim->mPrimitiveTypes) {
@@ -355,6 +355,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_CONFIG_PP_DB_ALL_OR_NONE \
     "PP_DB_ALL_OR_NONE"
 
+// ---------------------------------------------------------------------------
+/** @brief Configures the #aiProcess_JoinIdenticalVertices step to find
+ *    identical vertices with a hash table instead of a SpatialSort.
+ *
+ * Vertices are hashed by their exact position and by the grid cells their
+ * other attributes fall into, with a cell size of the comparison epsilon
+ * (1e-5), so finding a duplicate usually costs a single table lookup.
+ * Bit-identical vertices are always joined. Positions must match exactly
+ * and attributes which differ by less than the epsilon are not joined if
+ * they fall into neighbouring cells, so the output may keep slightly more
+ * vertices than the default search, but never less.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_PP_JIV_HASHED \
+    "PP_JIV_HASHED"
+
 /** @brief Default value for the #AI_CONFIG_PP_ICL_PTCACHE_SIZE property
  */
 #ifndef PP_ICL_PTCACHE_SIZE
@@ -511,6 +527,22 @@ enum aiComponent
 #define AI_CONFIG_PP_TUV_EVALUATE               \
     "PP_TUV_EVALUATE"
 
+// ---------------------------------------------------------------------------
+/** @brief Sets the number of threads the per-mesh post processing steps
+ *    distribute the meshes of a scene on.
+ *
+ * This affects #aiProcess_JoinIdenticalVertices, #aiProcess_Triangulate,
+ * #aiProcess_GenNormals, #aiProcess_GenSmoothNormals,
+ * #aiProcess_CalcTangentSpace and #aiProcess_ImproveCacheLocality.
+ * 0 uses one thread per hardware core, 1 runs every step on the calling
+ * thread only. Scenes with a single mesh stay on the calling thread either
+ * way. Log messages may arrive from worker threads, so custom loggers
+ * need to be thread-safe if this is not 1.
+ * Property type: integer. Default value: 1.
+ */
+#define AI_CONFIG_PP_THREADS                    \
+    "PP_THREADS"
+
 // ---------------------------------------------------------------------------
 /** @brief A hint to assimp to favour speed against import quality.
  *
@@ -622,6 +654,40 @@ enum aiComponent
 #define AI_CONFIG_IMPORT_FBX_OPTIMIZE_EMPTY_ANIMATION_CURVES \
     "IMPORT_FBX_OPTIMIZE_EMPTY_ANIMATION_CURVES"
 
+// ---------------------------------------------------------------------------
+/** @brief Sets the number of threads the FBX loader inflates the compressed
+ *    data arrays of binary files on.
+ *
+ * If this is not 1, all compressed arrays of a binary FBX file are
+ * decompressed up front and kept until the import finishes, which needs
+ * more memory than decompressing each array when it is read. 0 uses one
+ * thread per hardware core, 1 decompresses every array on the calling
+ * thread when it is needed. ASCII files and imports restricted by
+ * #AI_CONFIG_IMPORT_FBX_NODES are not affected.
+ * Property type: integer. Default value: 1.
+ */
+#define AI_CONFIG_IMPORT_FBX_THREADS \
+    "IMPORT_FBX_THREADS"
+
+// ---------------------------------------------------------------------------
+/** @brief Restricts the FBX import to the nodes matching a name in a given
+ *    list and everything below them.
+ *
+ * This is a list of 1 to n strings, ' ' serves as delimiter character.
+ * Identifiers containing whitespaces must be enclosed in *single*
+ * quotation marks. For example:<tt>
+ * "Chair Table \'Floor Lamp\'"</tt>.
+ * Only the meshes, materials, lights, cameras and animations of the
+ * selected subtrees are read and converted, all other objects in the file
+ * are never parsed. The parents of a selected node are kept as empty
+ * nodes to preserve its transformation.
+ * Property type: String. Default value: n/a (import everything)
+ * @note Node names are case sensitive and given without the "Model::"
+ *   prefix.
+ */
+#define AI_CONFIG_IMPORT_FBX_NODES \
+    "IMPORT_FBX_NODES"
+
 
 
 // ---------------------------------------------------------------------------
@@ -896,6 +962,16 @@ enum aiComponent
  */
 #define AI_CONFIG_IMPORT_COLLADA_INVERT_TRANSPARENCY "IMPORT_COLLADA_INVERT_TRANSPARENCY"
 
+// ---------------------------------------------------------------------------
+/** @brief Sets the number of threads the OBJ loader parses vertex data and
+ *    faces on.
+ *
+ * 0 uses one thread per hardware core, 1 parses the file on the calling
+ * thread only. Small files stay on the calling thread either way.
+ * Property type: integer. Default value: 1.
+ */
+#define AI_CONFIG_IMPORT_OBJ_THREADS "IMPORT_OBJ_THREADS"
+
 // ---------- All the Export defines ------------
 
 /** @brief Specifies the xfile use double for real values of float
@@ -905,4 +981,14 @@ enum aiComponent
 
 #define AI_CONFIG_EXPORT_XFILE_64BIT "EXPORT_XFILE_64BIT"
 
+/** @brief Specifies whether the glTF/GLB exporter interleaves the vertex
+ *    attributes of a mesh in one buffer view instead of one view each.
+ *
+ * Index buffers are never interleaved. Each mesh stores its indices as
+ * unsigned short if it has at most 65535 vertices, as unsigned int otherwise.
+ * Property type: Bool. Default value: false.
+ */
+
+#define AI_CONFIG_EXPORT_GLTF_INTERLEAVED "EXPORT_GLTF_INTERLEAVED"
+
 #endif // !! AI_CONFIG_H_INC
@@ -0,0 +1,193 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2016, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  tools/assimp_atof_bench/Main.cpp
+ *  @brief Times fast_atoreal_array against parsing the same numbers one at
+ *    a time with fast_atoreal_move, and checks both agree bit for bit.
+ *
+ *  Usage: assimp_atof_bench <file.obj> [iterations]
+ *
+ *  The components of the v, vt and vn lines are gathered into one text
+ *  first, so both parsers only ever see numbers and whitespace.
+ */
+
+#include "fast_atof.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Assimp;
+
+// ------------------------------------------------------------------------------------------------
+// Collects the numbers of all v/vt/vn lines, one line of them per source line
+static bool ReadVertexText(const char* file, std::string& out)
+{
+    FILE* f = ::fopen(file, "rb");
+    if (!f) {
+        return false;
+    }
+
+    std::string data;
+    char buffer[64 * 1024];
+    for (size_t read; (read = ::fread(buffer, 1, sizeof(buffer), f)) > 0; ) {
+        data.append(buffer, read);
+    }
+    ::fclose(f);
+
+    out.clear();
+    for (size_t pos = 0; pos < data.size(); ) {
+        size_t end = data.find('\n', pos);
+        if (end == std::string::npos) {
+            end = data.size();
+        }
+
+        const char* line = data.c_str() + pos;
+        const size_t len = end - pos;
+        if (len > 2 && line[0] == 'v' && (line[1] == ' ' || line[1] == '\t' ||
+            ((line[1] == 't' || line[1] == 'n') && (line[2] == ' ' || line[2] == '\t')))) {
+            out.append(line + 2, len - 2);
+            out += '\n';
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename Real>
+static void ParseScalar(const char* text, const char* end, std::vector<Real>& values)
+{
+    values.clear();
+    for (;;) {
+        while (text != end && IsNumberSeparator(*text)) {
+            ++text;
+        }
+        if (text == end) {
+            break;
+        }
+
+        Real value;
+        text = fast_atoreal_move<Real>(text, value);
+        values.push_back(value);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename Real>
+static unsigned int ParseBatch(const char* text, const char* end, std::vector<Real>& values)
+{
+    unsigned int count = static_cast<unsigned int>(values.size());
+    fast_atoreal_array<Real>(text, end, values.empty() ? NULL : &values[0], count);
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns false if the two parsers disagree
+template <typename Real>
+static bool Run(const char* name, const std::string& text, int iterations)
+{
+    const char* begin = text.c_str();
+    const char* end = begin + text.size();
+
+    // every number takes at least two characters with its separator
+    std::vector<Real> scalar, batch(text.size() / 2 + 1);
+    scalar.reserve(batch.size());
+    unsigned int batchCount = 0;
+    double seconds[2];
+
+    for (int b = 0; b < 2; ++b) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            if (b) {
+                batchCount = ParseBatch(begin, end, batch);
+            }
+            else {
+                ParseScalar(begin, end, scalar);
+            }
+        }
+        seconds[b] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const size_t count = scalar.size();
+    if (batchCount != count || (count && ::memcmp(&scalar[0], &batch[0], count * sizeof(Real)))) {
+        ::printf("%-6s the batched values differ from the scalar ones\n", name);
+        return false;
+    }
+
+    const double bytes = static_cast<double>(text.size()) * iterations;
+    for (int b = 0; b < 2; ++b) {
+        ::printf("%-6s %-6s %u numbers, %.1f MB/s, %.2f ns per number\n", name, b ? "batch" : "scalar",
+            static_cast<unsigned int>(count),
+            seconds[b] > 0.0 ? bytes / seconds[b] / (1024.0 * 1024.0) : 0.0,
+            count ? 1e9 * seconds[b] / (static_cast<double>(count) * iterations) : 0.0);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3) {
+        ::printf("usage: assimp_atof_bench <file.obj> [iterations]\n");
+        return 1;
+    }
+    const int iterations = argc == 3 ? std::max(1, ::atoi(argv[2])) : 20;
+
+    std::string text;
+    if (!ReadVertexText(argv[1], text)) {
+        ::printf("unable to read %s\n", argv[1]);
+        return 1;
+    }
+
+    try {
+        const bool same = Run<float>("float", text, iterations) && Run<double>("double", text, iterations);
+        return same ? 0 : 2;
+    }
+    catch (const std::exception& e) {
+        ::printf("%s: %s\n", argv[1], e.what());
+        return 1;
+    }
+}